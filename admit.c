@@ -0,0 +1,268 @@
+/**
+ * @file admit.c
+ * @brief Implementation of admission control
+ */
+
+#include "admit.h"
+#include "online.h"
+
+#include <math.h>
+
+/**
+ * @brief Parses a shedding policy name
+ * @param name "newest" or "shortest-first"
+ * @param policy Where to store the policy
+ * @return true if the name is known, false otherwise
+ */
+bool parse_shed_policy(const char* name, ShedPolicy* policy) {
+    if (strcmp(name, "newest") == 0) {
+        *policy = SHED_NEWEST;
+    } else if (strcmp(name, "shortest-first") == 0) {
+        *policy = SHED_SHORTEST_FIRST;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Comparison function for sorting integers
+ * @param a First integer
+ * @param b Second integer
+ * @return Negative if a is smaller
+ */
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Token bucket refilled at a constant rate
+ */
+typedef struct {
+    double rate;   /**< Tokens added per time unit, or 0 for no limit */
+    double burst;  /**< Capacity */
+    double tokens; /**< Tokens available at time last */
+    double last;   /**< Time of the last refill */
+} TokenBucket;
+
+/**
+ * @brief Returns the earliest time at which the bucket holds a token
+ * @param bucket Bucket to query
+ * @param time Time from which to look
+ * @return A time no earlier than time or the last refill
+ */
+static int next_token_time(const TokenBucket* bucket, int time) {
+    if (bucket->rate <= 0) {
+        return time;
+    }
+    if (time < bucket->last) {
+        time = (int)bucket->last;
+    }
+    double tokens = bucket->tokens + (time - bucket->last) * bucket->rate;
+    if (tokens >= 1.0) {
+        return time;
+    }
+    double at = bucket->last + (1.0 - bucket->tokens) / bucket->rate;
+    return (int)ceil(at - 1e-9);
+}
+
+/**
+ * @brief Refills the bucket up to a time and takes one token from it
+ * @param bucket Bucket to draw from
+ * @param time Current time
+ */
+static void take_token(TokenBucket* bucket, int time) {
+    if (bucket->rate <= 0) {
+        return;
+    }
+    bucket->tokens += (time - bucket->last) * bucket->rate;
+    if (bucket->tokens > bucket->burst) {
+        bucket->tokens = bucket->burst;
+    }
+    bucket->last = time;
+    bucket->tokens -= 1.0;
+}
+
+/**
+ * @brief Admits one process into the engine, subject to the queue limit
+ * @param engine Engine at the admission time
+ * @param options Admission limits
+ * @param burst_time Burst of the process
+ * @param owner Process index of each engine handle
+ * @param index Index of the process
+ * @param report Counters to update
+ * @return false if the engine failed to accept the process
+ */
+static bool admit_process(OnlineEngine* engine, const AdmissionOptions* options, int burst_time, int* owner,
+                          int index, AdmissionReport* report) {
+    if (options->max_queue > 0 && engine->running >= 0 && online_queue_length(engine) >= options->max_queue) {
+        int longest = online_longest_queued(engine);
+        if (options->shed != SHED_SHORTEST_FIRST || longest < 0 ||
+            engine->jobs[longest].remaining_time <= burst_time) {
+            report->rejected++;
+            return true;
+        }
+        online_cancel(engine, longest);
+        report->shed++;
+    }
+
+    int handle = online_submit(engine, burst_time);
+    if (handle < 0) {
+        return false;
+    }
+    owner[handle] = index;
+    return true;
+}
+
+/**
+ * @brief Runs processes through the online engine behind admission limits
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (reordered and updated in place)
+ * @param n Number of processes
+ * @param options Admission limits
+ * @param report Where to store the outcome
+ * @return Number of completed processes, or -1 on failure
+ */
+int admission_run(const SchedParams* params, Process* processes, int n, const AdmissionOptions* options,
+                  AdmissionReport* report) {
+    memset(report, 0, sizeof(*report));
+    report->arrived = n;
+    OnlineEngine engine;
+    if (n <= 0 || !online_init(&engine, params)) {
+        return -1;
+    }
+
+    int* owner = (int*)malloc(n * sizeof(int));
+    int* turnaround = (int*)malloc(n * sizeof(int));
+    if (!owner || !turnaround) {
+        perror("Memory allocation failed");
+        free(owner);
+        free(turnaround);
+        online_free(&engine);
+        return -1;
+    }
+    qsort(processes, n, sizeof(Process), compare_arrival_time);
+
+    TokenBucket bucket = {options->token_rate, options->token_burst > 0 ? options->token_burst : 1, 0, 0};
+    bucket.tokens = bucket.burst;
+    bucket.last = processes[0].arrival_time;
+
+    // Arrivals waiting for a token are processes[deferred_head .. next_arrival)
+    int next_arrival = 0;
+    int deferred_head = 0;
+    bool ok = true;
+    while (ok && deferred_head < n) {
+        int release = INT32_MAX;
+        if (deferred_head < next_arrival) {
+            release = next_token_time(&bucket, processes[deferred_head].arrival_time);
+        }
+
+        if (next_arrival < n && processes[next_arrival].arrival_time < release) {
+            // A new arrival queues behind any deferred ones
+            int time = processes[next_arrival].arrival_time;
+            next_arrival++;
+            if (deferred_head == next_arrival - 1 && next_token_time(&bucket, time) == time) {
+                online_advance(&engine, time);
+                take_token(&bucket, time);
+                ok = admit_process(&engine, options, processes[deferred_head].burst_time, owner, deferred_head,
+                                   report);
+                deferred_head++;
+            } else {
+                report->deferred++;
+            }
+            continue;
+        }
+
+        online_advance(&engine, release);
+        take_token(&bucket, release);
+        report->total_deferral += release - processes[deferred_head].arrival_time;
+        ok = admit_process(&engine, options, processes[deferred_head].burst_time, owner, deferred_head, report);
+        deferred_head++;
+    }
+    online_advance(&engine, INT32_MAX);
+
+    if (ok) {
+        for (int i = 0; i < n; i++) {
+            processes[i].completion_time = -1;
+        }
+        for (int h = 0; h < engine.count; h++) {
+            const OnlineJob* job = &engine.jobs[h];
+            if (job->completion_time < 0) {
+                continue;
+            }
+            Process* p = &processes[owner[h]];
+            p->remaining_time = 0;
+            p->completion_time = job->completion_time;
+            p->response_time = job->start_time - p->arrival_time;
+            p->started = true;
+        }
+
+        // Completed processes first, still in arrival order
+        int first_arrival = processes[0].arrival_time;
+        int completed = 0;
+        for (int i = 0; i < n; i++) {
+            if (processes[i].completion_time >= 0) {
+                Process p = processes[i];
+                processes[i] = processes[completed];
+                processes[completed] = p;
+                completed++;
+            }
+        }
+
+        report->completed = completed;
+        if (completed > 0) {
+            report->metrics = calculate_metrics(processes, completed);
+        }
+        for (int i = 0; i < completed; i++) {
+            report->goodput_work += processes[i].burst_time;
+            turnaround[i] = processes[i].turnaround_time;
+            if (processes[i].completion_time - first_arrival > report->makespan) {
+                report->makespan = processes[i].completion_time - first_arrival;
+            }
+        }
+        if (completed > 0) {
+            qsort(turnaround, completed, sizeof(int), compare_int);
+            report->p50_turnaround = turnaround[(completed - 1) / 2];
+            report->p99_turnaround = turnaround[(int)((99 * (int64_t)completed + 99) / 100) - 1];
+        }
+    }
+
+    free(owner);
+    free(turnaround);
+    online_free(&engine);
+    return ok ? report->completed : -1;
+}
+
+/**
+ * @brief Prints the admission counts, goodput and tail latency of a run
+ * @param report Outcome of admission_run
+ * @param options Limits passed to admission_run
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_admission_report(const AdmissionReport* report, const AdmissionOptions* options,
+                            const char* algorithm_name) {
+    print_metrics(report->metrics, algorithm_name);
+
+    printf("Admission control:");
+    if (options->max_queue > 0) {
+        printf(" queue limit %d (%s)", options->max_queue,
+               options->shed == SHED_SHORTEST_FIRST ? "shortest-first" : "newest dropped");
+    }
+    if (options->token_rate > 0) {
+        printf(" token bucket %.3g per time unit, burst %d", options->token_rate,
+               options->token_burst > 0 ? options->token_burst : 1);
+    }
+    printf("\n");
+
+    printf("Arrived: %d, completed: %d, rejected: %d, shed from queue: %d\n", report->arrived, report->completed,
+           report->rejected, report->shed);
+    printf("Deferred: %d, average deferral %.2f\n", report->deferred,
+           report->deferred > 0 ? (double)report->total_deferral / report->deferred : 0.0);
+    printf("Goodput: %.4f processes per time unit, %.1f%% of the makespan on completed work\n",
+           report->makespan > 0 ? (double)report->completed / report->makespan : 0.0,
+           report->makespan > 0 ? 100.0 * report->goodput_work / report->makespan : 0.0);
+    printf("Turnaround p50: %d, p99: %d\n", report->p50_turnaround, report->p99_turnaround);
+    printf("----------------------------------------------------------------------------------\n");
+}
@@ -0,0 +1,88 @@
+/**
+ * @file admit.h
+ * @brief Admission control in front of the online engine
+ */
+
+#ifndef ADMIT_H
+#define ADMIT_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @enum ShedPolicy
+ * @brief What happens to an arrival that finds the ready queue full
+ */
+typedef enum {
+    SHED_NEWEST,        /**< Reject the arrival (tail drop) */
+    SHED_SHORTEST_FIRST /**< Keep the shortest work: drop the longest of the queue and the arrival */
+} ShedPolicy;
+
+/**
+ * @struct AdmissionOptions
+ * @brief Limits applied to arriving processes
+ */
+typedef struct {
+    int max_queue;     /**< Largest number of processes waiting for the CPU (0 = unlimited) */
+    ShedPolicy shed;   /**< Process dropped when the queue is full */
+    double token_rate; /**< Admissions per time unit allowed by the token bucket (0 = unlimited) */
+    int token_burst;   /**< Capacity of the token bucket (at least 1) */
+} AdmissionOptions;
+
+/**
+ * @struct AdmissionReport
+ * @brief Outcome of a run with admission control
+ */
+typedef struct {
+    int arrived;            /**< Processes in the input */
+    int completed;          /**< Processes that ran to completion */
+    int rejected;           /**< Arrivals turned away because the queue was full */
+    int shed;               /**< Queued processes dropped in favour of a shorter arrival */
+    int deferred;           /**< Arrivals held back for a token */
+    int64_t total_deferral; /**< Time the deferred processes waited for their token */
+    int64_t goodput_work;   /**< CPU time of the completed processes */
+    int makespan;           /**< Time from the first arrival to the last completion */
+    int p50_turnaround;     /**< Median turnaround time of completed processes */
+    int p99_turnaround;     /**< 99th percentile turnaround time of completed processes */
+    Metrics metrics;        /**< Metrics of the completed processes */
+} AdmissionReport;
+
+/**
+ * @brief Parses a shedding policy name
+ * @param name "newest" or "shortest-first"
+ * @param policy Where to store the policy
+ * @return true if the name is known, false otherwise
+ */
+bool parse_shed_policy(const char* name, ShedPolicy* policy);
+
+/**
+ * @brief Runs processes through the online engine behind admission limits
+ *
+ * Arrivals first pass a token bucket. An arrival that finds no token, or
+ * finds earlier arrivals still waiting for one, is deferred in FIFO order
+ * until a token accrues; its turnaround still counts from its original
+ * arrival. An admitted process that finds max_queue processes waiting is
+ * rejected, or with SHED_SHORTEST_FIRST displaces the queued process with
+ * the most remaining time if its own burst is shorter. Completed processes
+ * are moved to the front of the array.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (reordered and updated in place)
+ * @param n Number of processes
+ * @param options Admission limits
+ * @param report Where to store the outcome
+ * @return Number of completed processes, or -1 on failure
+ */
+int admission_run(const SchedParams* params, Process* processes, int n, const AdmissionOptions* options,
+                  AdmissionReport* report);
+
+/**
+ * @brief Prints the admission counts, goodput and tail latency of a run
+ * @param report Outcome of admission_run
+ * @param options Limits passed to admission_run
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_admission_report(const AdmissionReport* report, const AdmissionOptions* options,
+                            const char* algorithm_name);
+
+#endif /* ADMIT_H */
@@ -0,0 +1,288 @@
+/**
+ * @file closed.c
+ * @brief Implementation of the closed-loop workload driver
+ */
+
+#include "closed.h"
+#include "heap.h"
+#include "online.h"
+
+#include <math.h>
+
+/**
+ * @brief Parses a think-time distribution
+ * @param spec "const:<t>", "exp:<mean>", "uniform:<low>:<high>", or a bare mean (exponential)
+ * @param think Where to store the distribution
+ * @return true if the specification is valid, false otherwise
+ */
+bool parse_think_time(const char* spec, ThinkTime* think) {
+    char extra;
+    think->high = 0;
+    if (sscanf(spec, "const:%lf%c", &think->low, &extra) == 1) {
+        think->kind = THINK_CONSTANT;
+    } else if (sscanf(spec, "exp:%lf%c", &think->low, &extra) == 1 ||
+               sscanf(spec, "%lf%c", &think->low, &extra) == 1) {
+        think->kind = THINK_EXPONENTIAL;
+    } else if (sscanf(spec, "uniform:%lf:%lf%c", &think->low, &think->high, &extra) == 2) {
+        think->kind = THINK_UNIFORM;
+        if (think->high < think->low) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    return think->low >= 0 && think->low < INT32_MAX / 2 && think->high < INT32_MAX / 2;
+}
+
+/**
+ * @brief Returns the mean of a think-time distribution
+ * @param think Distribution
+ * @return Expected think time
+ */
+static double think_mean(const ThinkTime* think) {
+    return think->kind == THINK_UNIFORM ? (think->low + think->high) / 2 : think->low;
+}
+
+/**
+ * @brief Returns the next value of a splitmix64 generator
+ * @param state Generator state
+ * @return Pseudo-random 64-bit value
+ */
+static uint64_t next_random(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Draws a think time
+ * @param think Distribution
+ * @param state Generator state
+ * @return Think time rounded to whole time units
+ */
+static int sample_think(const ThinkTime* think, uint64_t* state) {
+    double u = (next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+    double value;
+    switch (think->kind) {
+        case THINK_EXPONENTIAL:
+            value = -think->low * log1p(-u);
+            break;
+        case THINK_UNIFORM:
+            value = think->low + u * (think->high - think->low);
+            break;
+        default:
+            value = think->low;
+            break;
+    }
+    // Exponential tails are capped so that times stay within int
+    if (value > INT32_MAX / 4) {
+        value = INT32_MAX / 4;
+    }
+    return (int)lround(value);
+}
+
+/**
+ * @brief Comparison function for sorting integers
+ * @param a First integer
+ * @param b Second integer
+ * @return Negative if a is smaller
+ */
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs the closed loop with a fixed number of clients
+ * @param params Algorithm and parameters
+ * @param processes Array of processes supplying the burst times
+ * @param n Number of processes, which is also the number of jobs
+ * @param clients Number of clients
+ * @param options Think times and seed
+ * @param owner Scratch array of n entries
+ * @param response Scratch array of n entries
+ * @param point Where to store the outcome
+ * @return 0 on success, -1 on failure
+ */
+static int run_clients(const SchedParams* params, const Process* processes, int n, int clients,
+                       const ClosedOptions* options, int* owner, int* response, ClosedPoint* point) {
+    OnlineEngine engine;
+    Heap wakeups;
+    if (!online_init(&engine, params)) {
+        return -1;
+    }
+    if (!heap_init(&wakeups, clients)) {
+        online_free(&engine);
+        return -1;
+    }
+
+    // Each client thinks before its first submission, so the clients start staggered
+    uint64_t state = options->seed;
+    int64_t think_total = 0;
+    int thinks = 0;
+    bool ok = true;
+    for (int c = 0; c < clients && c < n && ok; c++) {
+        int think = sample_think(&options->think, &state);
+        think_total += think;
+        thinks++;
+        ok = heap_push(&wakeups, ((int64_t)think << 32) | c);
+    }
+
+    // A wakeup and a slice end at the same time: the submission comes first, as in the batch simulators
+    int submitted = 0;
+    int completed = 0;
+    int64_t busy = 0;
+    while (ok && completed < n) {
+        int wake = wakeups.size > 0 ? (int)(heap_top(&wakeups) >> 32) : INT32_MAX;
+        int end = engine.running >= 0 ? engine.slice_end : INT32_MAX;
+        if (wake == INT32_MAX && end == INT32_MAX) {
+            ok = false;
+            break;
+        }
+
+        if (wake <= end) {
+            int client = (int)(heap_pop(&wakeups) & 0xFFFFFFFF);
+            online_advance(&engine, wake);
+            int handle = online_submit(&engine, processes[submitted].burst_time);
+            if (handle < 0) {
+                ok = false;
+                break;
+            }
+            owner[handle] = client;
+            submitted++;
+            continue;
+        }
+
+        online_advance(&engine, end);
+        int handle = online_complete_due(&engine);
+        if (handle < 0) {
+            continue;
+        }
+        const OnlineJob* job = &engine.jobs[handle];
+        response[completed++] = job->completion_time - job->arrival_time;
+        busy += job->burst_time;
+        if (submitted + wakeups.size < n) {
+            int think = sample_think(&options->think, &state);
+            think_total += think;
+            thinks++;
+            ok = heap_push(&wakeups, ((int64_t)(end + think) << 32) | owner[handle]);
+        }
+    }
+
+    if (ok) {
+        int64_t response_total = 0;
+        for (int i = 0; i < completed; i++) {
+            response_total += response[i];
+        }
+        qsort(response, completed, sizeof(int), compare_int);
+
+        point->clients = clients;
+        point->completed = completed;
+        point->makespan = engine.now;
+        point->throughput = engine.now > 0 ? (double)completed / engine.now : 0.0;
+        point->mean_response = (double)response_total / completed;
+        point->p99_response = response[(int)((99 * (int64_t)completed + 99) / 100) - 1];
+        point->utilisation = engine.now > 0 ? (double)busy / engine.now : 0.0;
+        point->mean_think = (double)think_total / thinks;
+    }
+
+    heap_free(&wakeups);
+    online_free(&engine);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Runs a closed-loop workload for a doubling series of client counts
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes supplying the burst times (not modified)
+ * @param n Number of processes
+ * @param options Client counts and think times
+ * @param result Where to store the curve; release with free_closed_result
+ * @return 0 on success, -1 on failure
+ */
+int closed_loop_curve(const SchedParams* params, const Process* processes, int n, const ClosedOptions* options,
+                      ClosedResult* result) {
+    memset(result, 0, sizeof(*result));
+    if (n <= 0 || options->max_clients <= 0) {
+        return -1;
+    }
+
+    // 1, 2, 4, ... and the maximum itself
+    int counts = 1;
+    while ((1 << (counts - 1)) < options->max_clients && counts < 31) {
+        counts++;
+    }
+
+    int* owner = (int*)malloc(n * sizeof(int));
+    int* response = (int*)malloc(n * sizeof(int));
+    result->points = (ClosedPoint*)calloc(counts, sizeof(ClosedPoint));
+    if (!owner || !response || !result->points) {
+        perror("Memory allocation failed");
+        free(owner);
+        free(response);
+        free_closed_result(result);
+        return -1;
+    }
+
+    int64_t burst_total = 0;
+    for (int i = 0; i < n; i++) {
+        burst_total += processes[i].burst_time;
+    }
+    result->mean_burst = (double)burst_total / n;
+
+    int status = 0;
+    for (int i = 0; i < counts && status == 0; i++) {
+        int clients = i == counts - 1 ? options->max_clients : 1 << i;
+        status = run_clients(params, processes, n, clients, options, owner, response, &result->points[i]);
+        result->count = i + 1;
+    }
+
+    free(owner);
+    free(response);
+    if (status != 0) {
+        free_closed_result(result);
+    }
+    return status;
+}
+
+/**
+ * @brief Prints the throughput and response-time curve with the operational-law bounds
+ * @param result Result of closed_loop_curve
+ * @param options Options passed to closed_loop_curve
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_closed_result(const ClosedResult* result, const ClosedOptions* options, const char* algorithm_name) {
+    double demand = result->mean_burst;
+    double think = think_mean(&options->think);
+
+    printf("\nClosed-loop %s (mean service demand %.2f, mean think time %.2f):\n", algorithm_name, demand, think);
+    printf("%-8s %-11s %-11s %-9s %-7s %-11s %-11s\n", "Clients", "Throughput", "Mean Resp", "p99 Resp", "Util",
+           "Max Thru", "N/X - Z");
+    printf("----------------------------------------------------------------------------------\n");
+    for (int i = 0; i < result->count; i++) {
+        const ClosedPoint* p = &result->points[i];
+
+        // Asymptotic bound: X <= min(N / (D + Z), 1 / D)
+        double bound = p->clients / (demand + think);
+        if (bound > 1.0 / demand) {
+            bound = 1.0 / demand;
+        }
+        // Interactive response time law, with the think times actually drawn
+        double law = p->throughput > 0 ? p->clients / p->throughput - p->mean_think : 0.0;
+        printf("%-8d %-11.4f %-11.2f %-9d %-7.3f %-11.4f %-11.2f\n", p->clients, p->throughput, p->mean_response,
+               p->p99_response, p->utilisation, bound, law);
+    }
+    printf("----------------------------------------------------------------------------------\n");
+    printf("Saturation expected near N* = (D + Z) / D = %.1f clients\n", (demand + think) / demand);
+}
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_closed_result(ClosedResult* result) {
+    free(result->points);
+    memset(result, 0, sizeof(*result));
+}
@@ -0,0 +1,107 @@
+/**
+ * @file closed.h
+ * @brief Closed-loop workload driver: clients that submit again after each completion
+ */
+
+#ifndef CLOSED_H
+#define CLOSED_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @enum ThinkKind
+ * @brief Distribution of client think times
+ */
+typedef enum {
+    THINK_CONSTANT,    /**< Always the mean */
+    THINK_EXPONENTIAL, /**< Exponential with the given mean */
+    THINK_UNIFORM      /**< Uniform between two bounds */
+} ThinkKind;
+
+/**
+ * @struct ThinkTime
+ * @brief Think-time distribution, sampled and rounded to whole time units
+ */
+typedef struct {
+    ThinkKind kind; /**< Shape of the distribution */
+    double low;     /**< Mean, or lower bound for THINK_UNIFORM */
+    double high;    /**< Upper bound for THINK_UNIFORM */
+} ThinkTime;
+
+/**
+ * @struct ClosedOptions
+ * @brief Client population and think times for closed_loop_curve
+ */
+typedef struct {
+    int max_clients;  /**< Largest client count; the curve doubles from 1 up to it */
+    ThinkTime think;  /**< Time a client waits between a completion and its next submission */
+    uint64_t seed;    /**< Seed for think-time sampling, the same for every client count */
+} ClosedOptions;
+
+/**
+ * @struct ClosedPoint
+ * @brief Outcome of one client count
+ */
+typedef struct {
+    int clients;          /**< Number of clients */
+    int completed;        /**< Jobs completed */
+    int makespan;         /**< Time of the last completion */
+    double throughput;    /**< Completed jobs per time unit */
+    double mean_response; /**< Average time from submission to completion */
+    int p99_response;     /**< 99th percentile time from submission to completion */
+    double utilisation;   /**< Fraction of the makespan the CPU was busy */
+    double mean_think;    /**< Average think time actually sampled */
+} ClosedPoint;
+
+/**
+ * @struct ClosedResult
+ * @brief Throughput and response time as the client count scales
+ */
+typedef struct {
+    ClosedPoint* points; /**< One point per client count, in increasing order */
+    int count;           /**< Number of points */
+    double mean_burst;   /**< Average service demand per job */
+} ClosedResult;
+
+/**
+ * @brief Parses a think-time distribution
+ * @param spec "const:<t>", "exp:<mean>", "uniform:<low>:<high>", or a bare mean (exponential)
+ * @param think Where to store the distribution
+ * @return true if the specification is valid, false otherwise
+ */
+bool parse_think_time(const char* spec, ThinkTime* think);
+
+/**
+ * @brief Runs a closed-loop workload for a doubling series of client counts
+ *
+ * Each client starts by thinking, submits one job to an online engine and,
+ * when it completes, thinks again before submitting the next. Jobs take
+ * the burst times of the input in file order, and each run ends once every
+ * burst has been used once, so every client count does the same work.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes supplying the burst times (not modified)
+ * @param n Number of processes
+ * @param options Client counts and think times
+ * @param result Where to store the curve; release with free_closed_result
+ * @return 0 on success, -1 on failure
+ */
+int closed_loop_curve(const SchedParams* params, const Process* processes, int n, const ClosedOptions* options,
+                      ClosedResult* result);
+
+/**
+ * @brief Prints the throughput and response-time curve with the operational-law bounds
+ * @param result Result of closed_loop_curve
+ * @param options Options passed to closed_loop_curve
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_closed_result(const ClosedResult* result, const ClosedOptions* options, const char* algorithm_name);
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_closed_result(ClosedResult* result);
+
+#endif /* CLOSED_H */
@@ -4,6 +4,319 @@
  */
 
 #include "common.h"
+#include "csv.h"
+#include "decompress.h"
+#include "footprint.h"
+#include "hugemem.h"
+#include "intern.h"
+#include "scan.h"
+#include "uring.h"
+#include "workload.h"
+
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Identifiers of all processes read so far, indexed by Process.id */
+static IdTable process_ids;
+
+/** Partition keys of all processes read so far, indexed by the entries of loaded_partitions */
+static IdTable partition_keys;
+
+/** Partition of each process returned by the last load, or NULL if it had no partition column */
+static uint32_t* loaded_partitions;
+
+/** I/O of each process returned by the last load, or NULL if it had no I/O columns */
+static ProcessIo* loaded_io;
+
+/** Size of each read when streaming input of unknown length */
+#define STREAM_READ_SIZE (1 << 20)
+
+/** Processes per batch when a decoded binary workload is handed to a sink */
+#define SINK_BATCH 65536
+
+/**
+ * @brief Reads a whole regular file into memory
+ * @param file Open file to read
+ * @param size Size of the file in bytes
+ * @param len Where to store the number of bytes read
+ * @return Buffer followed by SCAN_PADDING zero bytes, or NULL on failure
+ */
+static char* load_file(FILE* file, size_t size, size_t* len) {
+    char* data = (char*)malloc(size + SCAN_PADDING);
+    if (!data) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+    footprint_charge(SUBSYSTEM_WORKLOAD, size + SCAN_PADDING);
+
+    // io_uring keeps several large reads in flight; without it the file is read with one fread
+    int status = uring_read(fileno(file), data, size, len);
+    if (status < 0) {
+        footprint_release(SUBSYSTEM_WORKLOAD, size + SCAN_PADDING);
+        free(data);
+        return NULL;
+    }
+    if (status == URING_UNAVAILABLE) {
+        *len = fread(data, 1, size, file);
+    }
+    if (status == URING_UNAVAILABLE && *len != size && ferror(file)) {
+        perror("Error reading file");
+        footprint_release(SUBSYSTEM_WORKLOAD, size + SCAN_PADDING);
+        free(data);
+        return NULL;
+    }
+
+    memset(data + *len, 0, SCAN_PADDING);
+    return data;
+}
+
+/**
+ * @brief Destination of processes handed over while the input is still being parsed
+ */
+typedef struct {
+    ProcessBatchFn fn; /**< Called with each batch */
+    void* context;     /**< Passed to fn */
+    int delivered;     /**< Processes handed over so far */
+    IdTable* ids;      /**< Identifiers emptied after each batch, or NULL to keep them */
+} ProcessSink;
+
+/**
+ * @brief Hands the processes parsed since the last call to a sink and empties the array
+ * @param out Array of parsed processes
+ * @param sink Sink to deliver to, or NULL to keep the processes in out
+ * @return 0 on success, -1 if the sink stopped the load or there are too many processes
+ */
+static int flush_batch(ProcessArray* out, ProcessSink* sink) {
+    if (!sink || out->count == 0) {
+        return 0;
+    }
+    if (out->count > INT32_MAX - sink->delivered) {
+        fprintf(stderr, "Error: Too many processes\n");
+        return -1;
+    }
+    int status = sink->fn(sink->context, out->processes, out->count);
+    sink->delivered += out->count;
+    out->count = 0;
+    if (sink->ids) {
+        id_table_clear(sink->ids);
+    }
+    return status;
+}
+
+/**
+ * @brief Parses input of unknown length, such as a pipe, in fixed-size reads
+ * @param name Input name used in messages
+ * @param file Open file to read
+ * @param prefix Bytes already read from file
+ * @param prefix_len Number of bytes in prefix
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @param sink Sink that receives the processes after each read, or NULL to keep them in out
+ * @return 0 on success, -1 on failure
+ */
+static int stream_file(const char* name, FILE* file, const char* prefix, size_t prefix_len, const CsvKeys* keys,
+                       ProcessArray* out, ProcessSink* sink) {
+    CsvStream* stream = csv_stream_create(name, keys, out);
+    char* buffer = (char*)malloc(STREAM_READ_SIZE);
+    if (!stream || !buffer) {
+        if (!buffer) perror("Memory allocation failed");
+        csv_stream_abort(stream);
+        free(buffer);
+        return -1;
+    }
+
+    int status = prefix_len > 0 ? csv_stream_feed(stream, prefix, prefix_len) : 0;
+    size_t got;
+    while (status == 0 && (got = fread(buffer, 1, STREAM_READ_SIZE, file)) > 0) {
+        status = csv_stream_feed(stream, buffer, got);
+        if (status == 0) {
+            status = flush_batch(out, sink);
+        }
+    }
+    if (ferror(file)) {
+        perror("Error reading file");
+        status = -1;
+    }
+
+    // A stopped load leaves a partial row behind, which must not be parsed as if the input ended there
+    if (status != 0) {
+        csv_stream_abort(stream);
+    } else if (csv_stream_finish(stream) != 0) {
+        status = -1;
+    }
+    if (status == 0) {
+        status = flush_batch(out, sink);
+    }
+    free(buffer);
+    return status;
+}
+
+/**
+ * @brief Parses compressed input as it is decompressed on a reader thread
+ * @param name Input name used in messages
+ * @param file Open file to read
+ * @param format Compression format detected from the first bytes
+ * @param prefix Bytes already read from file
+ * @param prefix_len Number of bytes in prefix
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @param sink Sink that receives the processes after each block, or NULL to keep them in out
+ * @return 0 on success, -1 on failure
+ */
+static int stream_compressed(const char* name, FILE* file, Compression format, const char* prefix,
+                             size_t prefix_len, const CsvKeys* keys, ProcessArray* out, ProcessSink* sink) {
+    Decompressor* decompressor = decompressor_start(name, file, format, prefix, prefix_len);
+    if (!decompressor) {
+        return -1;
+    }
+    CsvStream* stream = csv_stream_create(name, keys, out);
+    if (!stream) {
+        decompressor_finish(decompressor);
+        return -1;
+    }
+
+    // Each block is parsed while the reader thread decompresses the next one
+    const char* data;
+    size_t len;
+    bool first = true;
+    int status;
+    while ((status = decompressor_next(decompressor, &data, &len)) == 0 && len > 0) {
+        if (first && workload_is_binary(data, len)) {
+            fprintf(stderr, "%s: compressed binary workloads are not supported\n", name);
+            status = -1;
+            break;
+        }
+        first = false;
+        if ((status = csv_stream_feed(stream, data, len)) != 0 || (status = flush_batch(out, sink)) != 0) {
+            break;
+        }
+    }
+
+    if (decompressor_finish(decompressor) != 0) {
+        status = -1;
+    }
+    if (status != 0) {
+        csv_stream_abort(stream);
+    } else if (csv_stream_finish(stream) != 0) {
+        status = -1;
+    }
+    if (status == 0) {
+        status = flush_batch(out, sink);
+    }
+    return status;
+}
+
+/**
+ * @brief Hands a loaded array to the caller and keeps its partitions and I/O for the accessors
+ * @param parsed Array filled by the parser
+ * @param processes Where to store the processes
+ * @return Number of processes
+ */
+static int keep_loaded(const ProcessArray* parsed, Process** processes) {
+    // The slack past the last process is never touched, so only the processes returned stay charged
+    size_t entry = sizeof(Process) + (parsed->partitions ? sizeof(uint32_t) : 0) +
+                   (parsed->io ? sizeof(ProcessIo) : 0);
+    footprint_release(SUBSYSTEM_WORKLOAD, (size_t)(parsed->capacity - parsed->count) * entry);
+    *processes = parsed->processes;
+    loaded_partitions = parsed->partitions;
+    loaded_io = parsed->io;
+    return parsed->count;
+}
+
+/**
+ * @brief Opens an input, recognises its format and parses it
+ * @param filename Name of the CSV file, or "-" for standard input
+ * @param processes Where to store the processes if sink is NULL
+ * @param options Loader options, or NULL for the defaults
+ * @param sink Sink that receives the processes in batches as they are parsed, or NULL
+ * @return Number of processes read, or -1 on failure
+ */
+static int load_processes(const char* filename, Process** processes, const ReadOptions* options,
+                          ProcessSink* sink) {
+    bool use_stdin = strcmp(filename, "-") == 0;
+    FILE* file = use_stdin ? stdin : fopen(filename, "rb");
+    if (!file) {
+        perror("Error opening file");
+        return -1;
+    }
+
+    ProcessArray parsed = {0};
+    WorkloadProfile* profile = options ? options->profile : NULL;
+    IdTable* ids = options && options->discard_ids ? NULL : &process_ids;
+    CsvKeys keys = {ids, options ? options->partition_column : NULL, &partition_keys, profile,
+                    options && options->quiet};
+    int status;
+    struct stat st;
+    bool regular = fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode);
+
+    // Binary workloads are recognised by their first bytes
+    char magic[WORKLOAD_MAGIC_SIZE];
+    size_t magic_len = fread(magic, 1, sizeof(magic), file);
+    if (workload_is_binary(magic, magic_len)) {
+        int n = workload_read(filename, file, magic_len, ids, &partition_keys, profile, &parsed);
+        if (!use_stdin) {
+            fclose(file);
+        }
+        if (n < 0) {
+            return -1;
+        }
+        if (!sink) {
+            return keep_loaded(&parsed, processes);
+        }
+
+        // Binary records are decoded in one go and handed over in stream-sized batches, so their
+        // identifiers must outlive every batch
+        sink->ids = NULL;
+        status = 0;
+        for (int start = 0; status == 0 && start < n; start += SINK_BATCH) {
+            parsed.count = n - start < SINK_BATCH ? n - start : SINK_BATCH;
+            Process* all = parsed.processes;
+            parsed.processes = all + start;
+            status = flush_batch(&parsed, sink);
+            parsed.processes = all;
+        }
+        process_array_free(&parsed);
+        return status == 0 ? n : -1;
+    }
+
+    // Streaming loads parse regular files in reads too, so the first batch is ready early
+    Compression compression = compression_detect(magic, magic_len);
+    bool whole = compression == COMPRESSION_NONE && regular && !sink;
+    if (whole && fseek(file, 0, SEEK_SET) != 0) {
+        perror("Error reading file");
+        if (!use_stdin) fclose(file);
+        return -1;
+    }
+
+    if (compression != COMPRESSION_NONE) {
+        status = stream_compressed(filename, file, compression, magic, magic_len, &keys, &parsed, sink);
+    } else if (whole) {
+        // Regular files are loaded whole so they can be split across threads
+        size_t len = 0;
+        char* data = load_file(file, (size_t)st.st_size, &len);
+        status = -1;
+        if (data) {
+            int threads = options ? options->threads : 0;
+            status = csv_parse_processes(filename, data, len, threads, &keys, &parsed);
+            footprint_release(SUBSYSTEM_WORKLOAD, (size_t)st.st_size + SCAN_PADDING);
+            free(data);
+        }
+    } else {
+        status = stream_file(filename, file, magic, magic_len, &keys, &parsed, sink);
+    }
+
+    if (!use_stdin) {
+        fclose(file);
+    }
+
+    if (status != 0 || sink) {
+        process_array_free(&parsed);
+        return status != 0 ? -1 : sink->delivered;
+    }
+
+    return keep_loaded(&parsed, processes);
+}
 
 /**
  * @brief Reads process data from a CSV file
@@ -12,71 +325,136 @@
  * @return Number of processes read
  */
 int read_processes(const char* filename, Process** processes) {
-    FILE* file = fopen(filename, "r");
+    return read_processes_with_options(filename, processes, NULL);
+}
+
+/**
+ * @brief Reads process data from a CSV file with explicit options
+ *
+ * Input that starts with the binary workload magic is decoded directly.
+ * gzip and zstd input, recognised by its magic bytes, is decompressed on a
+ * reader thread and parsed block by block as it arrives.
+ * Other regular files are loaded with a single read and parsed in one pass
+ * by the vectorised CSV scanner, split across threads for large files.
+ * Pipes and standard input ("-") are parsed incrementally as they are read.
+ *
+ * @param filename Name of the CSV file, or "-" for standard input
+ * @param processes Pointer to array to store the processes
+ * @param options Loader options, or NULL for the defaults
+ * @return Number of processes read
+ */
+int read_processes_with_options(const char* filename, Process** processes, const ReadOptions* options) {
+    return load_processes(filename, processes, options, NULL);
+}
+
+/**
+ * @brief Releases an array returned by read_processes or read_processes_with_options
+ *
+ * The partitions and I/O read with it are released too.
+ *
+ * @param processes Array to free, or NULL
+ * @param n Number of processes read into it
+ */
+void free_processes(Process* processes, int n) {
+    if (processes) {
+        size_t entry = sizeof(Process) + (loaded_partitions ? sizeof(uint32_t) : 0) +
+                       (loaded_io ? sizeof(ProcessIo) : 0);
+        footprint_release(SUBSYSTEM_WORKLOAD, (size_t)n * entry);
+        free(processes);
+        free(loaded_partitions);
+        free(loaded_io);
+        loaded_partitions = NULL;
+        loaded_io = NULL;
+    }
+}
+
+/**
+ * @brief Returns the partition of each process returned by the last read_processes call
+ * @return Partition key indices in input order, or NULL if no partition column was read
+ */
+const uint32_t* process_partitions(void) {
+    return loaded_partitions;
+}
+
+/**
+ * @brief Returns the I/O behaviour of each process returned by the last read_processes call
+ * @return I/O parameters in input order, or NULL if the input has no I/O columns
+ */
+const ProcessIo* process_io(void) {
+    return loaded_io;
+}
+
+/**
+ * @brief Reads process data and hands it over in batches while parsing continues
+ * @param filename Name of the input file, or "-" for standard input
+ * @param options Loader options, or NULL for the defaults; threads is ignored
+ * @param fn Called on the loading thread with each batch, in input order
+ * @param context Passed to fn
+ * @return Number of processes read, or -1 on failure or if fn stopped the load
+ */
+int read_processes_streaming(const char* filename, const ReadOptions* options, ProcessBatchFn fn, void* context) {
+    bool batch_ids = options && options->batch_ids && !options->discard_ids;
+    ProcessSink sink = {fn, context, 0, batch_ids ? &process_ids : NULL};
+    return load_processes(filename, NULL, options, &sink);
+}
+
+/**
+ * @brief Writes processes to a file in the binary workload format
+ * @param filename Name of the file to create
+ * @param processes Array returned by read_processes, in input order
+ * @param n Number of processes
+ * @return 0 on success, -1 on failure
+ */
+int write_processes_binary(const char* filename, const Process* processes, int n) {
+    FILE* file = fopen(filename, "wb");
     if (!file) {
         perror("Error opening file");
         return -1;
     }
-    
-    // Count the number of lines (processes) in the file
-    int count = 0;
-    char buffer[256];
-    
-    // Skip header line
-    fgets(buffer, sizeof(buffer), file);
-    
-    while (fgets(buffer, sizeof(buffer), file)) {
-        count++;
-    }
-    
-    // Allocate memory for processes
-    *processes = (Process*)malloc(count * sizeof(Process));
-    if (!*processes) {
-        perror("Memory allocation failed");
-        fclose(file);
-        return -1;
+
+    ProcessArray workload = {(Process*)processes, loaded_partitions, loaded_io, n, n};
+    int status = workload_write(file, &workload, &process_ids, partition_keys.count > 0 ? &partition_keys : NULL);
+    if (fclose(file) != 0) {
+        status = -1;
     }
-    
-    // Reset file pointer to beginning
-    rewind(file);
-    
-    // Skip header line again
-    fgets(buffer, sizeof(buffer), file);
-    
-    // Read process data
-    int i = 0;
-    while (i < count && fgets(buffer, sizeof(buffer), file)) {
-        Process* p = &(*processes)[i];
-        
-        // Parse CSV line
-        char* token = strtok(buffer, ",");
-        if (token) {
-            strncpy(p->id, token, sizeof(p->id) - 1);
-            p->id[sizeof(p->id) - 1] = '\0';
-        }
-        
-        token = strtok(NULL, ",");
-        if (token) p->arrival_time = atoi(token);
-        
-        token = strtok(NULL, ",");
-        if (token) p->burst_time = atoi(token);
-        
-        token = strtok(NULL, ",");
-        if (token) p->priority = atoi(token);
-        
-        // Initialize other fields
-        p->remaining_time = p->burst_time;
-        p->completion_time = 0;
-        p->turnaround_time = 0;
-        p->waiting_time = 0;
-        p->response_time = -1;  // -1 indicates not started yet
-        p->started = false;
-        
-        i++;
+    if (status != 0) {
+        perror("Error writing file");
     }
-    
-    fclose(file);
-    return count;
+    return status;
+}
+
+/**
+ * @brief Returns the identifier string of a process
+ * @param process Process whose identifier to look up
+ * @return NUL-terminated identifier as read from the input file
+ */
+const char* process_name(const Process* process) {
+    return id_table_name(&process_ids, process->id);
+}
+
+/**
+ * @brief Returns the key of a partition
+ * @param partition Entry of process_partitions
+ * @return NUL-terminated key as read from the partition column
+ */
+const char* partition_name(uint32_t partition) {
+    return id_table_name(&partition_keys, partition);
+}
+
+/**
+ * @brief Returns the number of distinct partition keys read so far
+ * @return Number of partitions; every entry of process_partitions is below this
+ */
+uint32_t partition_count(void) {
+    return partition_keys.count;
+}
+
+/**
+ * @brief Releases the identifiers and partition keys interned by read_processes
+ */
+void free_process_ids(void) {
+    id_table_free(&process_ids);
+    id_table_free(&partition_keys);
 }
 
 /**
@@ -92,12 +470,64 @@ void print_processes(Process* processes, int n) {
     for (int i = 0; i < n; i++) {
         Process p = processes[i];
         printf("%-10s %-12d %-10d %-10d %-15d %-15d %-15d\n", 
-               p.id, p.arrival_time, p.burst_time, p.priority, 
+               process_name(&p), p.arrival_time, p.burst_time, p.priority, 
                p.completion_time, p.turnaround_time, p.waiting_time);
     }
     printf("----------------------------------------------------------------------------------\n");
 }
 
+/** Extra output of print_metrics, set by set_metrics_output */
+static MetricsOutput metrics_output;
+
+/** Waiting time above which a process counts as starved, or 0 */
+static int starvation_limit;
+
+/**
+ * @brief Prints percentiles of one time on a single line
+ * @param label Name of the time
+ * @param histogram Distribution of the time
+ */
+static void print_percentile_row(const char* label, const Histogram* histogram) {
+    printf("%s Time Percentiles: p50 %d, p90 %d, p99 %d, p99.9 %d, max %d\n", label,
+           histogram_percentile(histogram, 50.0), histogram_percentile(histogram, 90.0),
+           histogram_percentile(histogram, 99.0), histogram_percentile(histogram, 99.9), histogram->max);
+}
+
+/**
+ * @brief Prints percentiles of the slowdown, stored in hundredths
+ * @param histogram Distribution of slowdowns
+ */
+static void print_slowdown_row(const Histogram* histogram) {
+    printf("Slowdown Percentiles: p50 %.2f, p90 %.2f, p99 %.2f, p99.9 %.2f, max %.2f\n",
+           histogram_percentile(histogram, 50.0) / 100.0, histogram_percentile(histogram, 90.0) / 100.0,
+           histogram_percentile(histogram, 99.0) / 100.0, histogram_percentile(histogram, 99.9) / 100.0,
+           histogram->max / 100.0);
+}
+
+/**
+ * @brief Prints queue length and utilisation, and checks them against Little's law
+ *
+ * By Little's law the mean ready-queue length equals the arrival rate
+ * times the mean waiting time, and with both taken over the same span
+ * this means the queue integral equals the total waiting time. The
+ * integral comes from the simulator's events and the waiting times from
+ * the processes, so any difference is a bookkeeping error.
+ *
+ * @param metrics Metrics with queue integrals
+ */
+static void print_queue_rows(const Metrics* metrics) {
+    double span = (double)metrics->span;
+    double queue = metrics->queue_area / span;
+    double rate = metrics->count / span;
+    double wait = (double)metrics->total_waiting / metrics->count;
+    printf("Ready Queue Length: average %.3f, peak %d%s\n", queue, metrics->max_queue,
+           metrics->cpus > 1 ? " (average per CPU, peak of any CPU)" : "");
+    printf("CPU Utilisation: %.2f%% over %lld time units%s\n", 100.0 * metrics->busy_time / span,
+           (long long)metrics->span, metrics->cpus > 1 ? " of CPU time" : "");
+    printf("Little's law: queue %.3f vs arrival rate %.5f x average wait %.2f = %.3f (%s)\n", queue, rate, wait,
+           rate * wait, metrics->queue_area == metrics->total_waiting ? "holds" : "VIOLATED");
+}
+
 /**
  * @brief Prints the metrics of a scheduling algorithm
  * @param metrics Metrics structure containing the performance metrics
@@ -108,40 +538,319 @@ void print_metrics(Metrics metrics, const char* algorithm_name) {
     printf("Average Turnaround Time: %.2f\n", metrics.avg_turnaround_time);
     printf("Average Waiting Time: %.2f\n", metrics.avg_waiting_time);
     printf("Average Response Time: %.2f\n", metrics.avg_response_time);
+    if (metrics_output.percentiles && metrics.count > 0) {
+        print_percentile_row("Turnaround", &metrics.turnaround);
+        print_percentile_row("Waiting", &metrics.waiting);
+        print_percentile_row("Response", &metrics.response);
+    }
+    if (metrics_output.fairness && metrics.count > 0) {
+        printf("Fairness (Jain's index of slowdowns): %.4f\n", fairness_index(&metrics));
+        printf("Maximum Waiting Time: %d\n", metrics.waiting.max);
+        print_slowdown_row(&metrics.slowdown);
+    }
+    if (metrics_output.queue && metrics.span > 0) {
+        print_queue_rows(&metrics);
+    }
+    if (metrics.starved > 0) {
+        printf("Starvation alarm: %lld of %lld processes waited longer than %d (longest wait %d)\n",
+               (long long)metrics.starved, (long long)metrics.count, starvation_limit, metrics.waiting.max);
+    }
     printf("----------------------------------------------------------------------------------\n");
+
+    FILE* file = metrics_output.export_file;
+    if (file) {
+        fprintf(file, "%s\tturnaround\t", algorithm_name);
+        histogram_write(&metrics.turnaround, file);
+        fprintf(file, "%s\twaiting\t", algorithm_name);
+        histogram_write(&metrics.waiting, file);
+        fprintf(file, "%s\tresponse\t", algorithm_name);
+        histogram_write(&metrics.response, file);
+        fprintf(file, "%s\tslowdown\t", algorithm_name);
+        histogram_write(&metrics.slowdown, file);
+        fflush(file);
+    }
+}
+
+/**
+ * @brief Selects the extra output of print_metrics
+ * @param output Output to produce; the default is none
+ */
+void set_metrics_output(const MetricsOutput* output) {
+    metrics_output = *output;
+}
+
+/**
+ * @brief Sets the waiting time above which a process counts as starved
+ * @param threshold Waiting time threshold, or 0 to disable the check
+ */
+void set_starvation_threshold(int threshold) {
+    starvation_limit = threshold;
+}
+
+/**
+ * @brief Returns the threshold set by set_starvation_threshold
+ * @return Waiting time threshold, or 0 if the check is disabled
+ */
+int starvation_threshold(void) {
+    return starvation_limit;
+}
+
+/**
+ * @brief Returns Jain's fairness index of the processes' slowdowns
+ * @param metrics Metrics of a run
+ * @return Index in (0, 1], or 1 if no process was measured
+ */
+double fairness_index(const Metrics* metrics) {
+    if (metrics->count == 0 || metrics->total_slowdown_sq <= 0.0) {
+        return 1.0;
+    }
+    return metrics->total_slowdown * metrics->total_slowdown / (metrics->count * metrics->total_slowdown_sq);
+}
+
+/**
+ * @brief Adds the slowdown of one process to the slowdown sums and histogram
+ * @param metrics Metrics to update
+ * @param time Time from arrival to completion that counts against the process
+ * @param burst_time CPU time required by the process
+ */
+void record_slowdown(Metrics* metrics, int time, int burst_time) {
+    double slowdown = burst_time > 0 ? (double)time / burst_time : 1.0;
+    metrics->total_slowdown += slowdown;
+    metrics->total_slowdown_sq += slowdown * slowdown;
+    histogram_record(&metrics->slowdown, slowdown < INT32_MAX / 100 ? (int)(slowdown * 100.0 + 0.5) : INT32_MAX);
+}
+
+/** Process count below which calculate_metrics stays on the calling thread */
+#define METRICS_PARALLEL_MIN (1 << 20)
+
+/** Minimum number of processes handed to each metrics thread */
+#define METRICS_RANGE_MIN (1 << 18)
+
+/** Upper bound on the number of metrics threads */
+#define METRICS_MAX_THREADS 64
+
+/**
+ * @brief Slice of the process array reduced by one thread
+ */
+typedef struct {
+    Process* processes; /**< Whole process array */
+    int begin;          /**< First process of the slice */
+    int end;            /**< One past the last process of the slice */
+    int64_t sums[3];    /**< Turnaround, waiting and response sums */
+    int threshold;      /**< Starvation threshold, or 0 */
+    Metrics* partial;   /**< Receives the histograms, slowdowns and starved count of the slice */
+} MetricsRange;
+
+/**
+ * @brief Fills in derived times for a slice and sums them
+ *
+ * The sums, histograms, slowdown sums and starved count are all updated
+ * in one pass over the slice.
+ *
+ * @param range Slice to reduce; its sums are updated in place
+ */
+static void reduce_metrics_range(MetricsRange* range) {
+    Metrics* partial = range->partial;
+    int threshold = range->threshold;
+    int64_t turnaround = 0;
+    int64_t waiting = 0;
+    int64_t response = 0;
+
+    for (int i = range->begin; i < range->end; i++) {
+        Process* p = &range->processes[i];
+
+        // Calculate turnaround time (completion time - arrival time)
+        p->turnaround_time = p->completion_time - p->arrival_time;
+
+        // Calculate waiting time (turnaround time - burst time)
+        p->waiting_time = p->turnaround_time - p->burst_time;
+
+        turnaround += p->turnaround_time;
+        waiting += p->waiting_time;
+        response += p->response_time;
+        histogram_record(&partial->turnaround, p->turnaround_time);
+        histogram_record(&partial->waiting, p->waiting_time);
+        histogram_record(&partial->response, p->response_time);
+
+        record_slowdown(partial, p->turnaround_time, p->burst_time);
+        if (threshold > 0 && p->waiting_time > threshold) {
+            partial->starved++;
+        }
+    }
+
+    range->sums[0] += turnaround;
+    range->sums[1] += waiting;
+    range->sums[2] += response;
+}
+
+/**
+ * @brief Thread entry point for reduce_metrics_range
+ * @param arg MetricsRange to reduce
+ * @return NULL
+ */
+static void* reduce_metrics_thread(void* arg) {
+    reduce_metrics_range((MetricsRange*)arg);
+    return NULL;
 }
 
 /**
  * @brief Calculates performance metrics for the given processes
+ *
+ * Sums are kept in 64-bit integers. Very large arrays are split into
+ * contiguous slices that are reduced in parallel and combined in order;
+ * each slice fills its own histograms, which are merged at the end.
+ *
  * @param processes Array of processes
  * @param n Number of processes
  * @return Metrics structure containing the calculated metrics
  */
 Metrics calculate_metrics(Process* processes, int n) {
     Metrics metrics = {0};
-    float total_turnaround = 0, total_waiting = 0, total_response = 0;
-    
-    for (int i = 0; i < n; i++) {
-        // Calculate turnaround time (completion time - arrival time)
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        
-        // Calculate waiting time (turnaround time - burst time)
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-        
-        // Accumulate for averages
-        total_turnaround += processes[i].turnaround_time;
-        total_waiting += processes[i].waiting_time;
-        total_response += processes[i].response_time;
+    if (n <= 0) {
+        return metrics;
     }
-    
+
+    int thread_count = 1;
+    if (n >= METRICS_PARALLEL_MIN) {
+        thread_count = online_cpu_count();
+        if (thread_count > n / METRICS_RANGE_MIN) thread_count = n / METRICS_RANGE_MIN;
+        if (thread_count > METRICS_MAX_THREADS) thread_count = METRICS_MAX_THREADS;
+    }
+
+    // Slice 0 records into the result; the others need their own histograms
+    Metrics* partials = NULL;
+    if (thread_count > 1) {
+        partials = (Metrics*)calloc((size_t)thread_count - 1, sizeof(Metrics));
+        if (!partials) {
+            thread_count = 1;
+        }
+    }
+
+    MetricsRange ranges[METRICS_MAX_THREADS];
+    pthread_t threads[METRICS_MAX_THREADS];
+    bool spawned[METRICS_MAX_THREADS];
+
+    for (int t = 0; t < thread_count; t++) {
+        ranges[t].processes = processes;
+        ranges[t].begin = (int)((int64_t)n * t / thread_count);
+        ranges[t].end = (int)((int64_t)n * (t + 1) / thread_count);
+        ranges[t].sums[0] = ranges[t].sums[1] = ranges[t].sums[2] = 0;
+        ranges[t].threshold = starvation_limit;
+        ranges[t].partial = t == 0 ? &metrics : &partials[t - 1];
+        spawned[t] = false;
+    }
+
+    // Slice 0 runs on this thread; fall back to inline work if a spawn fails
+    for (int t = 1; t < thread_count; t++) {
+        spawned[t] = pthread_create(&threads[t], NULL, reduce_metrics_thread, &ranges[t]) == 0;
+    }
+    reduce_metrics_range(&ranges[0]);
+    for (int t = 1; t < thread_count; t++) {
+        if (spawned[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            reduce_metrics_range(&ranges[t]);
+        }
+    }
+
+    metrics.count = n;
+    for (int t = 0; t < thread_count; t++) {
+        metrics.total_turnaround += ranges[t].sums[0];
+        metrics.total_waiting += ranges[t].sums[1];
+        metrics.total_response += ranges[t].sums[2];
+    }
+    for (int t = 1; t < thread_count; t++) {
+        histogram_merge(&metrics.turnaround, &partials[t - 1].turnaround);
+        histogram_merge(&metrics.waiting, &partials[t - 1].waiting);
+        histogram_merge(&metrics.response, &partials[t - 1].response);
+        histogram_merge(&metrics.slowdown, &partials[t - 1].slowdown);
+        metrics.total_slowdown += partials[t - 1].total_slowdown;
+        metrics.total_slowdown_sq += partials[t - 1].total_slowdown_sq;
+        metrics.starved += partials[t - 1].starved;
+    }
+    free(partials);
+
     // Calculate averages
-    metrics.avg_turnaround_time = total_turnaround / n;
-    metrics.avg_waiting_time = total_waiting / n;
-    metrics.avg_response_time = total_response / n;
-    
+    metrics.avg_turnaround_time = (float)((double)metrics.total_turnaround / n);
+    metrics.avg_waiting_time = (float)((double)metrics.total_waiting / n);
+    metrics.avg_response_time = (float)((double)metrics.total_response / n);
+
     return metrics;
 }
 
+/**
+ * @brief Combines the metrics of two disjoint sets of processes
+ * @param a Metrics of the first set
+ * @param b Metrics of the second set
+ * @return Metrics of the union, with averages recomputed from the totals and histograms added
+ */
+Metrics merge_metrics(Metrics a, Metrics b) {
+    Metrics merged = {0};
+    merged.count = a.count + b.count;
+    merged.total_turnaround = a.total_turnaround + b.total_turnaround;
+    merged.total_waiting = a.total_waiting + b.total_waiting;
+    merged.total_response = a.total_response + b.total_response;
+    merged.turnaround = a.turnaround;
+    merged.waiting = a.waiting;
+    merged.response = a.response;
+    histogram_merge(&merged.turnaround, &b.turnaround);
+    histogram_merge(&merged.waiting, &b.waiting);
+    histogram_merge(&merged.response, &b.response);
+    merged.total_slowdown = a.total_slowdown + b.total_slowdown;
+    merged.total_slowdown_sq = a.total_slowdown_sq + b.total_slowdown_sq;
+    merged.slowdown = a.slowdown;
+    histogram_merge(&merged.slowdown, &b.slowdown);
+    merged.starved = a.starved + b.starved;
+    merged.queue_area = a.queue_area + b.queue_area;
+    merged.busy_time = a.busy_time + b.busy_time;
+    merged.span = a.span + b.span;
+    merged.max_queue = a.max_queue > b.max_queue ? a.max_queue : b.max_queue;
+    merged.cpus = a.cpus + b.cpus;
+
+    if (merged.count > 0) {
+        merged.avg_turnaround_time = (float)((double)merged.total_turnaround / merged.count);
+        merged.avg_waiting_time = (float)((double)merged.total_waiting / merged.count);
+        merged.avg_response_time = (float)((double)merged.total_response / merged.count);
+    }
+    return merged;
+}
+
+/**
+ * @brief Starts integrating the schedule of processes sorted by arrival time
+ * @param integral Integral to initialize
+ * @param processes Processes sorted by arrival time, which must outlive the integral
+ * @param n Number of processes
+ */
+void queue_integral_init(QueueIntegral* integral, const Process* processes, int n) {
+    memset(integral, 0, sizeof(*integral));
+    integral->processes = processes;
+    integral->n = n;
+    integral->start = n > 0 ? processes[0].arrival_time : 0;
+    integral->now = integral->start;
+}
+
+/**
+ * @brief Copies the integrals into the metrics of the finished schedule
+ * @param integral Integral of the whole schedule
+ * @param metrics Metrics to complete
+ */
+void queue_integral_store(const QueueIntegral* integral, Metrics* metrics) {
+    metrics->queue_area = integral->queue_area;
+    metrics->busy_time = integral->busy_time;
+    metrics->span = integral->now - integral->start;
+    metrics->max_queue = integral->max_queue;
+    metrics->cpus = 1;
+}
+
+/**
+ * @brief Returns the number of online CPUs
+ * @return Number of CPUs, at least 1
+ */
+int online_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
 /**
  * @brief Creates a deep copy of the processes array
  * @param src Source array of processes
@@ -149,12 +858,108 @@ Metrics calculate_metrics(Process* processes, int n) {
  * @return Newly allocated array with copied processes
  */
 Process* copy_processes(Process* src, int n) {
-    Process* dest = (Process*)malloc(n * sizeof(Process));
+    Process* dest = (Process*)huge_alloc(n * sizeof(Process));
     if (!dest) {
         perror("Memory allocation failed");
         return NULL;
     }
+    footprint_charge(SUBSYSTEM_ALGORITHM, n * sizeof(Process));
     
     memcpy(dest, src, n * sizeof(Process));
     return dest;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Releases an array returned by copy_processes
+ * @param copy Array to free, or NULL
+ * @param n Number of processes it was copied with
+ */
+void free_process_copy(Process* copy, int n) {
+    if (copy) {
+        footprint_release(SUBSYSTEM_ALGORITHM, n * sizeof(Process));
+        free(copy);
+    }
+}
+
+/**
+ * @brief Comparison function for sorting processes by arrival time
+ * @param a First process
+ * @param b Second process
+ * @return Negative if a arrives before b, positive if a arrives after b
+ */
+int compare_arrival_time(const void* a, const void* b) {
+    return ((const Process*)a)->arrival_time - ((const Process*)b)->arrival_time;
+}
+
+/**
+ * @brief Arrival time and input position of a process, sorted in place of the process
+ */
+typedef struct {
+    int arrival_time; /**< Arrival time of the process */
+    int index;        /**< Position of the process before sorting */
+} ArrivalKey;
+
+/**
+ * @brief Comparison function for sorting arrival keys, ties broken by input position
+ * @param a First key
+ * @param b Second key
+ * @return Negative if a sorts before b, positive if a sorts after b
+ */
+static int compare_arrival_key(const void* a, const void* b) {
+    const ArrivalKey* k1 = (const ArrivalKey*)a;
+    const ArrivalKey* k2 = (const ArrivalKey*)b;
+    if (k1->arrival_time != k2->arrival_time) {
+        return k1->arrival_time < k2->arrival_time ? -1 : 1;
+    }
+    return k1->index - k2->index;
+}
+
+/**
+ * @brief Sorts processes by arrival time and reorders their I/O to match
+ * @param processes Array of processes (reordered in place)
+ * @param io I/O of each process, or NULL
+ * @param sorted_io Where to store the I/O in the new order, if io is given (n entries)
+ * @param n Number of processes
+ * @return true if successful, false if memory allocation failed
+ */
+bool sort_by_arrival(Process* processes, const ProcessIo* io, ProcessIo* sorted_io, int n) {
+    if (!io) {
+        qsort(processes, n, sizeof(Process), compare_arrival_time);
+        return true;
+    }
+
+    ArrivalKey* keys = (ArrivalKey*)malloc((n > 0 ? (size_t)n : 1) * sizeof(ArrivalKey));
+    if (!keys) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        keys[i].arrival_time = processes[i].arrival_time;
+        keys[i].index = i;
+    }
+    qsort(keys, n, sizeof(ArrivalKey), compare_arrival_key);
+    for (int i = 0; i < n; i++) {
+        sorted_io[i] = io[keys[i].index];
+    }
+
+    // Follow each cycle of the permutation, so the processes move without a second array
+    for (int i = 0; i < n; i++) {
+        if (keys[i].index < 0 || keys[i].index == i) {
+            continue;
+        }
+        Process held = processes[i];
+        int j = i;
+        for (;;) {
+            int source = keys[j].index;
+            keys[j].index = -1;
+            if (source == i) {
+                processes[j] = held;
+                break;
+            }
+            processes[j] = processes[source];
+            j = source;
+        }
+    }
+    free(keys);
+    return true;
+}
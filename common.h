@@ -10,13 +10,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "hist.h"
 
 /**
  * @struct Process
  * @brief Structure to represent a process with its attributes
  */
 typedef struct {
-    char id[10];         /**< Process identifier */
+    uint32_t id;         /**< Index of the interned process identifier */
     int arrival_time;    /**< Time at which process arrives */
     int burst_time;      /**< CPU time required by the process */
     int priority;        /**< Priority of the process (lower value means higher priority) */
@@ -30,16 +33,95 @@ typedef struct {
     bool started;        /**< Flag to check if process has started execution */
 } Process;
 
+/**
+ * @struct ProcessIo
+ * @brief I/O behaviour of a process
+ *
+ * Most inputs have no I/O columns, so this is kept in an array beside the
+ * processes rather than in Process, and only for inputs that have them.
+ */
+typedef struct {
+    int interval; /**< CPU time between I/O requests (0 if the process never blocks) */
+    int time;     /**< Duration of each I/O request */
+} ProcessIo;
+
 /**
  * @struct Metrics
  * @brief Structure to store performance metrics of scheduling algorithms
+ *
+ * Besides the sums, each time is kept as a log-linear histogram, which
+ * gives any percentile in fixed memory and merges exactly across shards.
  */
 typedef struct {
     float avg_turnaround_time; /**< Average turnaround time */
     float avg_waiting_time;    /**< Average waiting time */
     float avg_response_time;   /**< Average response time */
+    int64_t count;             /**< Number of processes measured */
+    int64_t total_turnaround;  /**< Sum of turnaround times */
+    int64_t total_waiting;     /**< Sum of waiting times */
+    int64_t total_response;    /**< Sum of response times */
+    Histogram turnaround;      /**< Distribution of turnaround times */
+    Histogram waiting;         /**< Distribution of waiting times */
+    Histogram response;        /**< Distribution of response times */
+    double total_slowdown;     /**< Sum of slowdowns (turnaround, less any time in I/O, / burst) */
+    double total_slowdown_sq;  /**< Sum of squared slowdowns, for Jain's index */
+    Histogram slowdown;        /**< Distribution of slowdowns, in hundredths */
+    int64_t starved;           /**< Processes that waited longer than the starvation threshold */
+    int64_t queue_area;        /**< Integral of the ready-queue length over time */
+    int64_t busy_time;         /**< Time the CPU was running processes or switching between them */
+    int64_t span;              /**< CPU time observed: first arrival to last completion, summed over CPUs */
+    int max_queue;             /**< Longest ready queue held for a positive time */
+    int cpus;                  /**< CPUs whose schedules the integrals cover */
 } Metrics;
 
+/**
+ * @struct QueueIntegral
+ * @brief Time-weighted ready-queue length and busy time of one CPU
+ *
+ * A simulator reports the events that change its state: a process taking
+ * or leaving the CPU, and a process re-entering the queue from I/O.
+ * Arrivals are taken from the sorted process array as the clock passes
+ * them, so the integrals are updated once per event and never per tick.
+ * Events must be reported in time order.
+ */
+typedef struct {
+    const Process* processes; /**< Processes sorted by arrival time */
+    int n;                    /**< Number of processes */
+    int next;                 /**< First process that has not arrived */
+    int64_t start;            /**< First arrival */
+    int64_t now;              /**< Time up to which the integrals are taken */
+    int queued;               /**< Processes waiting for the CPU */
+    int busy;                 /**< Whether the CPU is in use (0 or 1) */
+    int64_t queue_area;       /**< Integral of queued over time */
+    int64_t busy_time;        /**< Integral of busy over time */
+    int max_queue;            /**< Largest queued held for a positive time */
+} QueueIntegral;
+
+/**
+ * @struct MetricsOutput
+ * @brief Extra output produced by every print_metrics call
+ */
+typedef struct {
+    bool percentiles;  /**< Print percentiles of each time after the averages */
+    bool fairness;     /**< Print Jain's index, the longest wait and slowdown percentiles */
+    bool queue;        /**< Print queue length and utilisation, checked against Little's law */
+    FILE* export_file; /**< Stream receiving the histograms of each run, or NULL */
+} MetricsOutput;
+
+/**
+ * @struct ReadOptions
+ * @brief Options controlling how process files are loaded
+ */
+typedef struct {
+    int threads;                     /**< Parser threads for large files (0 = one per online CPU) */
+    const char* partition_column;    /**< Column that assigns each process to a partition, or NULL */
+    struct WorkloadProfile* profile; /**< Receives statistics of the processes as they are parsed, or NULL */
+    bool discard_ids;                /**< Do not keep process identifiers; process_name then returns "?" */
+    bool batch_ids;                  /**< Streamed CSV only: forget identifiers after each batch, so
+                                          process_name is valid only during the batch callback */
+    bool quiet;                      /**< Skip malformed CSV rows without reporting them */
+} ReadOptions;
+
 /**
  * @brief Reads process data from a CSV file
  * @param filename Name of the CSV file
@@ -48,6 +130,102 @@ typedef struct {
  */
 int read_processes(const char* filename, Process** processes);
 
+/**
+ * @brief Reads process data from a CSV file with explicit options
+ * @param filename Name of the CSV file
+ * @param processes Array to store the processes
+ * @param options Loader options, or NULL for the defaults
+ * @return Number of processes read
+ */
+int read_processes_with_options(const char* filename, Process** processes, const ReadOptions* options);
+
+/**
+ * @brief Releases an array returned by read_processes or read_processes_with_options
+ *
+ * The partitions and I/O read with it are released too.
+ *
+ * @param processes Array to free, or NULL
+ * @param n Number of processes read into it
+ */
+void free_processes(Process* processes, int n);
+
+/**
+ * @brief Returns the partition of each process returned by the last read_processes call
+ * @return Partition key indices in input order, or NULL if no partition column was read
+ */
+const uint32_t* process_partitions(void);
+
+/**
+ * @brief Returns the I/O behaviour of each process returned by the last read_processes call
+ * @return I/O parameters in input order, or NULL if the input has no I/O columns
+ */
+const ProcessIo* process_io(void);
+
+/**
+ * @brief Receives processes from read_processes_streaming as they are parsed
+ * @param context Caller's context
+ * @param processes Processes parsed since the last call, in input order; only valid during the call
+ * @param n Number of processes (positive)
+ * @return 0 to continue, -1 to stop loading
+ */
+typedef int (*ProcessBatchFn)(void* context, const Process* processes, int n);
+
+/**
+ * @brief Reads process data and hands it over in batches while parsing continues
+ *
+ * Accepts the same inputs as read_processes_with_options, but CSV is always
+ * parsed in reads of about a megabyte, each batch going to fn as soon as it
+ * is complete, so the caller can start on the first processes before the
+ * rest of the input has been read. fn runs on the calling thread, the only
+ * one that adds identifiers while the load is in progress, so it may call
+ * process_name.
+ *
+ * @param filename Name of the input file, or "-" for standard input
+ * @param options Loader options, or NULL for the defaults; threads is ignored
+ * @param fn Called on the loading thread with each batch, in input order
+ * @param context Passed to fn
+ * @return Number of processes read, or -1 on failure or if fn stopped the load
+ */
+int read_processes_streaming(const char* filename, const ReadOptions* options, ProcessBatchFn fn, void* context);
+
+/**
+ * @brief Writes processes to a file in the binary workload format
+ *
+ * The file keeps process names, partitions and I/O and can be read back
+ * with read_processes, which recognises the format by its first bytes.
+ *
+ * @param filename Name of the file to create
+ * @param processes Array returned by read_processes, in input order
+ * @param n Number of processes
+ * @return 0 on success, -1 on failure
+ */
+int write_processes_binary(const char* filename, const Process* processes, int n);
+
+/**
+ * @brief Returns the identifier string of a process
+ * @param process Process whose identifier to look up
+ * @return NUL-terminated identifier as read from the input file
+ */
+const char* process_name(const Process* process);
+
+/**
+ * @brief Returns the key of a partition
+ * @param partition Entry of process_partitions
+ * @return NUL-terminated key as read from the partition column
+ */
+const char* partition_name(uint32_t partition);
+
+/**
+ * @brief Returns the number of distinct partition keys read so far
+ * @return Number of partitions; every entry of process_partitions is below this
+ */
+uint32_t partition_count(void);
+
+/**
+ * @brief Releases the identifiers and partition keys interned by read_processes
+ */
+void free_process_ids(void);
+
 /**
  * @brief Prints the details of all processes
  * @param processes Array of processes
@@ -62,14 +240,162 @@ void print_processes(Process* processes, int n);
  */
 void print_metrics(Metrics metrics, const char* algorithm_name);
 
+/**
+ * @brief Selects the extra output of print_metrics
+ *
+ * Exported histograms are written as four lines per run, "turnaround",
+ * "waiting", "response" and "slowdown" (in hundredths), each prefixed with
+ * the algorithm name and a tab and followed by the text form of
+ * histogram_write.
+ *
+ * @param output Output to produce; the default is none
+ */
+void set_metrics_output(const MetricsOutput* output);
+
+/**
+ * @brief Sets the waiting time above which a process counts as starved
+ *
+ * calculate_metrics counts such processes in Metrics.starved, and
+ * print_metrics raises an alarm when any are found.
+ *
+ * @param threshold Waiting time threshold, or 0 to disable the check
+ */
+void set_starvation_threshold(int threshold);
+
+/**
+ * @brief Returns the threshold set by set_starvation_threshold
+ * @return Waiting time threshold, or 0 if the check is disabled
+ */
+int starvation_threshold(void);
+
+/**
+ * @brief Returns Jain's fairness index of the processes' slowdowns
+ *
+ * The index is (sum x)^2 / (n * sum x^2) over the slowdowns x. It is 1
+ * when every process is slowed down equally and falls towards 1/n as a
+ * few processes absorb all the delay.
+ *
+ * @param metrics Metrics of a run
+ * @return Index in (0, 1], or 1 if no process was measured
+ */
+double fairness_index(const Metrics* metrics);
+
+/**
+ * @brief Adds the slowdown of one process to the slowdown sums and histogram
+ * @param metrics Metrics to update
+ * @param time Time from arrival to completion that counts against the process
+ * @param burst_time CPU time required by the process
+ */
+void record_slowdown(Metrics* metrics, int time, int burst_time);
+
 /**
  * @brief Calculates performance metrics for the given processes
+ *
+ * Fills in turnaround and waiting times, sums them and records each time
+ * in the histograms. The same pass accumulates slowdowns and counts
+ * starved processes. Very large arrays are reduced on several threads.
+ *
  * @param processes Array of processes
  * @param n Number of processes
  * @return Metrics structure containing the calculated metrics
  */
 Metrics calculate_metrics(Process* processes, int n);
 
+/**
+ * @brief Combines the metrics of two disjoint sets of processes
+ * @param a Metrics of the first set
+ * @param b Metrics of the second set
+ * @return Metrics of the union, with averages recomputed from the totals and histograms added
+ */
+Metrics merge_metrics(Metrics a, Metrics b);
+
+/**
+ * @brief Starts integrating the schedule of processes sorted by arrival time
+ * @param integral Integral to initialize
+ * @param processes Processes sorted by arrival time, which must outlive the integral
+ * @param n Number of processes
+ */
+void queue_integral_init(QueueIntegral* integral, const Process* processes, int n);
+
+/**
+ * @brief Moves the clock forward, queueing the processes that arrive on the way
+ * @param integral Integral to update
+ * @param time New time; it must not be earlier than the last event
+ */
+static inline void queue_integral_advance(QueueIntegral* integral, int64_t time) {
+    for (;;) {
+        int64_t next = time;
+        bool arrival = integral->next < integral->n && integral->processes[integral->next].arrival_time <= time;
+        if (arrival) {
+            next = integral->processes[integral->next].arrival_time;
+        }
+        if (next > integral->now) {
+            int64_t span = next - integral->now;
+            integral->queue_area += integral->queued * span;
+            integral->busy_time += integral->busy * span;
+            if (integral->queued > integral->max_queue) integral->max_queue = integral->queued;
+            integral->now = next;
+        }
+        if (!arrival) {
+            return;
+        }
+        integral->queued++;
+        integral->next++;
+    }
+}
+
+/**
+ * @brief Records a queued process taking the CPU
+ * @param integral Integral to update
+ * @param time Time of the dispatch
+ */
+static inline void queue_integral_dispatch(QueueIntegral* integral, int64_t time) {
+    queue_integral_advance(integral, time);
+    integral->queued--;
+    integral->busy = 1;
+}
+
+/**
+ * @brief Records the CPU starting a context switch while the next process still waits
+ * @param integral Integral to update
+ * @param time Time the switch starts
+ */
+static inline void queue_integral_switch(QueueIntegral* integral, int64_t time) {
+    queue_integral_advance(integral, time);
+    integral->busy = 1;
+}
+
+/**
+ * @brief Records the running process leaving the CPU
+ * @param integral Integral to update
+ * @param time Time the slice ends
+ * @param requeue Whether the process goes back to the ready queue (false if it completes or blocks)
+ */
+static inline void queue_integral_release(QueueIntegral* integral, int64_t time, bool requeue) {
+    queue_integral_advance(integral, time);
+    integral->busy = 0;
+    if (requeue) {
+        integral->queued++;
+    }
+}
+
+/**
+ * @brief Records a process re-entering the ready queue, for example back from I/O
+ * @param integral Integral to update
+ * @param time Time the process becomes ready
+ */
+static inline void queue_integral_ready(QueueIntegral* integral, int64_t time) {
+    queue_integral_advance(integral, time);
+    integral->queued++;
+}
+
+/**
+ * @brief Copies the integrals into the metrics of the finished schedule
+ * @param integral Integral of the whole schedule
+ * @param metrics Metrics to complete
+ */
+void queue_integral_store(const QueueIntegral* integral, Metrics* metrics);
+
 /**
  * @brief Creates a deep copy of the processes array
  * @param src Source array of processes
@@ -78,4 +404,39 @@ Metrics calculate_metrics(Process* processes, int n);
  */
 Process* copy_processes(Process* src, int n);
 
+/**
+ * @brief Releases an array returned by copy_processes
+ * @param copy Array to free, or NULL
+ * @param n Number of processes it was copied with
+ */
+void free_process_copy(Process* copy, int n);
+
+/**
+ * @brief Comparison function for sorting processes by arrival time
+ * @param a First process
+ * @param b Second process
+ * @return Negative if a arrives before b, positive if a arrives after b
+ */
+int compare_arrival_time(const void* a, const void* b);
+
+/**
+ * @brief Sorts processes by arrival time and reorders their I/O to match
+ *
+ * Without I/O this is a plain qsort. With I/O, processes that arrive
+ * together keep their input order.
+ *
+ * @param processes Array of processes (reordered in place)
+ * @param io I/O of each process, or NULL
+ * @param sorted_io Where to store the I/O in the new order, if io is given (n entries)
+ * @param n Number of processes
+ * @return true if successful, false if memory allocation failed
+ */
+bool sort_by_arrival(Process* processes, const ProcessIo* io, ProcessIo* sorted_io, int n);
+
+/**
+ * @brief Returns the number of online CPUs
+ * @return Number of CPUs, at least 1
+ */
+int online_cpu_count(void);
+
 #endif /* COMMON_H */
\ No newline at end of file
@@ -0,0 +1,1142 @@
+/**
+ * @file csv.c
+ * @brief Implementation of CSV parsing for process data
+ */
+
+#include "csv.h"
+#include "footprint.h"
+#include "hugemem.h"
+#include "scan.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+
+/** Minimum number of bytes handed to each parser thread */
+#define CSV_CHUNK_MIN (1 << 20)
+
+/** Upper bound on the number of parser threads */
+#define CSV_MAX_THREADS 64
+
+/** Columns beyond this index are never mapped to a field */
+#define CSV_MAX_COLUMNS 256
+
+/** Number of malformed rows reported individually */
+#define CSV_MAX_REPORTED 10
+
+/**
+ * @brief Process fields that can be read from a column
+ */
+enum {
+    FIELD_ID,
+    FIELD_ARRIVAL,
+    FIELD_BURST,
+    FIELD_PRIORITY,
+    FIELD_IO_INTERVAL,
+    FIELD_IO_TIME,
+    FIELD_PARTITION,
+    FIELD_COUNT
+};
+
+/** Canonical column name of each field, used in messages */
+static const char* const field_names[FIELD_COUNT] = {
+    "process_id", "arrival_time", "burst_time", "priority", "io_interval", "io_time", "partition"
+};
+
+/** Header names accepted for each field (case-insensitive); the partition column is named by the caller */
+static const char* const field_aliases[FIELD_COUNT][4] = {
+    {"process_id", "id", "pid", NULL},
+    {"arrival_time", "arrival", NULL, NULL},
+    {"burst_time", "burst", NULL, NULL},
+    {"priority", "prio", NULL, NULL},
+    {"io_interval", "io_every", NULL, NULL},
+    {"io_time", "io_duration", NULL, NULL},
+    {NULL, NULL, NULL, NULL}
+};
+
+/**
+ * @brief Mapping from CSV columns to process fields, built from the header
+ */
+typedef struct {
+    signed char field_of_column[CSV_MAX_COLUMNS]; /**< Field stored in each column, or -1 */
+    int column_of_field[FIELD_COUNT];             /**< Column of each field, or -1 */
+    int columns_needed;                           /**< Highest mapped column plus one */
+} CsvLayout;
+
+/**
+ * @brief Boundaries of the mapped fields of one row
+ */
+typedef struct {
+    const char* begin[FIELD_COUNT]; /**< Start of each field */
+    const char* end[FIELD_COUNT];   /**< End of each field */
+} CsvRow;
+
+/**
+ * @brief A malformed row kept for reporting
+ */
+typedef struct {
+    int64_t line;       /**< Line number relative to the parsed range */
+    char message[112];  /**< Description of the problem */
+} CsvError;
+
+/**
+ * @brief Parser state for one contiguous range of rows
+ *
+ * The fast path touches only the layout, the identifier table and the
+ * output array. The scratch buffer is used for quoted rows and the error
+ * list only when a row is malformed, so well-formed unquoted rows cost no
+ * allocation beyond the amortised growth of the output.
+ */
+typedef struct {
+    const CsvLayout* layout;            /**< Column mapping */
+    IdTable* ids;                       /**< Table that receives identifiers, or NULL to drop them */
+    IdTable* partitions;                /**< Table that receives partition keys */
+    ProcessArray* out;                  /**< Array that receives processes */
+    WorkloadProfile* profile;           /**< Profile that receives processes, or NULL */
+    int status;                         /**< 0, or -1 after an allocation failure */
+    int64_t lines;                      /**< Physical lines consumed so far */
+    int64_t error_count;                /**< Number of malformed rows */
+    int reported;                       /**< Number of entries in errors */
+    CsvError errors[CSV_MAX_REPORTED];  /**< First malformed rows */
+    char* scratch;                      /**< Unescaped fields of the current quoted row */
+    size_t scratch_len;                 /**< Bytes used in scratch */
+    size_t scratch_capacity;            /**< Bytes allocated for scratch */
+} CsvContext;
+
+/**
+ * @brief Initializes a parser context
+ * @param ctx Context to initialize
+ * @param layout Column mapping
+ * @param ids Table that receives identifiers, or NULL to drop them
+ * @param partitions Table that receives partition keys
+ * @param out Array that receives processes
+ * @param profile Profile that receives processes, or NULL
+ */
+static void context_init(CsvContext* ctx, const CsvLayout* layout, IdTable* ids, IdTable* partitions,
+                         ProcessArray* out, WorkloadProfile* profile) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->layout = layout;
+    ctx->ids = ids;
+    ctx->partitions = partitions;
+    ctx->out = out;
+    ctx->profile = profile;
+}
+
+/**
+ * @brief Records a malformed row
+ * @param ctx Parser context
+ * @param line Line number relative to the parsed range
+ * @param format printf-style description of the problem
+ */
+static void add_error(CsvContext* ctx, int64_t line, const char* format, ...) {
+    ctx->error_count++;
+    if (ctx->reported == CSV_MAX_REPORTED) {
+        return;
+    }
+
+    CsvError* error = &ctx->errors[ctx->reported++];
+    error->line = line;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error->message, sizeof(error->message), format, args);
+    va_end(args);
+}
+
+/**
+ * @brief Prints the malformed rows collected by a sequence of contexts
+ * @param name Input name used in messages
+ * @param contexts Contexts in input order
+ * @param count Number of contexts
+ * @param first_line Line number of the first row of contexts[0], minus one
+ */
+static void report_errors(const char* name, const CsvContext* const* contexts, int count, int64_t first_line) {
+    int64_t base = first_line;
+    int64_t total = 0;
+    int printed = 0;
+
+    for (int i = 0; i < count; i++) {
+        const CsvContext* ctx = contexts[i];
+        for (int j = 0; j < ctx->reported && printed < CSV_MAX_REPORTED; j++) {
+            fprintf(stderr, "%s:%lld: %s\n", name, (long long)(base + ctx->errors[j].line), ctx->errors[j].message);
+            printed++;
+        }
+        base += ctx->lines;
+        total += ctx->error_count;
+    }
+
+    if (total > 0) {
+        fprintf(stderr, "%s: skipped %lld malformed row%s\n", name, (long long)total, total == 1 ? "" : "s");
+    }
+}
+
+/**
+ * @brief Checks whether a layout has a partition column
+ * @param layout Column mapping
+ * @return true if partition keys are kept
+ */
+static bool layout_partitioned(const CsvLayout* layout) {
+    return layout->column_of_field[FIELD_PARTITION] >= 0;
+}
+
+/**
+ * @brief Checks whether a layout has I/O columns
+ * @param layout Column mapping
+ * @return true if I/O parameters are kept
+ */
+static bool layout_has_io(const CsvLayout* layout) {
+    return layout->column_of_field[FIELD_IO_INTERVAL] >= 0 || layout->column_of_field[FIELD_IO_TIME] >= 0;
+}
+
+/**
+ * @brief Resizes an array together with the partitions and I/O kept beside it
+ * @param out Array to resize
+ * @param capacity New number of processes (at least out->count)
+ * @param partitioned Whether partition keys are kept
+ * @param has_io Whether I/O parameters are kept
+ * @return true if successful, false if memory allocation failed
+ */
+bool process_array_resize(ProcessArray* out, int capacity, bool partitioned, bool has_io) {
+    size_t count = (size_t)out->count;
+    size_t size = (size_t)capacity;
+
+    // Arrays grown before a failure keep their contents and are freed with the rest
+    Process* processes = (Process*)huge_realloc(out->processes, count * sizeof(Process), size * sizeof(Process));
+    if (!processes) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    out->processes = processes;
+    if (partitioned) {
+        uint32_t* partitions =
+            (uint32_t*)huge_realloc(out->partitions, count * sizeof(uint32_t), size * sizeof(uint32_t));
+        if (!partitions) {
+            perror("Memory allocation failed");
+            return false;
+        }
+        out->partitions = partitions;
+    }
+    if (has_io) {
+        ProcessIo* io = (ProcessIo*)huge_realloc(out->io, count * sizeof(ProcessIo), size * sizeof(ProcessIo));
+        if (!io) {
+            perror("Memory allocation failed");
+            return false;
+        }
+        out->io = io;
+    }
+
+    size_t entry = sizeof(Process) + (partitioned ? sizeof(uint32_t) : 0) + (has_io ? sizeof(ProcessIo) : 0);
+    footprint_charge(SUBSYSTEM_WORKLOAD, size * entry);
+    footprint_release(SUBSYSTEM_WORKLOAD, (size_t)out->capacity * entry);
+    out->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Makes room for at least one more process
+ * @param out Array to grow
+ * @param layout Column mapping, which decides whether partitions and I/O are kept
+ * @param hint Suggested capacity for the first allocation
+ * @return true if successful, false if memory allocation failed
+ */
+static bool reserve_process(ProcessArray* out, const CsvLayout* layout, size_t hint) {
+    if (out->count < out->capacity) {
+        return true;
+    }
+
+    size_t capacity = out->capacity ? (size_t)out->capacity * 2 : (hint > 16 ? hint : 16);
+    if (capacity > INT32_MAX) {
+        capacity = INT32_MAX;
+    }
+    if ((size_t)out->count >= capacity) {
+        fprintf(stderr, "Error: Too many processes\n");
+        return false;
+    }
+    return process_array_resize(out, (int)capacity, layout_partitioned(layout), layout_has_io(layout));
+}
+
+/**
+ * @brief Releases the processes, partitions and I/O of an array and leaves it empty
+ * @param array Array to free
+ */
+void process_array_free(ProcessArray* array) {
+    size_t entry = sizeof(Process) + (array->partitions ? sizeof(uint32_t) : 0) +
+                   (array->io ? sizeof(ProcessIo) : 0);
+    footprint_release(SUBSYSTEM_WORKLOAD, (size_t)array->capacity * entry);
+    free(array->processes);
+    free(array->partitions);
+    free(array->io);
+    array->processes = NULL;
+    array->partitions = NULL;
+    array->io = NULL;
+    array->count = 0;
+    array->capacity = 0;
+}
+
+/**
+ * @brief Checks whether a header cell names a field
+ * @param begin Start of the trimmed cell
+ * @param len Length of the trimmed cell
+ * @param name Name to compare against
+ * @return true if the cell equals name, ignoring case
+ */
+static bool header_matches(const char* begin, size_t len, const char* name) {
+    if (strlen(name) != len) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (tolower((unsigned char)begin[i]) != tolower((unsigned char)name[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Builds the column mapping from the header line
+ *
+ * Columns are matched by name, so they may appear in any order and unknown
+ * columns are ignored. A header that names none of the known columns is
+ * taken to describe the classic process_id,arrival_time,burst_time,priority
+ * layout. The partition column, if requested, must always be named.
+ *
+ * @param name Input name used in messages
+ * @param begin Start of the header line
+ * @param end End of the header line (excluding the newline)
+ * @param partition_column Header name of the partition column, or NULL
+ * @param layout Mapping to fill in
+ * @return true if the layout has all required columns
+ */
+static bool parse_header(const char* name, const char* begin, const char* end, const char* partition_column,
+                         CsvLayout* layout) {
+    memset(layout->field_of_column, -1, sizeof(layout->field_of_column));
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        layout->column_of_field[f] = -1;
+    }
+
+    int column = 0;
+    bool any = false;
+    const char* cell = begin;
+    while (cell <= end && column < CSV_MAX_COLUMNS) {
+        const char* cell_end = cell;
+        while (cell_end < end && *cell_end != ',') cell_end++;
+
+        // Trim blanks, carriage returns and surrounding quotes
+        const char* b = cell;
+        const char* e = cell_end;
+        while (b < e && (*b == ' ' || *b == '\t' || *b == '"')) b++;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r' || e[-1] == '"')) e--;
+
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (layout->column_of_field[f] >= 0) {
+                continue;
+            }
+            for (int a = 0; a < 4 && field_aliases[f][a]; a++) {
+                if (header_matches(b, (size_t)(e - b), field_aliases[f][a])) {
+                    layout->column_of_field[f] = column;
+                    layout->field_of_column[column] = (signed char)f;
+                    any = true;
+                    break;
+                }
+            }
+        }
+        if (partition_column && layout->column_of_field[FIELD_PARTITION] < 0 &&
+            layout->field_of_column[column] < 0 && header_matches(b, (size_t)(e - b), partition_column)) {
+            layout->column_of_field[FIELD_PARTITION] = column;
+            layout->field_of_column[column] = FIELD_PARTITION;
+        }
+
+        column++;
+        cell = cell_end + 1;
+    }
+
+    if (!any) {
+        for (int f = 0; f <= FIELD_PRIORITY; f++) {
+            layout->column_of_field[f] = f;
+            layout->field_of_column[f] = (signed char)f;
+        }
+    }
+
+    layout->columns_needed = 0;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (layout->column_of_field[f] + 1 > layout->columns_needed) {
+            layout->columns_needed = layout->column_of_field[f] + 1;
+        }
+    }
+
+    for (int f = FIELD_ID; f <= FIELD_BURST; f++) {
+        if (layout->column_of_field[f] < 0) {
+            fprintf(stderr, "%s:1: header has no %s column\n", name, field_names[f]);
+            return false;
+        }
+    }
+    if (partition_column && layout->column_of_field[FIELD_PARTITION] < 0) {
+        fprintf(stderr, "%s:1: header has no %s column\n", name, partition_column);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends one byte to the scratch buffer
+ * @param ctx Parser context
+ * @param c Byte to append
+ * @return true if successful, false if memory allocation failed
+ */
+static bool scratch_push(CsvContext* ctx, char c) {
+    if (ctx->scratch_len + SCAN_PADDING >= ctx->scratch_capacity) {
+        size_t capacity = ctx->scratch_capacity ? ctx->scratch_capacity * 2 : 256;
+        char* scratch = (char*)realloc(ctx->scratch, capacity);
+        if (!scratch) {
+            perror("Memory allocation failed");
+            ctx->status = -1;
+            return false;
+        }
+        ctx->scratch = scratch;
+        ctx->scratch_capacity = capacity;
+    }
+    ctx->scratch[ctx->scratch_len++] = c;
+    return true;
+}
+
+/**
+ * @brief Splits a row that contains double quotes
+ *
+ * Quoted fields may contain commas, newlines and doubled quotes. The
+ * unescaped fields are collected in the scratch buffer and row is pointed
+ * into it.
+ *
+ * @param ctx Parser context
+ * @param line Start of the row
+ * @param end End of the parsed range
+ * @param final Whether more input may follow end
+ * @param row Field boundaries to fill in
+ * @param columns Where to store the number of columns
+ * @param error Where to store a description if the row is malformed
+ * @return Start of the next row, or NULL if the row is cut off by end and
+ *         more input may follow
+ */
+static const char* split_quoted_row(CsvContext* ctx, const char* line, const char* end, bool final,
+                                    CsvRow* row, int* columns, const char** error) {
+    size_t field_begin[FIELD_COUNT];
+    size_t field_end[FIELD_COUNT];
+    const char* p = line;
+    int64_t newlines = 0;
+    int column = 0;
+
+    ctx->scratch_len = 0;
+    *error = NULL;
+
+    for (;;) {
+        size_t start = ctx->scratch_len;
+
+        if (p < end && *p == '"') {
+            p++;
+            for (;;) {
+                if (p >= end) {
+                    if (!final) {
+                        return NULL;
+                    }
+                    *error = "unterminated quoted field";
+                    break;
+                }
+                if (*p == '"') {
+                    if (p + 1 < end && p[1] == '"') {
+                        if (!scratch_push(ctx, '"')) return end;
+                        p += 2;
+                        continue;
+                    }
+                    p++;
+                    break;
+                }
+                if (*p == '\n') {
+                    newlines++;
+                }
+                if (!scratch_push(ctx, *p)) return end;
+                p++;
+            }
+
+            // Only blanks may follow the closing quote
+            while (p < end && *p != ',' && *p != '\n') {
+                if (*p != ' ' && *p != '\t' && *p != '\r' && !*error) {
+                    *error = "unexpected character after quoted field";
+                }
+                p++;
+            }
+        } else {
+            while (p < end && *p != ',' && *p != '\n') {
+                if (!scratch_push(ctx, *p)) return end;
+                p++;
+            }
+            if (ctx->scratch_len > start && ctx->scratch[ctx->scratch_len - 1] == '\r' &&
+                (p >= end || *p == '\n')) {
+                ctx->scratch_len--;
+            }
+        }
+
+        if (column < CSV_MAX_COLUMNS && ctx->layout->field_of_column[column] >= 0) {
+            int f = ctx->layout->field_of_column[column];
+            field_begin[f] = start;
+            field_end[f] = ctx->scratch_len;
+        }
+        column++;
+
+        if (p >= end || *p == '\n') {
+            break;
+        }
+        p++;
+    }
+
+    // Numeric fields are read with 8-byte loads, so keep the tail defined
+    memset(ctx->scratch + ctx->scratch_len, 0, SCAN_PADDING);
+
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        int c = ctx->layout->column_of_field[f];
+        if (c >= 0 && c < column) {
+            row->begin[f] = ctx->scratch + field_begin[f];
+            row->end[f] = ctx->scratch + field_end[f];
+        }
+    }
+
+    *columns = column;
+    ctx->lines += newlines + 1;
+    return p < end ? p + 1 : end;
+}
+
+/**
+ * @brief Validates one row and appends it as a process
+ * @param ctx Parser context
+ * @param row Field boundaries
+ * @param columns Number of columns in the row
+ * @param line Line number of the row relative to the parsed range
+ */
+static void emit_row(CsvContext* ctx, const CsvRow* row, int columns, int64_t line) {
+    const CsvLayout* layout = ctx->layout;
+    if (columns < layout->columns_needed) {
+        add_error(ctx, line, "expected at least %d columns, found %d", layout->columns_needed, columns);
+        return;
+    }
+
+    int values[FIELD_COUNT] = {0};
+    for (int f = FIELD_ARRIVAL; f <= FIELD_IO_TIME; f++) {
+        if (layout->column_of_field[f] < 0) {
+            continue;
+        }
+        if (!scan_parse_int(row->begin[f], row->end[f], &values[f])) {
+            int len = (int)(row->end[f] - row->begin[f]);
+            add_error(ctx, line, "%s is not an integer: '%.*s'", field_names[f], len > 24 ? 24 : len,
+                      row->begin[f]);
+            return;
+        }
+    }
+
+    if (values[FIELD_ARRIVAL] < 0) {
+        add_error(ctx, line, "arrival_time must not be negative");
+        return;
+    }
+    if (values[FIELD_BURST] <= 0) {
+        add_error(ctx, line, "burst_time must be positive");
+        return;
+    }
+    if (values[FIELD_IO_INTERVAL] < 0 || values[FIELD_IO_TIME] < 0) {
+        add_error(ctx, line, "io_interval and io_time must not be negative");
+        return;
+    }
+    if (row->end[FIELD_ID] == row->begin[FIELD_ID]) {
+        add_error(ctx, line, "process_id is empty");
+        return;
+    }
+
+    if (!reserve_process(ctx->out, layout, 0)) {
+        ctx->status = -1;
+        return;
+    }
+    ProcessArray* out = ctx->out;
+    Process* p = &out->processes[out->count];
+
+    p->id = 0;
+    if (ctx->ids) {
+        p->id = id_table_intern(ctx->ids, row->begin[FIELD_ID],
+                                (size_t)(row->end[FIELD_ID] - row->begin[FIELD_ID]));
+    }
+    if (p->id == ID_INVALID) {
+        ctx->status = -1;
+        return;
+    }
+
+    if (out->partitions) {
+        uint32_t partition = id_table_intern(ctx->partitions, row->begin[FIELD_PARTITION],
+                                             (size_t)(row->end[FIELD_PARTITION] - row->begin[FIELD_PARTITION]));
+        if (partition == ID_INVALID) {
+            ctx->status = -1;
+            return;
+        }
+        out->partitions[out->count] = partition;
+    }
+    if (out->io) {
+        out->io[out->count].interval = values[FIELD_IO_INTERVAL];
+        out->io[out->count].time = values[FIELD_IO_TIME];
+    }
+
+    p->arrival_time = values[FIELD_ARRIVAL];
+    p->burst_time = values[FIELD_BURST];
+    p->priority = values[FIELD_PRIORITY];
+
+    // Initialize other fields
+    p->remaining_time = p->burst_time;
+    p->completion_time = 0;
+    p->turnaround_time = 0;
+    p->waiting_time = 0;
+    p->response_time = -1;  // -1 indicates not started yet
+    p->started = false;
+
+    if (ctx->profile) {
+        profile_add(ctx->profile, p, values[FIELD_IO_INTERVAL]);
+    }
+    out->count++;
+}
+
+/**
+ * @brief Parses the data rows of a byte range that starts at a line boundary
+ *
+ * Rows without quotes are split with the vectorised scanner alone. A quote
+ * anywhere in a row hands that row to split_quoted_row.
+ *
+ * @param ctx Parser context
+ * @param begin Start of the range
+ * @param end End of the range (SCAN_PADDING readable bytes must follow)
+ * @param final Whether more input may follow end
+ * @return Number of bytes consumed; less than the range only if the last
+ *         row is cut off and final is false, or ctx->status became -1
+ */
+static size_t parse_rows(CsvContext* ctx, const char* begin, const char* end, bool final) {
+    const CsvLayout* layout = ctx->layout;
+    DelimCursor cursor;
+    delim_cursor_init(&cursor, begin, end);
+
+    // Rows in the sample data are about 16 bytes long
+    if (ctx->out->capacity == 0 && !reserve_process(ctx->out, layout, (size_t)(end - begin) / 16)) {
+        ctx->status = -1;
+        return 0;
+    }
+
+    const char* line = begin;
+    while (line < end && ctx->status == 0) {
+        CsvRow row;
+        const char* field = line;
+        const char* delim;
+        int columns = 0;
+        bool quoted = false;
+
+        // Collect the field boundaries of this line
+        for (;;) {
+            delim = delim_next(&cursor);
+            if (delim < end && *delim == '"') {
+                quoted = true;
+                break;
+            }
+            if (columns < CSV_MAX_COLUMNS && layout->field_of_column[columns] >= 0) {
+                int f = layout->field_of_column[columns];
+                row.begin[f] = field;
+                row.end[f] = delim;
+            }
+            columns++;
+            field = delim + 1;
+            if (delim >= end || *delim == '\n') {
+                break;
+            }
+        }
+
+        int64_t line_number = ctx->lines + 1;
+        const char* next_line;
+
+        if (quoted) {
+            const char* error;
+            next_line = split_quoted_row(ctx, line, end, final, &row, &columns, &error);
+            if (!next_line) {
+                break;
+            }
+            delim_cursor_init(&cursor, next_line, end);
+            if (error) {
+                add_error(ctx, line_number, "%s", error);
+                line = next_line;
+                continue;
+            }
+        } else {
+            next_line = delim < end ? delim + 1 : end;
+            ctx->lines++;
+
+            // Drop the carriage return of CRLF line endings
+            if (delim > line && delim[-1] == '\r') {
+                int last = columns - 1;
+                if (last < CSV_MAX_COLUMNS && layout->field_of_column[last] >= 0) {
+                    row.end[layout->field_of_column[last]]--;
+                }
+                if (columns == 1 && delim - line == 1) {
+                    line = next_line;
+                    continue;
+                }
+            }
+
+            // Skip blank lines
+            if (columns == 1 && delim == line) {
+                line = next_line;
+                continue;
+            }
+        }
+
+        emit_row(ctx, &row, columns, line_number);
+        line = next_line;
+    }
+
+    return (size_t)(line - begin);
+}
+
+/**
+ * @brief Work item for one parser thread
+ */
+typedef struct {
+    const char* begin;    /**< First byte of the chunk (a line start) */
+    const char* end;      /**< One past the last byte of the chunk */
+    bool final;           /**< Whether the chunk ends the input */
+    size_t consumed;      /**< Bytes parsed; short of the chunk if its last row runs into the next one */
+    IdTable ids;               /**< Identifiers interned by this chunk */
+    IdTable partitions;        /**< Partition keys interned by this chunk */
+    ProcessArray rows;         /**< Processes parsed from this chunk */
+    WorkloadProfile profile;   /**< Statistics of this chunk's processes */
+    CsvContext ctx;            /**< Parser state of this chunk */
+    Process* dest;             /**< Where the chunk lands in the merged array */
+    uint32_t* dest_partitions; /**< Where the chunk's partition keys land, or NULL */
+    ProcessIo* dest_io;        /**< Where the chunk's I/O parameters land, or NULL */
+    uint32_t* id_map;          /**< Merged index of each local identifier, or NULL */
+    uint32_t* partition_map;   /**< Merged index of each local partition key, or NULL */
+} CsvChunk;
+
+/**
+ * @brief Thread entry point that parses one chunk
+ * @param arg CsvChunk to parse
+ * @return NULL
+ */
+static void* parse_chunk_thread(void* arg) {
+    CsvChunk* chunk = (CsvChunk*)arg;
+    chunk->consumed = parse_rows(&chunk->ctx, chunk->begin, chunk->end, chunk->final);
+    return NULL;
+}
+
+/**
+ * @brief Prepares a chunk for parsing
+ * @param chunk Chunk to initialize
+ * @param layout Column mapping
+ * @param keys Tables of the whole parse; only whether identifiers and a profile are wanted is read
+ * @param begin First byte of the chunk (a line start)
+ * @param end One past the last byte of the chunk
+ * @param final Whether the chunk ends the input
+ */
+static void chunk_init(CsvChunk* chunk, const CsvLayout* layout, const CsvKeys* keys, const char* begin,
+                       const char* end, bool final) {
+    memset(chunk, 0, sizeof(*chunk));
+    chunk->begin = begin;
+    chunk->end = end;
+    chunk->final = final;
+    id_table_init(&chunk->ids);
+    id_table_init(&chunk->partitions);
+    profile_init(&chunk->profile);
+    context_init(&chunk->ctx, layout, keys->ids ? &chunk->ids : NULL, &chunk->partitions, &chunk->rows,
+                 keys->profile ? &chunk->profile : NULL);
+}
+
+/**
+ * @brief Releases the memory held by a chunk
+ * @param chunk Chunk to free
+ */
+static void chunk_free(CsvChunk* chunk) {
+    id_table_free(&chunk->ids);
+    id_table_free(&chunk->partitions);
+    free(chunk->id_map);
+    free(chunk->partition_map);
+    process_array_free(&chunk->rows);
+    free(chunk->ctx.scratch);
+}
+
+/**
+ * @brief Thread entry point that moves one chunk into the merged array
+ *
+ * Identifier and partition indices are remapped while copying, so merging
+ * needs no pass over the data beyond the copy itself.
+ *
+ * @param arg CsvChunk to copy
+ * @return NULL
+ */
+static void* copy_chunk_thread(void* arg) {
+    CsvChunk* chunk = (CsvChunk*)arg;
+    for (int i = 0; i < chunk->rows.count; i++) {
+        chunk->dest[i] = chunk->rows.processes[i];
+        if (chunk->id_map) {
+            chunk->dest[i].id = chunk->id_map[chunk->dest[i].id];
+        }
+    }
+    if (chunk->dest_partitions) {
+        for (int i = 0; i < chunk->rows.count; i++) {
+            chunk->dest_partitions[i] = chunk->partition_map[chunk->rows.partitions[i]];
+        }
+    }
+    if (chunk->dest_io && chunk->rows.count > 0) {
+        memcpy(chunk->dest_io, chunk->rows.io, (size_t)chunk->rows.count * sizeof(ProcessIo));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs a function over all chunks, one thread per chunk
+ *
+ * Chunk 0 runs on the calling thread, as does any chunk whose thread
+ * could not be created.
+ *
+ * @param chunks Chunks to process
+ * @param count Number of chunks
+ * @param fn Function to run on each chunk
+ */
+static void run_chunks(CsvChunk* chunks, int count, void* (*fn)(void*)) {
+    pthread_t threads[CSV_MAX_THREADS];
+    bool spawned[CSV_MAX_THREADS];
+
+    for (int i = 1; i < count; i++) {
+        spawned[i] = pthread_create(&threads[i], NULL, fn, &chunks[i]) == 0;
+    }
+    fn(&chunks[0]);
+    for (int i = 1; i < count; i++) {
+        if (spawned[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            fn(&chunks[i]);
+        }
+    }
+}
+
+/**
+ * @brief Interns the keys of one chunk into a shared table
+ * @param table Shared table
+ * @param local Keys interned by the chunk
+ * @return Index in table of each local key (release with free), or NULL on failure
+ */
+static uint32_t* merge_keys(IdTable* table, const IdTable* local) {
+    uint32_t* map = (uint32_t*)malloc((local->count ? local->count : 1) * sizeof(uint32_t));
+    if (!map) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+    if (!id_table_merge(table, local, map)) {
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+/**
+ * @brief Parses a range on several threads and concatenates the results
+ * @param name Input name used in messages
+ * @param layout Column mapping
+ * @param body Start of the data rows
+ * @param end End of the buffer
+ * @param threads Number of threads to use (at least 2)
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int parse_parallel(const char* name, const CsvLayout* layout, const char* body, const char* end,
+                          int threads, const CsvKeys* keys, ProcessArray* out) {
+    CsvChunk chunks[CSV_MAX_THREADS];
+    size_t body_len = (size_t)(end - body);
+    int count = 0;
+
+    // Split the body into byte ranges that end just after a newline
+    const char* start = body;
+    for (int i = 0; i < threads && start < end; i++) {
+        const char* split = i == threads - 1 ? end : body + body_len * (size_t)(i + 1) / (size_t)threads;
+        if (split < start) {
+            split = start;
+        }
+        if (split < end) {
+            const char* newline = memchr(split, '\n', (size_t)(end - split));
+            split = newline ? newline + 1 : end;
+        }
+
+        chunk_init(&chunks[count++], layout, keys, start, split, split == end);
+        start = split;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    run_chunks(chunks, count, parse_chunk_thread);
+
+    // A quoted field may span the newline a chunk was cut at. The chunk before it then stops short of that
+    // row, and the next chunk, which started inside the field, is parsed again from the row
+    for (int i = 1; i < count; i++) {
+        const CsvChunk* previous = &chunks[i - 1];
+        if (previous->ctx.status != 0 || previous->consumed == (size_t)(previous->end - previous->begin)) {
+            continue;
+        }
+        const char* chunk_end = chunks[i].end;
+        bool final = chunks[i].final;
+        chunk_free(&chunks[i]);
+        chunk_init(&chunks[i], layout, keys, previous->begin + previous->consumed, chunk_end, final);
+        parse_chunk_thread(&chunks[i]);
+    }
+
+    // Merge identifiers and size the output in chunk order
+    int status = 0;
+    size_t total = (size_t)out->count;
+    for (int i = 0; i < count; i++) {
+        if (chunks[i].ctx.status != 0) {
+            status = -1;
+        }
+        total += (size_t)chunks[i].rows.count;
+    }
+    if (status == 0 && total > INT32_MAX) {
+        fprintf(stderr, "Error: Too many processes\n");
+        status = -1;
+    }
+    // Identifiers and partition keys may repeat across chunks, so they are interned again and remapped
+    bool partitioned = layout_partitioned(layout);
+    for (int i = 0; status == 0 && i < count; i++) {
+        if (keys->ids && !(chunks[i].id_map = merge_keys(keys->ids, &chunks[i].ids))) {
+            status = -1;
+        }
+        if (partitioned && !(chunks[i].partition_map = merge_keys(keys->partitions, &chunks[i].partitions))) {
+            status = -1;
+        }
+    }
+
+    if (status == 0 && total > (size_t)out->capacity &&
+        !process_array_resize(out, (int)total, partitioned, layout_has_io(layout))) {
+        status = -1;
+    }
+
+    if (status == 0) {
+        int offset = out->count;
+        for (int i = 0; i < count; i++) {
+            chunks[i].dest = out->processes + offset;
+            chunks[i].dest_partitions = out->partitions ? out->partitions + offset : NULL;
+            chunks[i].dest_io = out->io ? out->io + offset : NULL;
+            offset += chunks[i].rows.count;
+        }
+        run_chunks(chunks, count, copy_chunk_thread);
+        out->count = (int)total;
+
+        // Chunks are consecutive, so their profiles combine in chunk order
+        for (int i = 0; keys->profile && i < count; i++) {
+            profile_append(keys->profile, &chunks[i].profile);
+        }
+    }
+
+    const CsvContext* contexts[CSV_MAX_THREADS] = {NULL};
+    for (int i = 0; i < count; i++) {
+        contexts[i] = &chunks[i].ctx;
+    }
+    if (!keys->quiet) {
+        report_errors(name, contexts, count, 1);
+    }
+
+    for (int i = 0; i < count; i++) {
+        chunk_free(&chunks[i]);
+    }
+    return status;
+}
+
+/**
+ * @brief Parses CSV rows from an in-memory buffer
+ * @param name Input name used in messages
+ * @param data Start of the buffer (SCAN_PADDING readable bytes must follow)
+ * @param len Length of the buffer in bytes
+ * @param threads Number of parser threads (0 = one per online CPU)
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_parse_processes(const char* name, const char* data, size_t len, int threads, const CsvKeys* keys,
+                        ProcessArray* out) {
+    const char* end = data + len;
+
+    // Map columns from the header line
+    const char* body = memchr(data, '\n', len);
+    CsvLayout layout;
+    if (!parse_header(name, data, body ? body : end, keys->partition_column, &layout)) {
+        return -1;
+    }
+    body = body ? body + 1 : end;
+    size_t body_len = (size_t)(end - body);
+
+    if (threads <= 0) {
+        threads = online_cpu_count();
+    }
+    if ((size_t)threads > body_len / CSV_CHUNK_MIN) {
+        threads = (int)(body_len / CSV_CHUNK_MIN);
+    }
+    if (threads > CSV_MAX_THREADS) {
+        threads = CSV_MAX_THREADS;
+    }
+
+    if (threads > 1) {
+        return parse_parallel(name, &layout, body, end, threads, keys, out);
+    }
+
+    CsvContext ctx;
+    context_init(&ctx, &layout, keys->ids, keys->partitions, out, keys->profile);
+    parse_rows(&ctx, body, end, true);
+
+    const CsvContext* contexts[1] = {&ctx};
+    if (!keys->quiet) {
+        report_errors(name, contexts, 1, 1);
+    }
+    free(ctx.scratch);
+    return ctx.status;
+}
+
+/**
+ * @struct CsvStream
+ * @brief Incremental parser state
+ */
+struct CsvStream {
+    const char* name;             /**< Input name used in messages */
+    const char* partition_column; /**< Header name of the partition column, or NULL */
+    CsvLayout layout;             /**< Column mapping, valid once have_header is set */
+    bool have_header;             /**< Whether the header line has been parsed */
+    bool quiet;                   /**< Skip malformed rows without reporting them */
+    CsvContext ctx;               /**< Parser state */
+    int64_t first_line;           /**< Lines consumed before ctx started counting */
+    char* buffer;                 /**< Input not yet consumed */
+    size_t len;                   /**< Bytes used in buffer */
+    size_t capacity;              /**< Bytes allocated for buffer, excluding padding */
+};
+
+/**
+ * @brief Creates a parser that accepts input in pieces
+ * @param name Input name used in messages
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @return New parser, or NULL on memory allocation failure
+ */
+CsvStream* csv_stream_create(const char* name, const CsvKeys* keys, ProcessArray* out) {
+    CsvStream* stream = (CsvStream*)calloc(1, sizeof(CsvStream));
+    if (!stream) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+
+    stream->name = name;
+    stream->partition_column = keys->partition_column;
+    stream->quiet = keys->quiet;
+    context_init(&stream->ctx, &stream->layout, keys->ids, keys->partitions, out, keys->profile);
+    stream->first_line = 1;
+    return stream;
+}
+
+/**
+ * @brief Parses the complete rows held in the stream buffer
+ * @param stream Parser
+ * @param final Whether this is the end of the input
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+static int stream_drain(CsvStream* stream, bool final) {
+    char* begin = stream->buffer;
+    char* end = stream->buffer + stream->len;
+
+    if (!stream->have_header) {
+        char* newline = memchr(begin, '\n', stream->len);
+        if (!newline && !final) {
+            return 0;
+        }
+        if (!parse_header(stream->name, begin, newline ? newline : end, stream->partition_column,
+                          &stream->layout)) {
+            return -1;
+        }
+        stream->have_header = true;
+        begin = newline ? newline + 1 : end;
+    }
+
+    // Only hand over whole lines unless the input is complete
+    char* limit = end;
+    if (!final) {
+        while (limit > begin && limit[-1] != '\n') limit--;
+    }
+
+    if (limit > begin) {
+        begin += parse_rows(&stream->ctx, begin, limit, final);
+    }
+
+    stream->len = (size_t)(end - begin);
+    memmove(stream->buffer, begin, stream->len);
+    return stream->ctx.status;
+}
+
+/**
+ * @brief Feeds the next piece of input to the parser
+ * @param stream Parser
+ * @param data Input bytes
+ * @param len Number of input bytes
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_stream_feed(CsvStream* stream, const char* data, size_t len) {
+    if (stream->len + len > stream->capacity) {
+        size_t capacity = stream->capacity ? stream->capacity : 65536;
+        while (stream->len + len > capacity) {
+            capacity *= 2;
+        }
+        char* buffer = (char*)realloc(stream->buffer, capacity + SCAN_PADDING);
+        if (!buffer) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        memset(buffer + capacity, 0, SCAN_PADDING);
+        stream->buffer = buffer;
+        stream->capacity = capacity;
+    }
+
+    memcpy(stream->buffer + stream->len, data, len);
+    stream->len += len;
+    return stream_drain(stream, false);
+}
+
+/**
+ * @brief Parses any remaining input, reports malformed rows and frees the parser
+ * @param stream Parser
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_stream_finish(CsvStream* stream) {
+    int status = 0;
+    if (stream->buffer) {
+        status = stream_drain(stream, true);
+    } else {
+        fprintf(stderr, "%s: empty input\n", stream->name);
+        status = -1;
+    }
+
+    const CsvContext* contexts[1] = {&stream->ctx};
+    if (!stream->quiet) {
+        report_errors(stream->name, contexts, 1, stream->first_line);
+    }
+    free(stream->ctx.scratch);
+    free(stream->buffer);
+    free(stream);
+    return status;
+}
+
+/**
+ * @brief Frees the parser without parsing the input it still holds
+ * @param stream Parser, or NULL
+ */
+void csv_stream_abort(CsvStream* stream) {
+    if (!stream) {
+        return;
+    }
+
+    // The held bytes may end mid-row, so only the rows already parsed are reported
+    const CsvContext* contexts[1] = {&stream->ctx};
+    if (!stream->quiet) {
+        report_errors(stream->name, contexts, 1, stream->first_line);
+    }
+    free(stream->ctx.scratch);
+    free(stream->buffer);
+    free(stream);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file csv.h
+ * @brief Parsing of process data in CSV format
+ */
+
+#ifndef CSV_H
+#define CSV_H
+
+#include "common.h"
+#include "intern.h"
+#include "profile.h"
+
+/**
+ * @struct ProcessArray
+ * @brief Growable array of processes filled by the parser
+ *
+ * Partition keys and I/O parameters are kept beside the processes, indexed
+ * alike, and only when the input has those columns.
+ */
+typedef struct {
+    Process* processes;   /**< Parsed processes */
+    uint32_t* partitions; /**< Partition key of each process, or NULL without a partition column */
+    ProcessIo* io;        /**< I/O parameters of each process, or NULL without I/O columns */
+    int count;            /**< Number of parsed processes */
+    int capacity;         /**< Allocated number of processes */
+} ProcessArray;
+
+/**
+ * @struct CsvKeys
+ * @brief Tables that receive the string-valued columns of each row, and an optional profile
+ */
+typedef struct {
+    IdTable* ids;                 /**< Table that receives the process identifiers, or NULL to drop them */
+    const char* partition_column; /**< Header name of the partition column, or NULL for none */
+    IdTable* partitions;          /**< Table that receives partition keys, if partition_column is set */
+    WorkloadProfile* profile;     /**< Profile that receives every parsed process, or NULL */
+    bool quiet;                   /**< Skip malformed rows without reporting them */
+} CsvKeys;
+
+/**
+ * @brief Resizes an array together with the partitions and I/O kept beside it
+ *
+ * The side arrays are allocated on first use; an array without them keeps
+ * partitions and io NULL. The bytes held are charged to the workload
+ * footprint and released by process_array_free.
+ *
+ * @param array Array to resize
+ * @param capacity New number of processes (at least array->count)
+ * @param partitioned Whether partition keys are kept
+ * @param has_io Whether I/O parameters are kept
+ * @return true if successful, false if memory allocation failed
+ */
+bool process_array_resize(ProcessArray* array, int capacity, bool partitioned, bool has_io);
+
+/**
+ * @brief Releases the processes, partitions and I/O of an array and leaves it empty
+ * @param array Array to free
+ */
+void process_array_free(ProcessArray* array);
+
+/**
+ * @brief Parses CSV rows from an in-memory buffer
+ *
+ * The first line is the header. Columns are matched to process fields by
+ * name (process_id, arrival_time, burst_time and optionally priority,
+ * io_interval and io_time), so they may come in any order and extra
+ * columns are ignored. Fields may be quoted as in RFC 4180, lines may end
+ * in CRLF and there is no limit on line length. Malformed rows are
+ * reported on stderr with their line numbers and skipped. If
+ * keys->partition_column is set, that column must be present and its value
+ * is interned into keys->partitions and stored in out->partitions;
+ * otherwise out->partitions stays NULL, as does out->io without an
+ * io_interval or io_time column.
+ *
+ * Delimiters are located with the vectorised scanner from scan.h and
+ * numeric fields are converted with SWAR arithmetic; only rows containing
+ * a double quote leave this path. Buffers larger than a few megabytes are
+ * split into byte ranges aligned on newlines and parsed by several threads,
+ * each into its own array and identifier table. A quoted field that spans
+ * the newline a range was cut at leaves its row to the next range, which is
+ * then parsed again from that row; other quoted rows stay with their range.
+ * The pieces are then concatenated in file order, with identifier and
+ * partition indices remapped to the merged tables during the copy.
+ *
+ * @param name Input name used in messages
+ * @param data Start of the buffer (SCAN_PADDING readable bytes must follow)
+ * @param len Length of the buffer in bytes
+ * @param threads Number of parser threads (0 = one per online CPU)
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_parse_processes(const char* name, const char* data, size_t len, int threads, const CsvKeys* keys,
+                        ProcessArray* out);
+
+/**
+ * @brief Incremental parser for input that arrives in pieces
+ *
+ * Accepts the same format as csv_parse_processes. Pieces may split rows
+ * anywhere; incomplete rows are kept until the rest arrives, so lines of
+ * any length are supported.
+ */
+typedef struct CsvStream CsvStream;
+
+/**
+ * @brief Creates a parser that accepts input in pieces
+ * @param name Input name used in messages
+ * @param keys Tables that receive identifiers and partition keys
+ * @param out Array the parsed processes are appended to
+ * @return New parser, or NULL on memory allocation failure
+ */
+CsvStream* csv_stream_create(const char* name, const CsvKeys* keys, ProcessArray* out);
+
+/**
+ * @brief Feeds the next piece of input to the parser
+ * @param stream Parser
+ * @param data Input bytes
+ * @param len Number of input bytes
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_stream_feed(CsvStream* stream, const char* data, size_t len);
+
+/**
+ * @brief Parses any remaining input, reports malformed rows and frees the parser
+ * @param stream Parser
+ * @return 0 on success, -1 on a bad header or memory allocation failure
+ */
+int csv_stream_finish(CsvStream* stream);
+
+/**
+ * @brief Frees the parser without parsing the input it still holds, for loads stopped early
+ * @param stream Parser, or NULL
+ */
+void csv_stream_abort(CsvStream* stream);
+
+#endif /* CSV_H */
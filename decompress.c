@@ -0,0 +1,417 @@
+/**
+ * @file decompress.c
+ * @brief Implementation of streaming decompression on a reader thread
+ */
+
+#include "decompress.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/** Size of each block of decompressed bytes handed to the caller */
+#define DECOMPRESS_BLOCK_SIZE (1 << 20)
+
+/** Size of each read of compressed bytes */
+#define DECOMPRESS_INPUT_SIZE (256 * 1024)
+
+/**
+ * @brief One of the two blocks passed between the reader thread and the caller
+ */
+typedef struct {
+    char* data; /**< DECOMPRESS_BLOCK_SIZE bytes */
+    size_t len; /**< Bytes of data in use */
+    bool full;  /**< Set by the reader when filled, cleared when the caller hands it back */
+} Block;
+
+struct Decompressor {
+    const char* name;      /**< Input name used in messages */
+    FILE* file;            /**< Stream of compressed bytes */
+    Compression format;    /**< Format being decompressed */
+    pthread_t thread;      /**< Reader thread */
+    pthread_mutex_t lock;  /**< Protects the blocks and the flags below */
+    pthread_cond_t change; /**< Signalled whenever a block or flag changes */
+    Block blocks[2];       /**< Double buffer */
+    int consume;           /**< Block the caller reads next */
+    bool held;             /**< The caller holds blocks[consume] */
+    bool done;             /**< The reader reached the end of the stream */
+    bool failed;           /**< The reader hit a corrupt, truncated or unreadable stream */
+    bool stop;             /**< The caller asked the reader to exit */
+    unsigned char* input;  /**< Compressed bytes read from file */
+    bool ended;            /**< The last gzip member or zstd frame is complete */
+#ifdef HAVE_ZLIB
+    z_stream zlib;         /**< gzip decoder state */
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DCtx* zstd;       /**< zstd decoder state */
+    ZSTD_inBuffer zstd_in; /**< Unconsumed compressed bytes */
+#endif
+};
+
+/**
+ * @brief Detects the compression format of a stream from its first bytes
+ * @param data First bytes of the stream
+ * @param len Number of bytes available (at least 4 for a reliable answer)
+ * @return Detected format, or COMPRESSION_NONE
+ */
+Compression compression_detect(const char* data, size_t len) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    if (len >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return COMPRESSION_GZIP;
+    }
+    if (len >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return COMPRESSION_ZSTD;
+    }
+    return COMPRESSION_NONE;
+}
+
+/**
+ * @brief Returns the name of a compression format
+ * @param format Compression format
+ * @return Lower-case name such as "gzip"
+ */
+const char* compression_name(Compression format) {
+    switch (format) {
+        case COMPRESSION_GZIP:
+            return "gzip";
+        case COMPRESSION_ZSTD:
+            return "zstd";
+        default:
+            return "uncompressed";
+    }
+}
+
+/**
+ * @brief Checks whether this build can decompress a format
+ * @param format Compression format
+ * @return true if the library for the format was linked in
+ */
+bool compression_supported(Compression format) {
+    switch (format) {
+#ifdef HAVE_ZLIB
+        case COMPRESSION_GZIP:
+            return true;
+#endif
+#ifdef HAVE_ZSTD
+        case COMPRESSION_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+/**
+ * @brief Reads the next chunk of compressed bytes into the input buffer
+ * @param decompressor Decompressor to refill
+ * @return Number of bytes read, 0 at end of file, or -1 on a read error
+ */
+static long read_input(Decompressor* decompressor) {
+    size_t got = fread(decompressor->input, 1, DECOMPRESS_INPUT_SIZE, decompressor->file);
+    if (got == 0 && ferror(decompressor->file)) {
+        perror("Error reading file");
+        return -1;
+    }
+    return (long)got;
+}
+#endif
+
+#ifdef HAVE_ZLIB
+/**
+ * @brief Decompresses gzip input until a block is full or the input ends
+ * @param decompressor Decompressor to run
+ * @param block Block to fill
+ * @return 1 if the block is full, 0 at the end of the stream, -1 on error
+ */
+static int fill_gzip(Decompressor* decompressor, Block* block) {
+    z_stream* z = &decompressor->zlib;
+    z->next_out = (Bytef*)block->data;
+    z->avail_out = DECOMPRESS_BLOCK_SIZE;
+    for (;;) {
+        // Inflating without input flushes output held back when the last block filled up
+        if (z->avail_in > 0 || !decompressor->ended) {
+            if (decompressor->ended) {
+                // Concatenated members, as written by gzip -c a b, form one stream
+                inflateReset(z);
+                decompressor->ended = false;
+            }
+            int ret = inflate(z, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                decompressor->ended = true;
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                fprintf(stderr, "%s: corrupt gzip stream (%s)\n", decompressor->name, z->msg ? z->msg : "error");
+                return -1;
+            }
+        }
+        block->len = DECOMPRESS_BLOCK_SIZE - z->avail_out;
+        if (z->avail_out == 0) {
+            return 1;
+        }
+        if (z->avail_in == 0) {
+            long got = read_input(decompressor);
+            if (got <= 0) {
+                if (got == 0 && !decompressor->ended) {
+                    fprintf(stderr, "%s: truncated gzip stream\n", decompressor->name);
+                    return -1;
+                }
+                return got == 0 ? 0 : -1;
+            }
+            z->next_in = decompressor->input;
+            z->avail_in = (uInt)got;
+        }
+    }
+}
+#endif
+
+#ifdef HAVE_ZSTD
+/**
+ * @brief Decompresses zstd input until a block is full or the input ends
+ * @param decompressor Decompressor to run
+ * @param block Block to fill
+ * @return 1 if the block is full, 0 at the end of the stream, -1 on error
+ */
+static int fill_zstd(Decompressor* decompressor, Block* block) {
+    ZSTD_outBuffer out = {block->data, DECOMPRESS_BLOCK_SIZE, 0};
+    ZSTD_inBuffer* in = &decompressor->zstd_in;
+    for (;;) {
+        size_t ret = ZSTD_decompressStream(decompressor->zstd, &out, in);
+        if (ZSTD_isError(ret)) {
+            fprintf(stderr, "%s: corrupt zstd stream (%s)\n", decompressor->name, ZSTD_getErrorName(ret));
+            return -1;
+        }
+        // 0 means every frame seen so far is decoded and flushed
+        decompressor->ended = ret == 0;
+        block->len = out.pos;
+        if (out.pos == out.size) {
+            return 1;
+        }
+        if (in->pos == in->size) {
+            long got = read_input(decompressor);
+            if (got <= 0) {
+                if (got == 0 && !decompressor->ended) {
+                    fprintf(stderr, "%s: truncated zstd stream\n", decompressor->name);
+                    return -1;
+                }
+                return got == 0 ? 0 : -1;
+            }
+            in->src = decompressor->input;
+            in->size = (size_t)got;
+            in->pos = 0;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Fills one block in the format of the stream
+ * @param decompressor Decompressor to run
+ * @param block Block to fill
+ * @return 1 if the block is full, 0 at the end of the stream, -1 on error
+ */
+static int fill_block(Decompressor* decompressor, Block* block) {
+    switch (decompressor->format) {
+#ifdef HAVE_ZLIB
+        case COMPRESSION_GZIP:
+            return fill_gzip(decompressor, block);
+#endif
+#ifdef HAVE_ZSTD
+        case COMPRESSION_ZSTD:
+            return fill_zstd(decompressor, block);
+#endif
+        default:
+            (void)block;
+            return -1;
+    }
+}
+
+/**
+ * @brief Reader thread: fills the two blocks in turn until the stream ends
+ * @param arg Decompressor
+ * @return NULL
+ */
+static void* decompress_thread(void* arg) {
+    Decompressor* decompressor = (Decompressor*)arg;
+    int index = 0;
+    for (;;) {
+        Block* block = &decompressor->blocks[index];
+        pthread_mutex_lock(&decompressor->lock);
+        while (block->full && !decompressor->stop) {
+            pthread_cond_wait(&decompressor->change, &decompressor->lock);
+        }
+        bool stop = decompressor->stop;
+        pthread_mutex_unlock(&decompressor->lock);
+        if (stop) {
+            break;
+        }
+
+        // The block is not full, so the caller does not touch it while it is filled
+        int status = fill_block(decompressor, block);
+
+        pthread_mutex_lock(&decompressor->lock);
+        if (block->len > 0) {
+            block->full = true;
+            index ^= 1;
+        }
+        decompressor->done = status == 0;
+        decompressor->failed = status < 0;
+        pthread_cond_broadcast(&decompressor->change);
+        pthread_mutex_unlock(&decompressor->lock);
+        if (status <= 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Releases a decompressor whose thread is not running
+ * @param decompressor Decompressor to release
+ */
+static void decompressor_free(Decompressor* decompressor) {
+#ifdef HAVE_ZLIB
+    if (decompressor->format == COMPRESSION_GZIP) {
+        inflateEnd(&decompressor->zlib);
+    }
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_freeDCtx(decompressor->zstd);
+#endif
+    free(decompressor->blocks[0].data);
+    free(decompressor->blocks[1].data);
+    free(decompressor->input);
+    free(decompressor);
+}
+
+/**
+ * @brief Starts decompressing a stream on a reader thread
+ * @param name Input name used in messages
+ * @param file Stream to read compressed bytes from; it must stay open until decompressor_finish
+ * @param format Compression format of the stream
+ * @param prefix Bytes already read from file
+ * @param prefix_len Number of bytes in prefix
+ * @return New decompressor, or NULL if the format is unsupported or the thread could not start
+ */
+Decompressor* decompressor_start(const char* name, FILE* file, Compression format, const char* prefix,
+                                 size_t prefix_len) {
+    if (!compression_supported(format)) {
+        fprintf(stderr, "%s: %s input is not supported by this build\n", name, compression_name(format));
+        return NULL;
+    }
+
+    Decompressor* decompressor = (Decompressor*)calloc(1, sizeof(Decompressor));
+    if (!decompressor) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+    decompressor->name = name;
+    decompressor->file = file;
+    decompressor->format = format;
+    decompressor->blocks[0].data = (char*)malloc(DECOMPRESS_BLOCK_SIZE);
+    decompressor->blocks[1].data = (char*)malloc(DECOMPRESS_BLOCK_SIZE);
+    decompressor->input = (unsigned char*)malloc(DECOMPRESS_INPUT_SIZE);
+    if (!decompressor->blocks[0].data || !decompressor->blocks[1].data || !decompressor->input) {
+        perror("Memory allocation failed");
+        decompressor->format = COMPRESSION_NONE;
+        decompressor_free(decompressor);
+        return NULL;
+    }
+    memcpy(decompressor->input, prefix, prefix_len);
+
+    bool ready = false;
+#ifdef HAVE_ZLIB
+    if (format == COMPRESSION_GZIP) {
+        // 16 added to the window bits selects the gzip wrapper
+        ready = inflateInit2(&decompressor->zlib, 15 + 16) == Z_OK;
+        decompressor->zlib.next_in = decompressor->input;
+        decompressor->zlib.avail_in = (uInt)prefix_len;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (format == COMPRESSION_ZSTD) {
+        decompressor->zstd = ZSTD_createDCtx();
+        ready = decompressor->zstd != NULL;
+        decompressor->zstd_in.src = decompressor->input;
+        decompressor->zstd_in.size = prefix_len;
+        decompressor->zstd_in.pos = 0;
+    }
+#endif
+    if (!ready) {
+        fprintf(stderr, "%s: cannot initialise the %s decoder\n", name, compression_name(format));
+        decompressor->format = COMPRESSION_NONE;
+        decompressor_free(decompressor);
+        return NULL;
+    }
+
+    pthread_mutex_init(&decompressor->lock, NULL);
+    pthread_cond_init(&decompressor->change, NULL);
+    if (pthread_create(&decompressor->thread, NULL, decompress_thread, decompressor) != 0) {
+        fprintf(stderr, "%s: cannot start the decompression thread\n", name);
+        pthread_cond_destroy(&decompressor->change);
+        pthread_mutex_destroy(&decompressor->lock);
+        decompressor_free(decompressor);
+        return NULL;
+    }
+    return decompressor;
+}
+
+/**
+ * @brief Waits for the next block of decompressed bytes
+ * @param decompressor Decompressor to read from
+ * @param data Where to store the start of the block
+ * @param len Where to store the length of the block; 0 at the end of the stream
+ * @return 0 on success, -1 if the stream is corrupt, truncated or unreadable
+ */
+int decompressor_next(Decompressor* decompressor, const char** data, size_t* len) {
+    pthread_mutex_lock(&decompressor->lock);
+    if (decompressor->held) {
+        // Hand the previous block back so the reader can refill it
+        decompressor->blocks[decompressor->consume].full = false;
+        decompressor->consume ^= 1;
+        decompressor->held = false;
+        pthread_cond_broadcast(&decompressor->change);
+    }
+
+    Block* block = &decompressor->blocks[decompressor->consume];
+    while (!block->full && !decompressor->done && !decompressor->failed) {
+        pthread_cond_wait(&decompressor->change, &decompressor->lock);
+    }
+
+    int status = 0;
+    *data = block->data;
+    *len = 0;
+    if (block->full) {
+        *len = block->len;
+        decompressor->held = true;
+    } else if (decompressor->failed) {
+        status = -1;
+    }
+    pthread_mutex_unlock(&decompressor->lock);
+    return status;
+}
+
+/**
+ * @brief Stops the reader thread and releases the decompressor
+ * @param decompressor Decompressor to release; may be stopped before the end of the stream
+ * @return 0 if the whole stream was decompressed without error, -1 otherwise
+ */
+int decompressor_finish(Decompressor* decompressor) {
+    pthread_mutex_lock(&decompressor->lock);
+    decompressor->stop = true;
+    pthread_cond_broadcast(&decompressor->change);
+    pthread_mutex_unlock(&decompressor->lock);
+    pthread_join(decompressor->thread, NULL);
+
+    int status = decompressor->done && !decompressor->failed ? 0 : -1;
+    pthread_cond_destroy(&decompressor->change);
+    pthread_mutex_destroy(&decompressor->lock);
+    decompressor_free(decompressor);
+    return status;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file decompress.h
+ * @brief Streaming decompression of gzip and zstd input on a reader thread
+ *
+ * A Decompressor owns a thread that reads compressed bytes from a stream
+ * and decompresses them into one of two fixed-size blocks while the caller
+ * parses the other, so decompression and parsing overlap. Support for each
+ * format depends on the library found at build time (HAVE_ZLIB, HAVE_ZSTD).
+ */
+
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @enum Compression
+ * @brief Compression formats recognised by their magic bytes
+ */
+typedef enum {
+    COMPRESSION_NONE, /**< Not compressed */
+    COMPRESSION_GZIP, /**< gzip (RFC 1952), possibly several concatenated members */
+    COMPRESSION_ZSTD  /**< Zstandard, possibly several concatenated frames */
+} Compression;
+
+/** Opaque decompression pipeline */
+typedef struct Decompressor Decompressor;
+
+/**
+ * @brief Detects the compression format of a stream from its first bytes
+ * @param data First bytes of the stream
+ * @param len Number of bytes available (at least 4 for a reliable answer)
+ * @return Detected format, or COMPRESSION_NONE
+ */
+Compression compression_detect(const char* data, size_t len);
+
+/**
+ * @brief Returns the name of a compression format
+ * @param format Compression format
+ * @return Lower-case name such as "gzip"
+ */
+const char* compression_name(Compression format);
+
+/**
+ * @brief Checks whether this build can decompress a format
+ * @param format Compression format
+ * @return true if the library for the format was linked in
+ */
+bool compression_supported(Compression format);
+
+/**
+ * @brief Starts decompressing a stream on a reader thread
+ * @param name Input name used in messages
+ * @param file Stream to read compressed bytes from; it must stay open until decompressor_finish
+ * @param format Compression format of the stream
+ * @param prefix Bytes already read from file
+ * @param prefix_len Number of bytes in prefix
+ * @return New decompressor, or NULL if the format is unsupported or the thread could not start
+ */
+Decompressor* decompressor_start(const char* name, FILE* file, Compression format, const char* prefix,
+                                 size_t prefix_len);
+
+/**
+ * @brief Waits for the next block of decompressed bytes
+ *
+ * The block stays valid until the next call, which hands it back to the
+ * reader thread for refilling.
+ *
+ * @param decompressor Decompressor to read from
+ * @param data Where to store the start of the block
+ * @param len Where to store the length of the block; 0 at the end of the stream
+ * @return 0 on success, -1 if the stream is corrupt, truncated or unreadable
+ */
+int decompressor_next(Decompressor* decompressor, const char** data, size_t* len);
+
+/**
+ * @brief Stops the reader thread and releases the decompressor
+ * @param decompressor Decompressor to release; may be stopped before the end of the stream
+ * @return 0 if the whole stream was decompressed without error, -1 otherwise
+ */
+int decompressor_finish(Decompressor* decompressor);
+
+#endif /* DECOMPRESS_H */
@@ -5,18 +5,6 @@
 
 #include "fcfs.h"
 
-/**
- * @brief Comparison function for sorting processes by arrival time
- * @param a First process
- * @param b Second process
- * @return Negative if a arrives before b, positive if a arrives after b
- */
-static int compare_arrival_time(const void* a, const void* b) {
-    Process* p1 = (Process*)a;
-    Process* p2 = (Process*)b;
-    return p1->arrival_time - p2->arrival_time;
-}
-
 /**
  * @brief Executes the First-Come-First-Serve (FCFS) scheduling algorithm
  * 
@@ -32,6 +20,8 @@ Metrics fcfs_schedule(Process* processes, int n) {
     qsort(processes, n, sizeof(Process), compare_arrival_time);
     
     int current_time = 0;
+    QueueIntegral integral;
+    queue_integral_init(&integral, processes, n);
     
     // Execute processes in order of arrival
     for (int i = 0; i < n; i++) {
@@ -43,6 +33,7 @@ Metrics fcfs_schedule(Process* processes, int n) {
         // Set response time when process first gets CPU
         processes[i].response_time = current_time - processes[i].arrival_time;
         processes[i].started = true;
+        queue_integral_dispatch(&integral, current_time);
         
         // Execute the process (advance time by burst time)
         current_time += processes[i].burst_time;
@@ -50,8 +41,11 @@ Metrics fcfs_schedule(Process* processes, int n) {
         // Set completion time
         processes[i].completion_time = current_time;
         processes[i].remaining_time = 0;
+        queue_integral_release(&integral, current_time, false);
     }
     
     // Calculate and return metrics
-    return calculate_metrics(processes, n);
+    Metrics metrics = calculate_metrics(processes, n);
+    queue_integral_store(&integral, &metrics);
+    return metrics;
 }
\ No newline at end of file
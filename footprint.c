@@ -0,0 +1,339 @@
+/**
+ * @file footprint.c
+ * @brief Implementation of per-subsystem memory accounting and footprint estimates
+ */
+
+#include "footprint.h"
+#include "common.h"
+#include "decompress.h"
+#include "workload.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+/** Bytes at the start, middle and end of a CSV file used to estimate its average line length */
+#define SAMPLE_SIZE (64 * 1024)
+
+/** Memory of the streamed modes that does not grow with the input: batches in flight, read buffers and the jobs
+ *  in the engine at once */
+#define STREAM_FIXED ((size_t)16 << 20)
+
+/** Scheduler state per process besides its copy, such as SJF's completion flags or RR's slice counters */
+#define SCHEDULER_STATE 16
+
+/** Protects the counters below */
+static pthread_mutex_t footprint_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Bytes currently held by each subsystem */
+static size_t current[SUBSYSTEM_COUNT];
+
+/** Largest number of bytes each subsystem has held */
+static size_t peak[SUBSYSTEM_COUNT];
+
+/** Bytes currently held by all subsystems */
+static size_t total;
+
+/** Largest number of bytes held by all subsystems at once */
+static size_t total_peak;
+
+/** Names of the subsystems in the report, indexed by Subsystem */
+static const char* const subsystem_names[SUBSYSTEM_COUNT] = {"workload", "algorithm", "queues", "output"};
+
+/** Names of the modes, indexed by FootprintMode */
+static const char* const mode_names[] = {"loaded whole", "streamed", "streamed, summary only"};
+
+/**
+ * @brief Records memory allocated by a subsystem
+ * @param subsystem Subsystem that allocated the memory
+ * @param bytes Number of bytes allocated
+ */
+void footprint_charge(Subsystem subsystem, size_t bytes) {
+    pthread_mutex_lock(&footprint_lock);
+    current[subsystem] += bytes;
+    if (current[subsystem] > peak[subsystem]) {
+        peak[subsystem] = current[subsystem];
+    }
+    total += bytes;
+    if (total > total_peak) {
+        total_peak = total;
+    }
+    pthread_mutex_unlock(&footprint_lock);
+}
+
+/**
+ * @brief Records memory released by a subsystem
+ * @param subsystem Subsystem that released the memory
+ * @param bytes Number of bytes released, as charged earlier
+ */
+void footprint_release(Subsystem subsystem, size_t bytes) {
+    pthread_mutex_lock(&footprint_lock);
+    current[subsystem] -= bytes < current[subsystem] ? bytes : current[subsystem];
+    total -= bytes < total ? bytes : total;
+    pthread_mutex_unlock(&footprint_lock);
+}
+
+/**
+ * @brief Returns the peak of the total charged by all subsystems
+ * @return Largest number of bytes held at once
+ */
+size_t footprint_peak(void) {
+    pthread_mutex_lock(&footprint_lock);
+    size_t bytes = total_peak;
+    pthread_mutex_unlock(&footprint_lock);
+    return bytes;
+}
+
+/**
+ * @brief Prints the current and peak bytes of each subsystem and the peak resident set size
+ */
+void print_footprint_report(void) {
+    pthread_mutex_lock(&footprint_lock);
+    printf("\nMemory footprint:\n");
+    printf("%-12s %12s %12s\n", "Subsystem", "Current MB", "Peak MB");
+    for (int s = 0; s < SUBSYSTEM_COUNT; s++) {
+        printf("%-12s %12.1f %12.1f\n", subsystem_names[s], current[s] / 1048576.0, peak[s] / 1048576.0);
+    }
+    printf("%-12s %12.1f %12.1f\n", "total", total / 1048576.0, total_peak / 1048576.0);
+    pthread_mutex_unlock(&footprint_lock);
+
+    // The resident set also covers the program, the C library and allocator slack
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        printf("Peak resident set size: %.1f MB\n", usage.ru_maxrss / 1024.0);
+    }
+}
+
+/**
+ * @brief Parses a size such as 512M, 2G or 1048576
+ * @param text Number of bytes, optionally followed by K, M or G (powers of 1024)
+ * @param bytes Where to store the size
+ * @return true if text is a positive size, false otherwise
+ */
+bool parse_memory_size(const char* text, size_t* bytes) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || !(value > 0)) {
+        return false;
+    }
+    int unit = toupper((unsigned char)*end);
+    if (unit == 'K' || unit == 'M' || unit == 'G') {
+        value *= unit == 'K' ? 1024.0 : unit == 'M' ? 1048576.0 : 1073741824.0;
+        end++;
+    }
+    if (*end == 'B' || *end == 'b') {
+        end++;
+    }
+    if (*end != '\0' || value < 1 || value > (double)SIZE_MAX / 2) {
+        return false;
+    }
+    *bytes = (size_t)value;
+    return true;
+}
+
+/**
+ * @brief Measures the complete lines of a sample, skipping the text up to its first newline
+ * @param sample Bytes read from the file
+ * @param len Number of bytes in sample
+ * @param line_length Increased by the average line length, newline included
+ * @param field_length Increased by the average length of the first field
+ * @param samples Incremented if the sample holds a complete line
+ */
+static void measure_lines(const char* sample, size_t len, double* line_length, double* field_length, int* samples) {
+    const char* end = sample + len;
+    const char* first = memchr(sample, '\n', len);
+    const char* line = first;
+    size_t lines = 0;
+    size_t first_fields = 0;
+    while (line && line + 1 < end) {
+        const char* next = memchr(line + 1, '\n', (size_t)(end - line - 1));
+        if (!next) {
+            break;
+        }
+        const char* comma = memchr(line + 1, ',', (size_t)(next - line - 1));
+        first_fields += (size_t)((comma ? comma : next) - line - 1);
+        lines++;
+        line = next;
+    }
+    if (lines > 0) {
+        *line_length += (double)(line - first) / lines;
+        *field_length += (double)first_fields / lines;
+        (*samples)++;
+    }
+}
+
+/**
+ * @brief Estimates the peak memory of each mode before an input is read
+ * @param filename Input file, or "-" for standard input
+ * @param estimate Where to store the estimate
+ */
+void estimate_footprint(const char* filename, FootprintEstimate* estimate) {
+    memset(estimate, 0, sizeof(*estimate));
+    estimate->processes = -1;
+    if (strcmp(filename, "-") == 0) {
+        return;
+    }
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return;
+    }
+    struct stat st;
+    static char sample[SAMPLE_SIZE];
+    size_t len = 0;
+    if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode)) {
+        len = fread(sample, 1, sizeof(sample), file);
+    }
+    if (len == 0) {
+        fclose(file);
+        return;
+    }
+
+    double n;
+    double name_bytes;
+    double input_bytes = (double)st.st_size;
+    bool binary = workload_is_binary(sample, len);
+    if (binary && len >= WORKLOAD_HEADER_SIZE) {
+        const unsigned char* header = (const unsigned char*)sample;
+        n = (double)get_le64(header + 16);
+        name_bytes = n > 0 ? (double)get_le64(header + 24) / n : 0;
+    } else if (binary || compression_detect(sample, len) != COMPRESSION_NONE) {
+        fclose(file);
+        return;
+    } else {
+        // Lines after the header, and the first field of each as a stand-in for the identifier
+        double line_length = 0;
+        double field_length = 0;
+        int samples = 0;
+        measure_lines(sample, len, &line_length, &field_length, &samples);
+        const char* header_end = memchr(sample, '\n', len);
+        double header_bytes = header_end ? (double)(header_end - sample + 1) : 0;
+
+        // Identifiers and times grow through a trace, so the middle and the tail are sampled too,
+        // each weighing as much as the start however short its lines are
+        if (st.st_size > 3 * SAMPLE_SIZE) {
+            off_t offsets[] = {(st.st_size - SAMPLE_SIZE) / 2, st.st_size - SAMPLE_SIZE};
+            for (int i = 0; i < 2; i++) {
+                if (fseeko(file, offsets[i], SEEK_SET) == 0) {
+                    size_t read = fread(sample, 1, sizeof(sample), file);
+                    measure_lines(sample, read, &line_length, &field_length, &samples);
+                }
+            }
+        }
+        if (samples == 0) {
+            fclose(file);
+            return;
+        }
+        n = (input_bytes - header_bytes) / (line_length / samples);
+        name_bytes = field_length / samples + 1;
+    }
+    fclose(file);
+
+    // Arrays grow by doubling, so up to twice the final size may be allocated
+    double process = sizeof(Process);
+    double ids = name_bytes + sizeof(size_t) + 2 * sizeof(uint64_t);
+    double load = (binary ? 0 : input_bytes) + 2 * n * process;
+    double run = 2 * n * process + n * SCHEDULER_STATE;
+
+    // Streamed CSV keeps a batch of names at a time, but a binary workload is decoded whole first
+    double decoded = binary ? n * process : 0;
+    double decoded_ids = binary ? n * ids : 0;
+
+    estimate->processes = (int64_t)n;
+    estimate->loaded = (size_t)((load > run ? load : run) + n * ids);
+    estimate->streamed = (size_t)(decoded + decoded_ids) + STREAM_FIXED;
+    estimate->summary = (size_t)decoded + STREAM_FIXED;
+}
+
+/**
+ * @brief Stops a load at the first arrival earlier than the one before it
+ * @param context Arrival time of the last process seen
+ * @param processes Processes parsed since the last call
+ * @param n Number of processes
+ * @return 0 while the arrivals are in order, -1 otherwise
+ */
+static int check_order(void* context, const Process* processes, int n) {
+    int* last = (int*)context;
+    for (int i = 0; i < n; i++) {
+        if (processes[i].arrival_time < *last) {
+            return -1;
+        }
+        *last = processes[i].arrival_time;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks the records of a binary workload for arrivals in order, a block at a time
+ * @param file Workload opened at its start
+ * @return true if every record is present and in order, false otherwise
+ */
+static bool binary_sorted(FILE* file) {
+    unsigned char header[WORKLOAD_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        return false;
+    }
+    uint32_t record_size = get_le32(header + 8);
+    uint64_t count = get_le64(header + 16);
+    if (record_size < 4 || record_size > SAMPLE_SIZE) {
+        return false;
+    }
+
+    static unsigned char block[SAMPLE_SIZE];
+    uint64_t per_block = SAMPLE_SIZE / record_size;
+    int64_t last = INT32_MIN;
+    for (uint64_t done = 0; done < count;) {
+        size_t want = (size_t)(count - done < per_block ? count - done : per_block);
+        if (fread(block, record_size, want, file) != want) {
+            return false;
+        }
+        for (size_t i = 0; i < want; i++) {
+            int32_t arrival = (int32_t)get_le32(block + i * record_size);
+            if (arrival < last) {
+                return false;
+            }
+            last = arrival;
+        }
+        done += want;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that an input is sorted by arrival time, as the streamed modes need
+ * @param filename Input file, or "-" for standard input
+ * @return true if every arrival is at or after the one before it, false if not or unknown
+ */
+bool footprint_input_sorted(const char* filename) {
+    if (strcmp(filename, "-") == 0) {
+        return false;
+    }
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return false;
+    }
+    char magic[WORKLOAD_MAGIC_SIZE];
+    size_t len = fread(magic, 1, sizeof(magic), file);
+    if (workload_is_binary(magic, len)) {
+        bool sorted = fseek(file, 0, SEEK_SET) == 0 && binary_sorted(file);
+        fclose(file);
+        return sorted;
+    }
+    fclose(file);
+
+    // CSV is parsed in full without keeping it; the run itself reports any malformed rows
+    ReadOptions options = {0};
+    options.discard_ids = true;
+    options.quiet = true;
+    int last = INT32_MIN;
+    return read_processes_streaming(filename, &options, check_order, &last) >= 0;
+}
+
+/**
+ * @brief Returns the name of a mode as printed in the budget report
+ * @param mode Mode to name
+ * @return Static string such as "streamed, summary only"
+ */
+const char* footprint_mode_name(FootprintMode mode) {
+    return mode <= FOOTPRINT_SUMMARY ? mode_names[mode] : "?";
+}
@@ -0,0 +1,121 @@
+/**
+ * @file footprint.h
+ * @brief Accounting of the memory held by each subsystem, and estimates for a memory budget
+ */
+
+#ifndef FOOTPRINT_H
+#define FOOTPRINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @enum Subsystem
+ * @brief Parts of the simulator whose allocations are accounted separately
+ */
+typedef enum {
+    SUBSYSTEM_WORKLOAD,  /**< Input buffers, the loaded process array and interned identifiers */
+    SUBSYSTEM_ALGORITHM, /**< Per-algorithm copies of the processes and scheduler state */
+    SUBSYSTEM_QUEUES,    /**< Ready queues, heaps and rings */
+    SUBSYSTEM_OUTPUT,    /**< Rows and names kept until they are printed */
+    SUBSYSTEM_COUNT      /**< Number of subsystems */
+} Subsystem;
+
+/**
+ * @enum FootprintMode
+ * @brief Ways of running the default simulation, from the largest footprint to the smallest
+ */
+typedef enum {
+    FOOTPRINT_LOADED,   /**< Whole workload in memory, as without a budget */
+    FOOTPRINT_STREAMED, /**< Streamed through the online engine with a row per process */
+    FOOTPRINT_SUMMARY   /**< Streamed with compact records, no identifiers and metrics only */
+} FootprintMode;
+
+/**
+ * @struct FootprintEstimate
+ * @brief Estimated peak memory of each mode for one input
+ */
+typedef struct {
+    int64_t processes; /**< Estimated number of processes, or -1 if the input size is unknown */
+    size_t loaded;     /**< Peak bytes with the whole workload loaded */
+    size_t streamed;   /**< Peak bytes streamed with a row per process */
+    size_t summary;    /**< Peak bytes streamed with metrics only */
+} FootprintEstimate;
+
+/**
+ * @brief Records memory allocated by a subsystem
+ *
+ * Charges and releases are counted per subsystem and in total, and the
+ * peak of each is kept. Safe to call from any thread.
+ *
+ * @param subsystem Subsystem that allocated the memory
+ * @param bytes Number of bytes allocated
+ */
+void footprint_charge(Subsystem subsystem, size_t bytes);
+
+/**
+ * @brief Records memory released by a subsystem
+ * @param subsystem Subsystem that released the memory
+ * @param bytes Number of bytes released, as charged earlier
+ */
+void footprint_release(Subsystem subsystem, size_t bytes);
+
+/**
+ * @brief Returns the peak of the total charged by all subsystems
+ * @return Largest number of bytes held at once
+ */
+size_t footprint_peak(void);
+
+/**
+ * @brief Prints the current and peak bytes of each subsystem and the peak resident set size
+ */
+void print_footprint_report(void);
+
+/**
+ * @brief Parses a size such as 512M, 2G or 1048576
+ * @param text Number of bytes, optionally followed by K, M or G (powers of 1024)
+ * @param bytes Where to store the size
+ * @return true if text is a positive size, false otherwise
+ */
+bool parse_memory_size(const char* text, size_t* bytes);
+
+/**
+ * @brief Estimates the peak memory of each mode before an input is read
+ *
+ * The number of processes comes from the header of a binary workload or,
+ * for CSV, from the file size and the average line length of 64 KB
+ * samples from its start, middle and end. The figures add the input buffer, the process array with its
+ * growth slack, a scheduler copy and the interned identifiers for the
+ * loaded mode. The streamed modes hold a fixed amount, assuming the jobs in
+ * the system at once fit in it, plus the decoded records and identifiers
+ * of a binary workload.
+ * They are estimates for choosing a mode, not bounds. Standard input and
+ * compressed files have no known size; processes is then -1.
+ *
+ * @param filename Input file, or "-" for standard input
+ * @param estimate Where to store the estimate
+ */
+void estimate_footprint(const char* filename, FootprintEstimate* estimate);
+
+/**
+ * @brief Checks that an input is sorted by arrival time, as the streamed modes need
+ *
+ * Reads the whole input once: the arrival field of each binary record, or
+ * a parse of the CSV that keeps no processes or identifiers and does not
+ * report malformed rows. Standard input cannot be read twice and counts
+ * as unsorted.
+ *
+ * @param filename Input file, or "-" for standard input
+ * @return true if every arrival is at or after the one before it, false if not or unknown
+ */
+bool footprint_input_sorted(const char* filename);
+
+/**
+ * @brief Returns the name of a mode as printed in the budget report
+ * @param mode Mode to name
+ * @return Static string such as "streamed, summary only"
+ */
+const char* footprint_mode_name(FootprintMode mode);
+
+#endif /* FOOTPRINT_H */
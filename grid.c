@@ -0,0 +1,657 @@
+/**
+ * @file grid.c
+ * @brief Implementation of the parameter-grid experiment runner
+ */
+
+#include "grid.h"
+#include "rr.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Bumped whenever a change to the simulators or to the file layout can change cached results */
+#define GRID_CACHE_VERSION 4
+
+/**
+ * @brief Adds a value to a dimension unless it is already there
+ * @param values Values of the dimension
+ * @param count Number of values, updated
+ * @param value Value to add
+ * @return false if the dimension is full
+ */
+static bool add_value(int* values, int* count, int value) {
+    for (int i = 0; i < *count; i++) {
+        if (values[i] == value) {
+            return true;
+        }
+    }
+    if (*count == GRID_MAX_VALUES) {
+        return false;
+    }
+    values[(*count)++] = value;
+    return true;
+}
+
+/**
+ * @brief Parses a comma-separated list of integers and lo:hi ranges
+ * @param text List to parse
+ * @param min Smallest allowed value
+ * @param max Largest allowed value
+ * @param values Where to store the values
+ * @param count Where to store the number of values
+ * @return true if the list is valid, false otherwise
+ */
+static bool parse_values(const char* text, int min, int max, int* values, int* count) {
+    *count = 0;
+    const char* p = text;
+    while (true) {
+        char* end;
+        long lo = strtol(p, &end, 10);
+        long hi = lo;
+        if (end == p) {
+            return false;
+        }
+        if (*end == ':') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+            if (end == p) {
+                return false;
+            }
+        }
+        if (lo < min || hi > max || hi < lo) {
+            return false;
+        }
+        for (long v = lo; v <= hi; v++) {
+            if (!add_value(values, count, (int)v)) {
+                return false;
+            }
+        }
+        if (*end == '\0') {
+            return true;
+        }
+        if (*end != ',') {
+            return false;
+        }
+        p = end + 1;
+    }
+}
+
+/**
+ * @brief Parses a comma-separated list of algorithm names
+ * @param text List to parse; "all" stands for the four classic algorithms
+ * @param grid Grid whose algorithms to set
+ * @return true if every name is known, false otherwise
+ */
+static bool parse_algorithms(const char* text, GridSpec* grid) {
+    grid->algorithm_count = 0;
+    const char* p = text;
+    while (true) {
+        size_t len = strcspn(p, ",");
+        char name[32];
+        if (len == 0 || len >= sizeof(name)) {
+            return false;
+        }
+        memcpy(name, p, len);
+        name[len] = '\0';
+
+        Algorithm algorithm;
+        if (strcmp(name, "all") != 0 && !parse_algorithm(name, &algorithm)) {
+            return false;
+        }
+        for (int a = 0; a < ALG_COUNT; a++) {
+            if (!algorithm_selected(name, (Algorithm)a)) {
+                continue;
+            }
+            bool present = false;
+            for (int i = 0; i < grid->algorithm_count; i++) {
+                present = present || grid->algorithms[i] == (Algorithm)a;
+            }
+            if (!present) {
+                grid->algorithms[grid->algorithm_count++] = (Algorithm)a;
+            }
+        }
+
+        if (p[len] == '\0') {
+            return true;
+        }
+        p += len + 1;
+    }
+}
+
+/**
+ * @brief Parses a grid specification
+ * @param spec Specification to parse
+ * @param default_quantum Quantum used when the specification has no q dimension
+ * @param grid Where to store the grid
+ * @return true if the specification is valid, false otherwise
+ */
+bool parse_grid_spec(const char* spec, int default_quantum, GridSpec* grid) {
+    memset(grid, 0, sizeof(*grid));
+    parse_algorithms("all", grid);
+    grid->quanta[0] = default_quantum;
+    grid->quantum_count = 1;
+    grid->switch_cost_count = 1;
+    grid->cores[0] = 1;
+    grid->core_count = 1;
+
+    size_t length = strlen(spec);
+    char* copy = (char*)malloc(length + 1);
+    if (!copy) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    memcpy(copy, spec, length + 1);
+
+    bool ok = true;
+    char* save = NULL;
+    for (char* dim = strtok_r(copy, ";", &save); dim && ok; dim = strtok_r(NULL, ";", &save)) {
+        char* values = strchr(dim, '=');
+        if (!values) {
+            ok = false;
+            break;
+        }
+        *values++ = '\0';
+
+        if (strcmp(dim, "alg") == 0 || strcmp(dim, "algorithm") == 0) {
+            ok = parse_algorithms(values, grid);
+        } else if (strcmp(dim, "q") == 0 || strcmp(dim, "quantum") == 0) {
+            ok = parse_values(values, 1, INT32_MAX, grid->quanta, &grid->quantum_count);
+        } else if (strcmp(dim, "cost") == 0 || strcmp(dim, "switch-cost") == 0) {
+            ok = parse_values(values, 0, INT32_MAX, grid->switch_costs, &grid->switch_cost_count);
+        } else if (strcmp(dim, "cores") == 0) {
+            ok = parse_values(values, 1, GRID_MAX_CORES, grid->cores, &grid->core_count);
+        } else {
+            ok = false;
+        }
+    }
+    free(copy);
+    return ok;
+}
+
+/**
+ * @brief Continues a 64-bit FNV-1a hash over a block of bytes
+ * @param hash Hash so far
+ * @param data Bytes to add
+ * @param size Number of bytes
+ * @return Updated hash
+ */
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hashes the fields of a workload that affect a schedule
+ *
+ * Names and partition keys are left out, so renaming processes keeps
+ * their cached results. Input order is included because it breaks ties
+ * between equal arrival times.
+ *
+ * @param processes Array of processes
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @return Content hash
+ */
+static uint64_t hash_workload(const Process* processes, const ProcessIo* io, int n) {
+    uint64_t hash = hash_bytes(14695981039346656037ull, &n, sizeof(n));
+    for (int i = 0; i < n; i++) {
+        int fields[5] = {processes[i].arrival_time, processes[i].burst_time, processes[i].priority,
+                         io ? io[i].interval : 0, io ? io[i].time : 0};
+        hash = hash_bytes(hash, fields, sizeof(fields));
+    }
+    return hash;
+}
+
+/**
+ * @brief Shared state of the threads running a grid
+ */
+typedef struct {
+    const Process* processes; /**< Workload */
+    const ProcessIo* io;      /**< I/O of each process, or NULL */
+    int n;                    /**< Number of processes */
+    GridResult* result;       /**< Cells to fill in */
+    const char* cache_dir;    /**< Cache directory, or NULL */
+    pthread_mutex_t lock;     /**< Protects next and failed */
+    int next;                 /**< Next cell to claim */
+    bool failed;              /**< Whether any cell failed */
+} GridRun;
+
+/**
+ * @brief Writes the cache header line identifying a cell
+ * @param cell Cell to describe
+ * @param workload_hash Content hash of the workload
+ * @param line Where to write the line
+ * @param size Size of line
+ */
+static void cell_header(const GridCell* cell, uint64_t workload_hash, char* line, size_t size) {
+    snprintf(line, size, "grid-cell %d %016llx %s %d %d %d %d\n", GRID_CACHE_VERSION,
+             (unsigned long long)workload_hash, algorithm_key(cell->params.algorithm), cell->params.time_quantum,
+             cell->switch_cost, cell->cores, starvation_threshold());
+}
+
+/**
+ * @brief Builds the cache file name of a cell
+ * @param run Grid run
+ * @param cell Cell to name
+ * @param path Where to write the path
+ * @param size Size of path
+ */
+static void cell_path(const GridRun* run, const GridCell* cell, char* path, size_t size) {
+    char header[128];
+    cell_header(cell, run->result->workload_hash, header, sizeof(header));
+    uint64_t key = hash_bytes(14695981039346656037ull, header, strlen(header));
+    snprintf(path, size, "%s/%016llx.cell", run->cache_dir, (unsigned long long)key);
+}
+
+/**
+ * @brief Reads a cell's result from the cache
+ * @param run Grid run
+ * @param cell Cell to fill in
+ * @return true on a hit, false if the cell is missing or the file belongs to another cell
+ */
+static bool load_cell(const GridRun* run, GridCell* cell) {
+    char path[4096];
+    cell_path(run, cell, path, sizeof(path));
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char expected[128];
+    char header[128];
+    cell_header(cell, run->result->workload_hash, expected, sizeof(expected));
+    long long count, turnaround, waiting, response, switches, starved, queue_area, busy_time, span;
+    Metrics totals = {0};
+    bool hit = fgets(header, sizeof(header), file) && strcmp(header, expected) == 0 &&
+               fscanf(file, "%lld %lld %lld %lld %lld %lld %la %la ", &count, &turnaround, &waiting, &response,
+                      &switches, &starved, &totals.total_slowdown, &totals.total_slowdown_sq) == 8 &&
+               fscanf(file, "%lld %lld %lld %d %d ", &queue_area, &busy_time, &span, &totals.max_queue,
+                      &totals.cpus) == 5 &&
+               count == run->n && histogram_read(&totals.turnaround, file) &&
+               histogram_read(&totals.waiting, file) && histogram_read(&totals.response, file) &&
+               histogram_read(&totals.slowdown, file);
+    fclose(file);
+    if (!hit) {
+        return false;
+    }
+
+    totals.count = count;
+    totals.total_turnaround = turnaround;
+    totals.total_waiting = waiting;
+    totals.total_response = response;
+    totals.starved = starved;
+    totals.queue_area = queue_area;
+    totals.busy_time = busy_time;
+    totals.span = span;
+    Metrics none = {0};
+    cell->metrics = merge_metrics(totals, none);
+    cell->context_switches = switches;
+    cell->cached = true;
+    return true;
+}
+
+/**
+ * @brief Writes a cell's result to the cache
+ *
+ * The file is written under a temporary name and renamed into place, so
+ * concurrent runs sharing the directory never read a partial file.
+ *
+ * @param run Grid run
+ * @param cell Computed cell
+ * @param index Index of the cell, which keeps temporary names distinct
+ * @return true if the file was written
+ */
+static bool store_cell(const GridRun* run, const GridCell* cell, int index) {
+    char path[4096];
+    char temp[4160];
+    char header[128];
+    cell_path(run, cell, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.%ld.%d.tmp", path, (long)getpid(), index);
+    cell_header(cell, run->result->workload_hash, header, sizeof(header));
+
+    FILE* file = fopen(temp, "w");
+    if (!file) {
+        perror(temp);
+        return false;
+    }
+    fputs(header, file);
+    // Slowdown sums are written in hexadecimal floating point so they read back exactly
+    fprintf(file, "%lld %lld %lld %lld %lld %lld %a %a\n", (long long)cell->metrics.count,
+            (long long)cell->metrics.total_turnaround, (long long)cell->metrics.total_waiting,
+            (long long)cell->metrics.total_response, (long long)cell->context_switches,
+            (long long)cell->metrics.starved, cell->metrics.total_slowdown, cell->metrics.total_slowdown_sq);
+    fprintf(file, "%lld %lld %lld %d %d\n", (long long)cell->metrics.queue_area, (long long)cell->metrics.busy_time,
+            (long long)cell->metrics.span, cell->metrics.max_queue, cell->metrics.cpus);
+    histogram_write(&cell->metrics.turnaround, file);
+    histogram_write(&cell->metrics.waiting, file);
+    histogram_write(&cell->metrics.response, file);
+    histogram_write(&cell->metrics.slowdown, file);
+    bool ok = fclose(file) == 0;
+    if (!ok || rename(temp, path) != 0) {
+        perror(path);
+        remove(temp);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Schedules processes on one core with the cell's algorithm
+ * @param cell Cell whose parameters to use; context_switches is incremented
+ * @param processes Processes of the core (reordered and updated in place)
+ * @param io I/O of each process, or NULL
+ * @param n Number of processes
+ * @return Metrics of the core
+ */
+static Metrics run_core(GridCell* cell, Process* processes, const ProcessIo* io, int n) {
+    if (cell->switch_cost == 0) {
+        return run_schedule(&cell->params, processes, io, n);
+    }
+    RrOptions options = {cell->switch_cost, INT64_MAX, INT64_MAX, 0, INT64_MAX};
+    RrStats stats;
+    Metrics metrics = rr_schedule_with_options(processes, n, cell->params.time_quantum, &options, &stats);
+    cell->context_switches += stats.context_switches;
+    return metrics;
+}
+
+/**
+ * @brief Computes a cell
+ *
+ * With several cores, processes are taken in arrival order and each goes
+ * to the core whose assigned work finishes first, counting from the
+ * arrival; it never migrates. Each core is then scheduled on its own.
+ *
+ * @param run Grid run
+ * @param cell Cell to compute
+ * @param scratch Array of n processes
+ * @param scratch_io Array of n I/O entries, or NULL if the workload has no I/O
+ * @param grouped Array of n processes
+ * @param grouped_io Array of n I/O entries, or NULL if the workload has no I/O
+ * @param core_of Array of n core numbers
+ * @return true on success
+ */
+static bool compute_cell(const GridRun* run, GridCell* cell, Process* scratch, ProcessIo* scratch_io,
+                         Process* grouped, ProcessIo* grouped_io, int* core_of) {
+    int n = run->n;
+    memcpy(scratch, run->processes, n * sizeof(Process));
+    cell->context_switches = 0;
+    if (cell->cores == 1) {
+        cell->metrics = run_core(cell, scratch, run->io, n);
+        return cell->metrics.count == n;
+    }
+
+    int64_t free_at[GRID_MAX_CORES];
+    int sizes[GRID_MAX_CORES + 1];
+    memset(free_at, 0, sizeof(free_at));
+    memset(sizes, 0, sizeof(sizes));
+    if (!sort_by_arrival(scratch, run->io, scratch_io, n)) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        int best = 0;
+        int64_t best_start = INT64_MAX;
+        for (int c = 0; c < cell->cores; c++) {
+            int64_t start = free_at[c] > scratch[i].arrival_time ? free_at[c] : scratch[i].arrival_time;
+            if (start < best_start) {
+                best_start = start;
+                best = c;
+            }
+        }
+        free_at[best] = best_start + scratch[i].burst_time;
+        core_of[i] = best;
+        sizes[best + 1]++;
+    }
+
+    // Counting sort by core, keeping arrival order within a core
+    for (int c = 0; c < cell->cores; c++) {
+        sizes[c + 1] += sizes[c];
+    }
+    int offsets[GRID_MAX_CORES];
+    memcpy(offsets, sizes, cell->cores * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        int j = offsets[core_of[i]]++;
+        grouped[j] = scratch[i];
+        if (grouped_io) {
+            grouped_io[j] = scratch_io[i];
+        }
+    }
+
+    Metrics total = {0};
+    for (int c = 0; c < cell->cores; c++) {
+        int count = sizes[c + 1] - sizes[c];
+        if (count > 0) {
+            const ProcessIo* io = grouped_io ? grouped_io + sizes[c] : NULL;
+            total = merge_metrics(total, run_core(cell, grouped + sizes[c], io, count));
+        }
+    }
+    cell->metrics = total;
+    return total.count == n;
+}
+
+/**
+ * @brief Thread entry point: claims and computes cells until none are left
+ * @param arg Grid run
+ * @return NULL
+ */
+static void* grid_thread(void* arg) {
+    GridRun* run = (GridRun*)arg;
+    int n = run->n;
+    Process* scratch = (Process*)malloc(n * sizeof(Process));
+    Process* grouped = (Process*)malloc(n * sizeof(Process));
+    ProcessIo* scratch_io = run->io ? (ProcessIo*)malloc(n * sizeof(ProcessIo)) : NULL;
+    ProcessIo* grouped_io = run->io ? (ProcessIo*)malloc(n * sizeof(ProcessIo)) : NULL;
+    int* core_of = (int*)malloc(n * sizeof(int));
+    bool ok = scratch && grouped && core_of && (!run->io || (scratch_io && grouped_io));
+    if (!ok) {
+        perror("Memory allocation failed");
+    }
+
+    while (ok) {
+        pthread_mutex_lock(&run->lock);
+        int index = run->failed ? run->result->count : run->next++;
+        pthread_mutex_unlock(&run->lock);
+        if (index >= run->result->count) {
+            break;
+        }
+
+        GridCell* cell = &run->result->cells[index];
+        if (run->cache_dir && load_cell(run, cell)) {
+            continue;
+        }
+        ok = compute_cell(run, cell, scratch, scratch_io, grouped, grouped_io, core_of);
+        if (ok && run->cache_dir) {
+            ok = store_cell(run, cell, index);
+        }
+    }
+
+    if (!ok) {
+        pthread_mutex_lock(&run->lock);
+        run->failed = true;
+        pthread_mutex_unlock(&run->lock);
+    }
+    free(scratch);
+    free(grouped);
+    free(scratch_io);
+    free(grouped_io);
+    free(core_of);
+    return NULL;
+}
+
+/**
+ * @brief Lists the distinct cells of a grid
+ * @param grid Grid to expand
+ * @param has_io Whether the workload has I/O, which switch costs do not model
+ * @param result Where to store the cells
+ * @return true on success, false on memory allocation failure
+ */
+static bool expand_grid(const GridSpec* grid, bool has_io, GridResult* result) {
+    size_t capacity = (size_t)grid->algorithm_count * grid->quantum_count * grid->switch_cost_count *
+                      grid->core_count;
+    result->cells = (GridCell*)calloc(capacity, sizeof(GridCell));
+    if (!result->cells) {
+        perror("Memory allocation failed");
+        return false;
+    }
+
+    for (int a = 0; a < grid->algorithm_count; a++) {
+        Algorithm algorithm = grid->algorithms[a];
+        bool uses_quantum = algorithm == ALG_RR || algorithm == ALG_VRR;
+        bool uses_cost = algorithm == ALG_RR && !has_io;
+        for (int q = 0; q < (uses_quantum ? grid->quantum_count : 1); q++) {
+            for (int s = 0; s < (uses_cost ? grid->switch_cost_count : 1); s++) {
+                for (int c = 0; c < grid->core_count; c++) {
+                    GridCell* cell = &result->cells[result->count++];
+                    cell->params.algorithm = algorithm;
+                    cell->params.time_quantum = uses_quantum ? grid->quanta[q] : 0;
+                    cell->switch_cost = uses_cost ? grid->switch_costs[s] : 0;
+                    cell->cores = grid->cores[c];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs every distinct cell of a grid on parallel threads
+ * @param processes Array of processes (not modified)
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param grid Grid to run
+ * @param options Worker count and cache directory
+ * @param result Where to store the results; release with free_grid_result
+ * @return 0 on success, -1 on failure
+ */
+int grid_run(const Process* processes, const ProcessIo* io, int n, const GridSpec* grid,
+             const GridOptions* options, GridResult* result) {
+    memset(result, 0, sizeof(*result));
+    bool has_io = false;
+    for (int i = 0; io && i < n; i++) {
+        has_io = has_io || io[i].interval > 0;
+    }
+    if (n <= 0 || !expand_grid(grid, has_io, result)) {
+        return -1;
+    }
+    result->workload_hash = hash_workload(processes, io, n);
+
+    if (options->cache_dir && mkdir(options->cache_dir, 0777) != 0 && errno != EEXIST) {
+        perror(options->cache_dir);
+        free_grid_result(result);
+        return -1;
+    }
+
+    GridRun run;
+    memset(&run, 0, sizeof(run));
+    run.processes = processes;
+    run.io = io;
+    run.n = n;
+    run.result = result;
+    run.cache_dir = options->cache_dir;
+    pthread_mutex_init(&run.lock, NULL);
+    int worker_count = options->workers > 0 ? options->workers : online_cpu_count();
+    if (worker_count > result->count) {
+        worker_count = result->count;
+    }
+    pthread_t* threads = (pthread_t*)malloc(worker_count * sizeof(pthread_t));
+    bool* spawned = (bool*)calloc(worker_count, sizeof(bool));
+    if (!threads || !spawned) {
+        perror("Memory allocation failed");
+        free(threads);
+        free(spawned);
+        free_grid_result(result);
+        return -1;
+    }
+
+    // The calling thread works too, and covers for threads that could not be created
+    for (int w = 1; w < worker_count; w++) {
+        spawned[w] = pthread_create(&threads[w], NULL, grid_thread, &run) == 0;
+    }
+    grid_thread(&run);
+    for (int w = 1; w < worker_count; w++) {
+        if (spawned[w]) {
+            pthread_join(threads[w], NULL);
+        }
+    }
+    free(threads);
+    free(spawned);
+    pthread_mutex_destroy(&run.lock);
+
+    if (run.failed) {
+        fprintf(stderr, "Error: Grid run failed\n");
+        free_grid_result(result);
+        return -1;
+    }
+    result->workers = worker_count;
+    for (int i = 0; i < result->count; i++) {
+        result->cached += result->cells[i].cached;
+    }
+    return 0;
+}
+
+/**
+ * @brief Prints one row per cell and the best cell for each metric
+ * @param result Results of grid_run
+ */
+void print_grid_result(const GridResult* result) {
+    printf("\nParameter grid (workload %016llx):\n", (unsigned long long)result->workload_hash);
+    printf("%-11s %-8s %-7s %-6s %-12s %-12s %-12s %-10s %-6s\n", "Algorithm", "Quantum", "Switch", "Cores",
+           "Avg TAT", "Avg WT", "Avg RT", "Switches", "Source");
+    printf("----------------------------------------------------------------------------------\n");
+
+    int best[3] = {0, 0, 0};
+    for (int i = 0; i < result->count; i++) {
+        const GridCell* cell = &result->cells[i];
+        char quantum[16] = "-";
+        char cost[16] = "-";
+        char switches[24] = "-";
+        if (cell->params.time_quantum > 0) {
+            snprintf(quantum, sizeof(quantum), "%d", cell->params.time_quantum);
+        }
+        if (cell->switch_cost > 0) {
+            snprintf(cost, sizeof(cost), "%d", cell->switch_cost);
+            snprintf(switches, sizeof(switches), "%lld", (long long)cell->context_switches);
+        }
+        printf("%-11s %-8s %-7s %-6d %-12.2f %-12.2f %-12.2f %-10s %-6s\n", algorithm_key(cell->params.algorithm),
+               quantum, cost, cell->cores, cell->metrics.avg_turnaround_time, cell->metrics.avg_waiting_time,
+               cell->metrics.avg_response_time, switches, cell->cached ? "cache" : "run");
+
+        const Metrics* m = &cell->metrics;
+        const Metrics* b0 = &result->cells[best[0]].metrics;
+        const Metrics* b1 = &result->cells[best[1]].metrics;
+        const Metrics* b2 = &result->cells[best[2]].metrics;
+        if (m->total_turnaround < b0->total_turnaround) best[0] = i;
+        if (m->total_waiting < b1->total_waiting) best[1] = i;
+        if (m->total_response < b2->total_response) best[2] = i;
+    }
+    printf("----------------------------------------------------------------------------------\n");
+
+    static const char* const labels[3] = {"turnaround", "waiting", "response"};
+    for (int k = 0; k < 3; k++) {
+        const GridCell* cell = &result->cells[best[k]];
+        printf("Lowest average %s time: %s", labels[k], algorithm_title(cell->params.algorithm));
+        if (cell->params.time_quantum > 0) {
+            printf(", quantum %d", cell->params.time_quantum);
+        }
+        if (cell->switch_cost > 0) {
+            printf(", switch cost %d", cell->switch_cost);
+        }
+        printf(", %d core%s\n", cell->cores, cell->cores == 1 ? "" : "s");
+    }
+    printf("%d cells: %d computed, %d from cache, on %d thread%s\n", result->count,
+           result->count - result->cached, result->cached, result->workers, result->workers == 1 ? "" : "s");
+}
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_grid_result(GridResult* result) {
+    free(result->cells);
+    memset(result, 0, sizeof(*result));
+}
@@ -0,0 +1,119 @@
+/**
+ * @file grid.h
+ * @brief Parameter-grid experiment runner with an on-disk result cache
+ */
+
+#ifndef GRID_H
+#define GRID_H
+
+#include "common.h"
+#include "sched.h"
+
+/** Largest number of values one grid dimension can take */
+#define GRID_MAX_VALUES 256
+
+/** Largest core count a grid cell can simulate */
+#define GRID_MAX_CORES 1024
+
+/**
+ * @struct GridSpec
+ * @brief Values of each dimension; the grid is their cross product
+ */
+typedef struct {
+    Algorithm algorithms[ALG_COUNT];      /**< Algorithms to run */
+    int algorithm_count;                  /**< Number of algorithms */
+    int quanta[GRID_MAX_VALUES];          /**< Time quanta, for algorithms that take one */
+    int quantum_count;                    /**< Number of quanta */
+    int switch_costs[GRID_MAX_VALUES];    /**< Context switch costs, for Round Robin */
+    int switch_cost_count;                /**< Number of switch costs */
+    int cores[GRID_MAX_VALUES];           /**< Core counts */
+    int core_count;                       /**< Number of core counts */
+} GridSpec;
+
+/**
+ * @struct GridOptions
+ * @brief How grid cells are run and cached
+ */
+typedef struct {
+    int workers;           /**< Threads running cells (0 = one per online CPU) */
+    const char* cache_dir; /**< Directory of cached cells, or NULL to always compute */
+} GridOptions;
+
+/**
+ * @struct GridCell
+ * @brief One combination of parameters and its result
+ *
+ * Parameters an algorithm does not use are stored as 0, so for example
+ * FCFS appears once per core count however many quanta the grid has.
+ */
+typedef struct {
+    SchedParams params;       /**< Algorithm and quantum */
+    int switch_cost;          /**< Context switch cost */
+    int cores;                /**< Number of cores */
+    Metrics metrics;          /**< Metrics over all cores */
+    int64_t context_switches; /**< Context switches, counted for Round Robin with a switch cost */
+    bool cached;              /**< Whether the result came from the cache */
+} GridCell;
+
+/**
+ * @struct GridResult
+ * @brief Results of a grid run
+ */
+typedef struct {
+    GridCell* cells;        /**< Distinct cells, in grid order */
+    int count;              /**< Number of cells */
+    int cached;             /**< Cells read from the cache */
+    int workers;            /**< Threads actually used */
+    uint64_t workload_hash; /**< Content hash of the workload */
+} GridResult;
+
+/**
+ * @brief Parses a grid specification
+ *
+ * The specification is a ';'-separated list of dimensions such as
+ * "alg=fcfs,rr;q=1:8;cost=0,1;cores=1,2,4". Values are comma-separated,
+ * and an integer range lo:hi stands for every value in it. Dimensions
+ * left out take their defaults: the four classic algorithms, the given
+ * quantum, no switch cost and one core.
+ *
+ * @param spec Specification to parse
+ * @param default_quantum Quantum used when the specification has no q dimension
+ * @param grid Where to store the grid
+ * @return true if the specification is valid, false otherwise
+ */
+bool parse_grid_spec(const char* spec, int default_quantum, GridSpec* grid);
+
+/**
+ * @brief Runs every distinct cell of a grid on parallel threads
+ *
+ * A cell with several cores assigns each arrival to the core that would
+ * become free first, and each core then runs the algorithm on its own
+ * processes. Each result is stored in the cache directory under a hash of
+ * the workload's contents and the cell's parameters, so a later run over
+ * the same workload, including one with a larger grid, only computes the
+ * cells it has not seen.
+ *
+ * @param processes Array of processes (not modified)
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param grid Grid to run
+ * @param options Worker count and cache directory
+ * @param result Where to store the results; release with free_grid_result
+ * @return 0 on success, -1 on failure
+ */
+int grid_run(const Process* processes, const ProcessIo* io, int n, const GridSpec* grid,
+             const GridOptions* options, GridResult* result);
+
+/**
+ * @brief Prints one row per cell and the best cell for each metric
+ * @param result Results of grid_run
+ */
+void print_grid_result(const GridResult* result);
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_grid_result(GridResult* result);
+
+#endif /* GRID_H */
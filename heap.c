@@ -0,0 +1,122 @@
+/**
+ * @file heap.c
+ * @brief Implementation of the binary min-heap
+ */
+
+#include "heap.h"
+#include "footprint.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Initializes an empty heap
+ * @param heap Heap to initialize
+ * @param capacity Initial capacity (grows as needed)
+ * @return true if successful, false if memory allocation failed
+ */
+bool heap_init(Heap* heap, int capacity) {
+    heap->size = 0;
+    heap->capacity = capacity > 0 ? capacity : 16;
+    heap->keys = (int64_t*)malloc(heap->capacity * sizeof(int64_t));
+    if (!heap->keys) {
+        perror("Memory allocation failed");
+        heap->capacity = 0;
+        return false;
+    }
+    footprint_charge(SUBSYSTEM_QUEUES, heap->capacity * sizeof(int64_t));
+    return true;
+}
+
+/**
+ * @brief Adds a key
+ * @param heap Heap to add to
+ * @param key Key to add
+ * @return true if successful, false if memory allocation failed
+ */
+bool heap_push(Heap* heap, int64_t key) {
+    if (heap->size == heap->capacity) {
+        int capacity = heap->capacity ? heap->capacity * 2 : 16;
+        int64_t* keys = (int64_t*)realloc(heap->keys, capacity * sizeof(int64_t));
+        if (!keys) {
+            perror("Memory allocation failed");
+            return false;
+        }
+        footprint_charge(SUBSYSTEM_QUEUES, (size_t)(capacity - heap->capacity) * sizeof(int64_t));
+        heap->keys = keys;
+        heap->capacity = capacity;
+    }
+
+    // Sift up
+    int i = heap->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->keys[parent] <= key) {
+            break;
+        }
+        heap->keys[i] = heap->keys[parent];
+        i = parent;
+    }
+    heap->keys[i] = key;
+    return true;
+}
+
+/**
+ * @brief Moves a key down from a position until both children are larger
+ * @param heap Heap to repair
+ * @param i Position whose key may be out of order
+ * @param key Key to place
+ */
+static void sift_down(Heap* heap, int i, int64_t key) {
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heap->keys[child + 1] < heap->keys[child]) {
+            child++;
+        }
+        if (key <= heap->keys[child]) {
+            break;
+        }
+        heap->keys[i] = heap->keys[child];
+        i = child;
+    }
+    heap->keys[i] = key;
+}
+
+/**
+ * @brief Removes and returns the smallest key
+ * @param heap Non-empty heap
+ * @return Smallest key
+ */
+int64_t heap_pop(Heap* heap) {
+    int64_t top = heap->keys[0];
+    int64_t last = heap->keys[--heap->size];
+    if (heap->size > 0) {
+        sift_down(heap, 0, last);
+    }
+    return top;
+}
+
+/**
+ * @brief Restores heap order after the caller edited keys and size directly
+ * @param heap Heap to rebuild
+ */
+void heap_rebuild(Heap* heap) {
+    for (int i = heap->size / 2 - 1; i >= 0; i--) {
+        sift_down(heap, i, heap->keys[i]);
+    }
+}
+
+/**
+ * @brief Releases the memory held by a heap
+ * @param heap Heap to free
+ */
+void heap_free(Heap* heap) {
+    footprint_release(SUBSYSTEM_QUEUES, heap->capacity * sizeof(int64_t));
+    free(heap->keys);
+    heap->keys = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+}
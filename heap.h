@@ -0,0 +1,73 @@
+/**
+ * @file heap.h
+ * @brief Binary min-heap of 64-bit keys
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @struct Heap
+ * @brief Array-backed binary min-heap
+ *
+ * Callers that need a payload pack it into the low bits of the key, for
+ * example (time << 32) | index, which also makes every key unique.
+ */
+typedef struct {
+    int64_t* keys; /**< Heap-ordered keys */
+    int size;      /**< Number of keys */
+    int capacity;  /**< Allocated number of keys */
+} Heap;
+
+/**
+ * @brief Initializes an empty heap
+ * @param heap Heap to initialize
+ * @param capacity Initial capacity (grows as needed)
+ * @return true if successful, false if memory allocation failed
+ */
+bool heap_init(Heap* heap, int capacity);
+
+/**
+ * @brief Adds a key
+ * @param heap Heap to add to
+ * @param key Key to add
+ * @return true if successful, false if memory allocation failed
+ */
+bool heap_push(Heap* heap, int64_t key);
+
+/**
+ * @brief Removes and returns the smallest key
+ * @param heap Non-empty heap
+ * @return Smallest key
+ */
+int64_t heap_pop(Heap* heap);
+
+/**
+ * @brief Restores heap order after the caller edited keys and size directly
+ *
+ * Used to drop stale keys in bulk: filter the array in place, set size,
+ * then rebuild in O(n).
+ *
+ * @param heap Heap to rebuild
+ */
+void heap_rebuild(Heap* heap);
+
+/**
+ * @brief Releases the memory held by a heap
+ * @param heap Heap to free
+ */
+void heap_free(Heap* heap);
+
+/**
+ * @brief Returns the smallest key without removing it
+ * @param heap Non-empty heap
+ * @return Smallest key
+ */
+static inline int64_t heap_top(const Heap* heap) {
+    return heap->keys[0];
+}
+
+#endif /* HEAP_H */
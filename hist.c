@@ -0,0 +1,152 @@
+/**
+ * @file hist.c
+ * @brief Implementation of log-linear latency histograms
+ */
+
+#include "hist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Returns the smallest value that falls in a bucket
+ * @param index Bucket index
+ * @return Lower bound of the bucket
+ */
+int histogram_bucket_low(int index) {
+    if (index < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    int mantissa = index - shift * HISTOGRAM_SUB_BUCKETS;
+    return mantissa << shift;
+}
+
+/**
+ * @brief Returns the largest value that falls in a bucket
+ * @param index Bucket index
+ * @return Upper bound of the bucket
+ */
+int histogram_bucket_high(int index) {
+    if (index < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    return (int)((int64_t)histogram_bucket_low(index) + (1LL << shift) - 1);
+}
+
+/**
+ * @brief Adds the values of another histogram
+ * @param histogram Histogram to update
+ * @param other Histogram of a disjoint set of values
+ */
+void histogram_merge(Histogram* histogram, const Histogram* other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (histogram->count == 0 || other->min < histogram->min) histogram->min = other->min;
+    if (histogram->count == 0 || other->max > histogram->max) histogram->max = other->max;
+    histogram->count += other->count;
+
+    // A bucket saturates rather than wrapping if merged runs exceed 2^32 values
+    for (int k = 0; k < HISTOGRAM_BUCKETS; k++) {
+        uint32_t sum = histogram->buckets[k] + other->buckets[k];
+        histogram->buckets[k] = sum < other->buckets[k] ? UINT32_MAX : sum;
+    }
+}
+
+/**
+ * @brief Returns a percentile of the recorded values
+ * @param histogram Histogram to query
+ * @param percentile Percentile in [0, 100]
+ * @return Value at the percentile, or 0 if the histogram is empty
+ */
+int histogram_percentile(const Histogram* histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // Nearest-rank definition: the smallest value with at least p% of values at or below it
+    int64_t rank = (int64_t)(percentile / 100.0 * (double)histogram->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    int64_t seen = 0;
+    for (int k = 0; k < HISTOGRAM_BUCKETS; k++) {
+        seen += histogram->buckets[k];
+        if (seen >= rank) {
+            int value = histogram_bucket_high(k);
+            if (value > histogram->max) value = histogram->max;
+            if (value < histogram->min) value = histogram->min;
+            return value;
+        }
+    }
+    return histogram->max;
+}
+
+/**
+ * @brief Writes a histogram as one line of text
+ * @param histogram Histogram to write
+ * @param file Stream to write to
+ */
+void histogram_write(const Histogram* histogram, FILE* file) {
+    fprintf(file, "%lld %d %d", (long long)histogram->count, histogram->min, histogram->max);
+    for (int k = 0; k < HISTOGRAM_BUCKETS; k++) {
+        if (histogram->buckets[k] > 0) {
+            fprintf(file, " %d:%lu", histogram_bucket_low(k), (unsigned long)histogram->buckets[k]);
+        }
+    }
+    fputc('\n', file);
+}
+
+/**
+ * @brief Reads a histogram written by histogram_write
+ * @param histogram Where to store the histogram
+ * @param file Stream positioned at the line
+ * @return true if a consistent histogram was read, false otherwise
+ */
+bool histogram_read(Histogram* histogram, FILE* file) {
+    char* line = NULL;
+    size_t capacity = 0;
+    if (getline(&line, &capacity, file) < 0) {
+        free(line);
+        return false;
+    }
+
+    memset(histogram, 0, sizeof(*histogram));
+    char* cursor = line;
+    char* end;
+    long long count = strtoll(cursor, &end, 10);
+    bool ok = end != cursor && count >= 0;
+    cursor = end;
+    histogram->min = (int)strtol(cursor, &end, 10);
+    ok = ok && end != cursor;
+    cursor = end;
+    histogram->max = (int)strtol(cursor, &end, 10);
+    ok = ok && end != cursor;
+    cursor = end;
+
+    int64_t total = 0;
+    while (ok && *cursor == ' ') {
+        long low = strtol(cursor, &end, 10);
+        if (end == cursor || *end != ':' || low < 0 || low > INT32_MAX) {
+            ok = false;
+            break;
+        }
+        cursor = end + 1;
+        unsigned long bucket_count = strtoul(cursor, &end, 10);
+        if (end == cursor || bucket_count > UINT32_MAX) {
+            ok = false;
+            break;
+        }
+        cursor = end;
+        int index = histogram_index((int)low);
+        ok = histogram_bucket_low(index) == (int)low;
+        histogram->buckets[index] += (uint32_t)bucket_count;
+        total += (int64_t)bucket_count;
+    }
+    ok = ok && (*cursor == '\n' || *cursor == '\0') && total == count;
+    histogram->count = count;
+    free(line);
+    return ok;
+}
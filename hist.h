@@ -0,0 +1,120 @@
+/**
+ * @file hist.h
+ * @brief Log-linear latency histograms with fixed memory and bounded relative error
+ */
+
+#ifndef HIST_H
+#define HIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Bits of each value kept below its leading bit */
+#define HISTOGRAM_SUB_BITS 4
+
+/** Buckets per power of two */
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+/** Buckets covering every non-negative int */
+#define HISTOGRAM_BUCKETS ((32 - HISTOGRAM_SUB_BITS) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * @struct Histogram
+ * @brief Counts of values in log-linear buckets (HDR style)
+ *
+ * Values below 2 * HISTOGRAM_SUB_BUCKETS have a bucket each. Above that,
+ * every power-of-two range [2^e, 2^(e+1)) is split into
+ * HISTOGRAM_SUB_BUCKETS equal buckets, so a bucket is never wider than
+ * 1/16 of the values it holds and any percentile is reported within that
+ * relative error. Negative values are counted as 0.
+ */
+typedef struct {
+    int64_t count;                       /**< Number of values recorded */
+    int min;                             /**< Smallest value (exact) */
+    int max;                             /**< Largest value (exact) */
+    uint32_t buckets[HISTOGRAM_BUCKETS]; /**< Number of values in each bucket */
+} Histogram;
+
+/**
+ * @brief Returns the bucket of a value
+ * @param value Non-negative value
+ * @return Bucket index in [0, HISTOGRAM_BUCKETS)
+ */
+static inline int histogram_index(int value) {
+    if (value < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return value;
+    }
+    int exponent = 31 - __builtin_clz((unsigned)value);
+    int shift = exponent - HISTOGRAM_SUB_BITS;
+    return shift * HISTOGRAM_SUB_BUCKETS + (value >> shift);
+}
+
+/**
+ * @brief Records one value in constant time
+ * @param histogram Histogram to update
+ * @param value Value to record; negative values count as 0
+ */
+static inline void histogram_record(Histogram* histogram, int value) {
+    if (value < 0) value = 0;
+    if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+    if (histogram->count == 0 || value > histogram->max) histogram->max = value;
+    histogram->count++;
+    histogram->buckets[histogram_index(value)]++;
+}
+
+/**
+ * @brief Returns the smallest value that falls in a bucket
+ * @param index Bucket index
+ * @return Lower bound of the bucket
+ */
+int histogram_bucket_low(int index);
+
+/**
+ * @brief Returns the largest value that falls in a bucket
+ * @param index Bucket index
+ * @return Upper bound of the bucket
+ */
+int histogram_bucket_high(int index);
+
+/**
+ * @brief Adds the values of another histogram
+ * @param histogram Histogram to update
+ * @param other Histogram of a disjoint set of values
+ */
+void histogram_merge(Histogram* histogram, const Histogram* other);
+
+/**
+ * @brief Returns a percentile of the recorded values
+ *
+ * The result is the upper bound of the bucket holding the value of that
+ * rank, clamped to the exact minimum and maximum, so it never understates
+ * a tail.
+ *
+ * @param histogram Histogram to query
+ * @param percentile Percentile in [0, 100]
+ * @return Value at the percentile, or 0 if the histogram is empty
+ */
+int histogram_percentile(const Histogram* histogram, double percentile);
+
+/**
+ * @brief Writes a histogram as one line of text
+ *
+ * The line is "count min max" followed by "low:count" for each non-empty
+ * bucket, where low is the bucket's smallest value. It is read back by
+ * histogram_read.
+ *
+ * @param histogram Histogram to write
+ * @param file Stream to write to
+ */
+void histogram_write(const Histogram* histogram, FILE* file);
+
+/**
+ * @brief Reads a histogram written by histogram_write
+ * @param histogram Where to store the histogram
+ * @param file Stream positioned at the line
+ * @return true if a consistent histogram was read, false otherwise
+ */
+bool histogram_read(Histogram* histogram, FILE* file);
+
+#endif /* HIST_H */
@@ -0,0 +1,141 @@
+/**
+ * @file hugemem.c
+ * @brief Implementation of huge-page array allocation
+ */
+
+/* MADV_HUGEPAGE is a Linux extension */
+#define _GNU_SOURCE
+
+#include "hugemem.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/** Whether large arrays are placed on huge pages */
+static bool huge_pages = true;
+
+/**
+ * @brief Enables or disables huge pages for later allocations
+ * @param enabled false to allocate every array with plain malloc (default: true)
+ */
+void set_huge_pages(bool enabled) {
+    huge_pages = enabled;
+}
+
+/**
+ * @brief Allocates an array, on huge pages if it is large
+ * @param size Size in bytes
+ * @return Allocated memory, or NULL on failure
+ */
+void* huge_alloc(size_t size) {
+    if (!huge_pages || size < HUGE_ARRAY_MIN) {
+        return malloc(size);
+    }
+
+    // Whole huge pages, so the advice covers the tail of the array too
+    size_t rounded = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    void* ptr;
+    if (posix_memalign(&ptr, HUGE_PAGE_SIZE, rounded) != 0) {
+        return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    // Advice only: on failure the array simply stays on small pages
+    madvise(ptr, rounded, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+/**
+ * @brief Resizes an array allocated by huge_alloc or malloc
+ * @param ptr Array to resize, or NULL
+ * @param old_size Bytes of ptr in use, copied to the new array
+ * @param size New size in bytes
+ * @return Resized array, or NULL on failure (ptr is then unchanged)
+ */
+void* huge_realloc(void* ptr, size_t old_size, size_t size) {
+    if (!huge_pages || size < HUGE_ARRAY_MIN) {
+        return realloc(ptr, size);
+    }
+
+    void* grown = huge_alloc(size);
+    if (!grown) {
+        return NULL;
+    }
+    if (ptr) {
+        memcpy(grown, ptr, old_size < size ? old_size : size);
+        free(ptr);
+    }
+    return grown;
+}
+
+/**
+ * @brief Reads the system's transparent huge page mode
+ * @param mode Where to store the selected mode, such as "madvise"
+ * @param len Size of mode
+ */
+static void read_thp_mode(char* mode, size_t len) {
+    snprintf(mode, len, "unknown");
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!file) {
+        return;
+    }
+    char line[128];
+    if (fgets(line, sizeof(line), file)) {
+        // The selected mode is the one in brackets, e.g. "always [madvise] never"
+        char* open = strchr(line, '[');
+        char* close = open ? strchr(open, ']') : NULL;
+        if (close) {
+            *close = '\0';
+            snprintf(mode, len, "%s", open + 1);
+        }
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Prints how much of an array the kernel has backed with huge pages
+ * @param label Name of the array
+ * @param ptr Start of the array
+ * @param size Size of the array in bytes
+ */
+void print_huge_page_report(const char* label, const void* ptr, size_t size) {
+    char mode[32];
+    read_thp_mode(mode, sizeof(mode));
+    double mb = size / 1048576.0;
+
+    FILE* file = fopen("/proc/self/smaps", "r");
+    if (!file) {
+        printf("Huge pages: %s %.1f MB, backing unknown (transparent huge pages: %s)\n", label, mb, mode);
+        return;
+    }
+
+    // Mappings are listed by address range, each followed by its counters
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t end = start + size;
+    bool inside = false;
+    unsigned long long huge_kb = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long low;
+        unsigned long high;
+        unsigned long long kb;
+        if (sscanf(line, "%lx-%lx ", &low, &high) == 2 && strchr(line, '-') < strchr(line, ' ')) {
+            inside = low < end && high > start;
+        } else if (inside && sscanf(line, "AnonHugePages: %llu kB", &kb) == 1) {
+            huge_kb += kb;
+        }
+    }
+    fclose(file);
+
+    // An adjacent mapping merged with the array's can only add to the count, so it is capped
+    double huge_mb = huge_kb / 1024.0;
+    if (huge_mb > mb) {
+        huge_mb = mb;
+    }
+    printf("Huge pages: %s %.1f MB, %.1f MB (%.0f%%) on %zu MB pages (transparent huge pages: %s%s)\n", label, mb,
+           huge_mb, mb > 0 ? 100.0 * huge_mb / mb : 0.0, HUGE_PAGE_SIZE >> 20, mode,
+           huge_pages ? "" : ", disabled by --no-huge-pages");
+}
@@ -0,0 +1,68 @@
+/**
+ * @file hugemem.h
+ * @brief Allocation of large arrays on transparent huge pages
+ */
+
+#ifndef HUGEMEM_H
+#define HUGEMEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Size of a huge page on x86-64 and the usual arm64 configuration */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/** Arrays at least this large are placed on huge pages; smaller ones gain little and would waste memory */
+#define HUGE_ARRAY_MIN ((size_t)32 << 20)
+
+/**
+ * @brief Enables or disables huge pages for later allocations
+ * @param enabled false to allocate every array with plain malloc (default: true)
+ */
+void set_huge_pages(bool enabled);
+
+/**
+ * @brief Allocates an array, on huge pages if it is large
+ *
+ * Arrays of at least HUGE_ARRAY_MIN bytes are aligned to HUGE_PAGE_SIZE
+ * with posix_memalign and advised with MADV_HUGEPAGE before they are
+ * touched, so the kernel can back them with 2 MB pages from the first
+ * fault. Scans over 100M processes then need a few thousand TLB entries
+ * instead of millions. The memory comes from the C allocator either way
+ * and is released with free(). Whether huge pages are actually used is up
+ * to the kernel; see print_huge_page_report.
+ *
+ * @param size Size in bytes
+ * @return Allocated memory, or NULL on failure
+ */
+void* huge_alloc(size_t size);
+
+/**
+ * @brief Resizes an array allocated by huge_alloc or malloc
+ *
+ * Below HUGE_ARRAY_MIN this is realloc. Above it a new huge-page array is
+ * allocated and the contents copied, since realloc would move the old
+ * small pages into the larger block.
+ *
+ * @param ptr Array to resize, or NULL
+ * @param old_size Bytes of ptr in use, copied to the new array
+ * @param size New size in bytes
+ * @return Resized array, or NULL on failure (ptr is then unchanged)
+ */
+void* huge_realloc(void* ptr, size_t old_size, size_t size);
+
+/**
+ * @brief Prints how much of an array the kernel has backed with huge pages
+ *
+ * The figure is read from the AnonHugePages lines of /proc/self/smaps for
+ * the mappings holding the array, so it reflects what was obtained rather
+ * than what was asked for, together with the system's transparent huge
+ * page setting.
+ *
+ * @param label Name of the array
+ * @param ptr Start of the array
+ * @param size Size of the array in bytes
+ */
+void print_huge_page_report(const char* label, const void* ptr, size_t size);
+
+#endif /* HUGEMEM_H */
@@ -0,0 +1,230 @@
+/**
+ * @file intern.c
+ * @brief Implementation of string interning for process identifiers
+ */
+
+#include "intern.h"
+#include "footprint.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Computes the 32-bit FNV-1a hash of a string
+ * @param str String to hash
+ * @param len Length of the string in bytes
+ * @return Hash value
+ */
+static uint32_t hash_string(const char* str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    // FNV leaves the low bits poorly mixed for short sequential keys
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+/**
+ * @brief Initializes an empty table
+ * @param table Table to initialize
+ */
+void id_table_init(IdTable* table) {
+    memset(table, 0, sizeof(*table));
+}
+
+/**
+ * @brief Doubles the number of hash slots and reinserts every entry
+ * @param table Table to grow
+ * @return true if successful, false if memory allocation failed
+ */
+static bool grow_slots(IdTable* table) {
+    uint32_t old_count = table->slots ? table->slot_mask + 1 : 0;
+    uint32_t slot_count = old_count ? old_count * 2 : 64;
+    uint64_t* slots = (uint64_t*)calloc(slot_count, sizeof(uint64_t));
+    if (!slots) {
+        perror("Memory allocation failed");
+        return false;
+    }
+
+    // Entries carry their hash, so rehashing never touches the arena
+    uint32_t mask = slot_count - 1;
+    for (uint32_t i = 0; i < old_count; i++) {
+        uint64_t entry = table->slots[i];
+        if (entry == 0) {
+            continue;
+        }
+        uint32_t slot = (uint32_t)(entry >> 32) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = entry;
+    }
+
+    footprint_charge(SUBSYSTEM_WORKLOAD, slot_count * sizeof(uint64_t));
+    footprint_release(SUBSYSTEM_WORKLOAD, old_count * sizeof(uint64_t));
+    free(table->slots);
+    table->slots = slots;
+    table->slot_mask = mask;
+    return true;
+}
+
+/**
+ * @brief Makes room for more entries and arena bytes
+ * @param table Table to grow
+ * @param entries Number of entries about to be added
+ * @param bytes Number of arena bytes about to be added
+ * @return true if successful, false if memory allocation failed
+ */
+static bool reserve_space(IdTable* table, uint32_t entries, size_t bytes) {
+    if (entries >= ID_INVALID - table->count) {
+        fprintf(stderr, "Error: Too many distinct process identifiers\n");
+        return false;
+    }
+
+    if (table->count + entries > table->capacity) {
+        uint32_t capacity = table->capacity ? table->capacity : 64;
+        while (table->count + entries > capacity) {
+            capacity = capacity > ID_INVALID / 2 ? ID_INVALID - 1 : capacity * 2;
+        }
+        size_t* offsets = (size_t*)realloc(table->offsets, capacity * sizeof(size_t));
+        if (!offsets) {
+            perror("Memory allocation failed");
+            return false;
+        }
+        footprint_charge(SUBSYSTEM_WORKLOAD, capacity * sizeof(size_t));
+        footprint_release(SUBSYSTEM_WORKLOAD, table->capacity * sizeof(size_t));
+        table->offsets = offsets;
+        table->capacity = capacity;
+    }
+
+    if (table->arena_size + bytes > table->arena_capacity) {
+        size_t capacity = table->arena_capacity ? table->arena_capacity : 1024;
+        while (table->arena_size + bytes > capacity) {
+            capacity *= 2;
+        }
+        char* arena = (char*)realloc(table->arena, capacity);
+        if (!arena) {
+            perror("Memory allocation failed");
+            return false;
+        }
+        footprint_charge(SUBSYSTEM_WORKLOAD, capacity);
+        footprint_release(SUBSYSTEM_WORKLOAD, table->arena_capacity);
+        table->arena = arena;
+        table->arena_capacity = capacity;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the index of a string, adding it to the table if needed
+ * @param table Table to intern into
+ * @param str String to intern (need not be NUL-terminated)
+ * @param len Length of the string in bytes
+ * @return Index of the string, or ID_INVALID if memory allocation failed
+ */
+uint32_t id_table_intern(IdTable* table, const char* str, size_t len) {
+    // Keep the load factor at or below one half
+    if (!table->slots || (table->count + 1) * 2 > table->slot_mask + 1) {
+        if (!grow_slots(table)) {
+            return ID_INVALID;
+        }
+    }
+
+    uint32_t hash = hash_string(str, len);
+    uint32_t slot = hash & table->slot_mask;
+
+    // Look for an existing entry, stopping at the first empty slot
+    while (table->slots[slot] != 0) {
+        uint64_t entry = table->slots[slot];
+        if ((uint32_t)(entry >> 32) == hash) {
+            uint32_t id = (uint32_t)entry - 1;
+            const char* name = table->arena + table->offsets[id];
+            if (strncmp(name, str, len) == 0 && name[len] == '\0') {
+                return id;
+            }
+        }
+        slot = (slot + 1) & table->slot_mask;
+    }
+
+    if (!reserve_space(table, 1, len + 1)) {
+        return ID_INVALID;
+    }
+
+    // Append the string to the arena and claim the empty slot
+    uint32_t id = table->count++;
+    table->offsets[id] = table->arena_size;
+    memcpy(table->arena + table->arena_size, str, len);
+    table->arena[table->arena_size + len] = '\0';
+    table->arena_size += len + 1;
+    table->slots[slot] = ((uint64_t)hash << 32) | (id + 1);
+
+    return id;
+}
+
+/**
+ * @brief Interns every entry of another table
+ * @param table Table to intern into
+ * @param other Table whose entries are interned
+ * @param map Where to store the index in table of each entry of other (other->count entries)
+ * @return true if successful, false if memory allocation failed
+ */
+bool id_table_merge(IdTable* table, const IdTable* other, uint32_t* map) {
+    // Room for every entry up front, as most identifiers usually appear in only one table
+    if (!reserve_space(table, other->count, other->arena_size)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < other->count; i++) {
+        const char* name = other->arena + other->offsets[i];
+        map[i] = id_table_intern(table, name, strlen(name));
+        if (map[i] == ID_INVALID) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the string stored at the given index
+ * @param table Table to look up
+ * @param id Index returned by id_table_intern
+ * @return NUL-terminated string, or "?" if the index is out of range
+ */
+const char* id_table_name(const IdTable* table, uint32_t id) {
+    if (id >= table->count) {
+        return "?";
+    }
+    return table->arena + table->offsets[id];
+}
+
+/**
+ * @brief Forgets every string but keeps the memory for the next ones
+ * @param table Table to empty
+ */
+void id_table_clear(IdTable* table) {
+    if (table->slots) {
+        memset(table->slots, 0, (table->slot_mask + 1) * sizeof(uint64_t));
+    }
+    table->arena_size = 0;
+    table->count = 0;
+}
+
+/**
+ * @brief Releases all memory held by the table and leaves it empty
+ * @param table Table to free
+ */
+void id_table_free(IdTable* table) {
+    footprint_release(SUBSYSTEM_WORKLOAD, table->arena_capacity + table->capacity * sizeof(size_t) +
+                                              (table->slots ? (table->slot_mask + 1) * sizeof(uint64_t) : 0));
+    free(table->arena);
+    free(table->offsets);
+    free(table->slots);
+    id_table_init(table);
+}
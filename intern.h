@@ -0,0 +1,83 @@
+/**
+ * @file intern.h
+ * @brief String interning for process identifiers
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Value returned by id_table_intern when the string could not be stored */
+#define ID_INVALID UINT32_MAX
+
+/**
+ * @struct IdTable
+ * @brief Interned strings stored in a single arena and indexed by a hash table
+ *
+ * Each distinct string is stored once, NUL-terminated, and is identified by a
+ * dense 32-bit index that can be kept in place of the string itself.
+ */
+typedef struct {
+    char* arena;            /**< Concatenated NUL-terminated strings */
+    size_t arena_size;      /**< Bytes used in the arena */
+    size_t arena_capacity;  /**< Bytes allocated for the arena */
+    size_t* offsets;        /**< Arena offset of each interned string */
+    uint32_t count;         /**< Number of interned strings */
+    uint32_t capacity;      /**< Allocated entries in offsets */
+    uint64_t* slots;        /**< Open-addressing table of hash << 32 | (index + 1), 0 = empty */
+    uint32_t slot_mask;     /**< Number of slots minus one (power of two) */
+} IdTable;
+
+/**
+ * @brief Initializes an empty table
+ * @param table Table to initialize
+ */
+void id_table_init(IdTable* table);
+
+/**
+ * @brief Returns the index of a string, adding it to the table if needed
+ * @param table Table to intern into
+ * @param str String to intern (need not be NUL-terminated)
+ * @param len Length of the string in bytes
+ * @return Index of the string, or ID_INVALID if memory allocation failed
+ */
+uint32_t id_table_intern(IdTable* table, const char* str, size_t len);
+
+/**
+ * @brief Interns every entry of another table
+ *
+ * Used to merge the tables of parser threads: an identifier seen by
+ * several of them keeps a single index, and map translates the indices
+ * of other into those of table.
+ *
+ * @param table Table to intern into
+ * @param other Table whose entries are interned
+ * @param map Where to store the index in table of each entry of other (other->count entries)
+ * @return true if successful, false if memory allocation failed
+ */
+bool id_table_merge(IdTable* table, const IdTable* other, uint32_t* map);
+
+/**
+ * @brief Returns the string stored at the given index
+ * @param table Table to look up
+ * @param id Index returned by id_table_intern
+ * @return NUL-terminated string, or "?" if the index is out of range
+ */
+const char* id_table_name(const IdTable* table, uint32_t id);
+
+/**
+ * @brief Forgets every string but keeps the memory for the next ones
+ * @param table Table to empty
+ */
+void id_table_clear(IdTable* table);
+
+/**
+ * @brief Releases all memory held by the table and leaves it empty
+ * @param table Table to free
+ */
+void id_table_free(IdTable* table);
+
+#endif /* INTERN_H */
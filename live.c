@@ -0,0 +1,388 @@
+/**
+ * @file live.c
+ * @brief Implementation of live execution on real threads
+ */
+
+/* CPU affinity is a GNU extension */
+#define _GNU_SOURCE
+
+#include "live.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/** Stack size of the worker threads, which only spin */
+#define LIVE_STACK_SIZE (64 * 1024)
+
+struct LiveRun;
+
+/**
+ * @brief One process running as a thread
+ */
+typedef struct {
+    struct LiveRun* run;   /**< Shared state */
+    int index;             /**< Index of the process */
+    pthread_t thread;      /**< Worker thread */
+    pthread_cond_t go;     /**< Signalled when the worker is granted a slice */
+    int grant;             /**< Time units the worker may run (0 = wait, -1 = exit) */
+    int remaining;         /**< Time units of burst left */
+    double first_start_us; /**< Time the worker first started running, or -1 */
+    double end_us;         /**< Time the last slice ended */
+} LiveWorker;
+
+/**
+ * @brief State shared by the dispatcher and the workers
+ */
+typedef struct LiveRun {
+    pthread_mutex_t lock;   /**< Protects every field below and in the workers */
+    pthread_cond_t done;    /**< Signalled when a worker hands the CPU back */
+    int running;            /**< Worker holding the CPU, or -1 */
+    double slice_start_us;  /**< Time the current slice started */
+    struct timespec origin; /**< Wall-clock time 0 */
+    int time_unit_us;       /**< Microseconds per time unit */
+    LiveWorker* workers;    /**< One worker per process */
+} LiveRun;
+
+/**
+ * @brief Returns the microseconds elapsed since the start of a run
+ * @param run Run in progress
+ * @return Elapsed wall-clock time
+ */
+static double elapsed_us(const LiveRun* run) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - run->origin.tv_sec) * 1e6 + (now.tv_nsec - run->origin.tv_nsec) / 1e3;
+}
+
+/**
+ * @brief Sleeps until a given time of a run
+ * @param run Run in progress
+ * @param at_us Time to wake up, relative to the start of the run
+ */
+static void sleep_until(const LiveRun* run, double at_us) {
+    struct timespec wake = run->origin;
+    long long ns = (long long)(at_us * 1e3);
+    wake.tv_sec += (time_t)(ns / 1000000000LL);
+    wake.tv_nsec += (long)(ns % 1000000000LL);
+    if (wake.tv_nsec >= 1000000000L) {
+        wake.tv_sec++;
+        wake.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) != 0) {
+        // Interrupted by a signal; sleep for the rest of the time
+    }
+}
+
+/**
+ * @brief Body of a worker thread
+ * @param arg Worker
+ * @return NULL
+ */
+static void* worker_thread(void* arg) {
+    LiveWorker* worker = (LiveWorker*)arg;
+    LiveRun* run = worker->run;
+
+    pthread_mutex_lock(&run->lock);
+    for (;;) {
+        while (worker->grant == 0) {
+            pthread_cond_wait(&worker->go, &run->lock);
+        }
+        if (worker->grant < 0) {
+            break;
+        }
+        int slice = worker->grant;
+        pthread_mutex_unlock(&run->lock);
+
+        // Burn the slice on the CPU, as the simulated process would
+        double start = elapsed_us(run);
+        double end = start + (double)slice * run->time_unit_us;
+        double now = start;
+        while (now < end) {
+            now = elapsed_us(run);
+        }
+
+        pthread_mutex_lock(&run->lock);
+        if (worker->first_start_us < 0) {
+            worker->first_start_us = start;
+        }
+        run->slice_start_us = start;
+        worker->end_us = now;
+        worker->remaining -= slice;
+        worker->grant = 0;
+        run->running = -1;
+        pthread_cond_signal(&run->done);
+        if (worker->remaining == 0) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&run->lock);
+    return NULL;
+}
+
+/**
+ * @brief Picks the next process from the ready ring and removes it
+ *
+ * FCFS and RR take the head. SJF and SRTF take the shortest burst or
+ * remaining time, the earliest admitted on ties, and shift the entries
+ * ahead of it back a slot so the rest stay in admission order.
+ *
+ * @param algorithm Policy
+ * @param workers Workers, for their remaining times
+ * @param processes Processes, for their burst times
+ * @param ring Ready ring of capacity n
+ * @param n Ring capacity
+ * @param head Index of the first entry
+ * @param count Number of entries; decremented
+ * @return Index of the chosen process
+ */
+static int pick_next(Algorithm algorithm, const LiveWorker* workers, const Process* processes, int* ring, int n,
+                     int* head, int* count) {
+    int best = 0;
+    if (algorithm == ALG_SJF || algorithm == ALG_SRTF) {
+        for (int i = 1; i < *count; i++) {
+            int candidate = ring[(*head + i) % n];
+            int current = ring[(*head + best) % n];
+            int a = algorithm == ALG_SJF ? processes[candidate].burst_time : workers[candidate].remaining;
+            int b = algorithm == ALG_SJF ? processes[current].burst_time : workers[current].remaining;
+            if (a < b) {
+                best = i;
+            }
+        }
+    }
+
+    // The entries ahead of the chosen one move back a slot, so the ring stays in admission order
+    int chosen = ring[(*head + best) % n];
+    for (int i = best; i > 0; i--) {
+        ring[(*head + i) % n] = ring[(*head + i - 1) % n];
+    }
+    *head = (*head + 1) % n;
+    (*count)--;
+    return chosen;
+}
+
+/**
+ * @brief Runs a policy on real threads, one per process
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes, at most LIVE_MAX_PROCESSES
+ * @param options Time scale and placement
+ * @param report Where to store the measurements; release with free_live_report
+ * @return 0 on success, -1 on failure
+ */
+int live_run(const SchedParams* params, const Process* processes, int n, const LiveOptions* options,
+             LiveReport* report) {
+    memset(report, 0, sizeof(*report));
+    if (n <= 0 || params->algorithm > ALG_RR) {
+        return -1;
+    }
+    if (n > LIVE_MAX_PROCESSES) {
+        fprintf(stderr, "Error: Live mode runs at most %d processes\n", LIVE_MAX_PROCESSES);
+        return -1;
+    }
+
+    Process* live = copy_processes((Process*)processes, n);
+    LiveWorker* workers = (LiveWorker*)calloc(n, sizeof(LiveWorker));
+    int* ring = (int*)malloc(n * sizeof(int));
+    if (!live || !workers || !ring) {
+        if (live) perror("Memory allocation failed");
+        free_process_copy(live, n);
+        free(workers);
+        free(ring);
+        return -1;
+    }
+    qsort(live, n, sizeof(Process), compare_arrival_time);
+
+    LiveRun run;
+    memset(&run, 0, sizeof(run));
+    pthread_mutex_init(&run.lock, NULL);
+    pthread_cond_init(&run.done, NULL);
+    run.running = -1;
+    run.time_unit_us = options->time_unit_us;
+    run.workers = workers;
+
+    // The dispatcher and all workers share one core, as the simulated CPU
+    cpu_set_t saved_mask;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    bool pinned = false;
+    if (options->cpu >= 0) {
+        CPU_SET(options->cpu, &mask);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(saved_mask), &saved_mask) != 0 ||
+            pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+            fprintf(stderr, "Error: Cannot pin to CPU %d\n", options->cpu);
+            free_process_copy(live, n);
+            free(workers);
+            free(ring);
+            return -1;
+        }
+        pinned = true;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, LIVE_STACK_SIZE);
+    if (pinned) {
+        pthread_attr_setaffinity_np(&attr, sizeof(mask), &mask);
+    }
+
+    int created = 0;
+    for (; created < n; created++) {
+        LiveWorker* w = &workers[created];
+        w->run = &run;
+        w->index = created;
+        w->remaining = live[created].burst_time;
+        w->first_start_us = -1;
+        pthread_cond_init(&w->go, NULL);
+        if (pthread_create(&w->thread, &attr, worker_thread, w) != 0) {
+            pthread_cond_destroy(&w->go);
+            fprintf(stderr, "Error: Cannot create thread %d of %d\n", created + 1, n);
+            break;
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    int status = created == n ? 0 : -1;
+    int head = 0;
+    int count = 0;
+    int next_arrival = 0;
+    int completed = 0;
+    double free_since = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &run.origin);
+    pthread_mutex_lock(&run.lock);
+    while (status == 0 && completed < n) {
+        // Admit processes whose arrival time has passed on the wall clock
+        double now = elapsed_us(&run);
+        while (next_arrival < n && (double)live[next_arrival].arrival_time * run.time_unit_us <= now) {
+            ring[(head + count++) % n] = next_arrival++;
+        }
+
+        if (count == 0) {
+            double at = (double)live[next_arrival].arrival_time * run.time_unit_us;
+            pthread_mutex_unlock(&run.lock);
+            sleep_until(&run, at);
+            pthread_mutex_lock(&run.lock);
+            free_since = at;
+            continue;
+        }
+
+        int idx = pick_next(params->algorithm, workers, live, ring, n, &head, &count);
+        LiveWorker* w = &workers[idx];
+        int slice = w->remaining;
+        if (params->algorithm == ALG_RR && params->time_quantum < slice) {
+            slice = params->time_quantum;
+        }
+        if (params->algorithm == ALG_SRTF && next_arrival < n) {
+            // Run until the next arrival, when the choice may change
+            int until = live[next_arrival].arrival_time - (int)(now / run.time_unit_us);
+            if (until < 1) until = 1;
+            if (until < slice) slice = until;
+        }
+
+        double ready_at = free_since;
+        double arrival_us = (double)live[idx].arrival_time * run.time_unit_us;
+        if (arrival_us > ready_at) ready_at = arrival_us;
+
+        w->grant = slice;
+        run.running = idx;
+        pthread_cond_signal(&w->go);
+        while (run.running >= 0) {
+            pthread_cond_wait(&run.done, &run.lock);
+        }
+
+        double latency = run.slice_start_us - ready_at;
+        report->dispatches++;
+        report->total_latency_us += latency;
+        if (latency > report->max_latency_us) report->max_latency_us = latency;
+        free_since = w->end_us;
+
+        if (w->remaining == 0) {
+            completed++;
+        } else {
+            // Arrivals during the slice queue ahead of a preempted process
+            now = elapsed_us(&run);
+            while (next_arrival < n && (double)live[next_arrival].arrival_time * run.time_unit_us <= now) {
+                ring[(head + count++) % n] = next_arrival++;
+            }
+            ring[(head + count++) % n] = idx;
+        }
+    }
+    report->wall_us = elapsed_us(&run);
+
+    // Release any workers still waiting, after a failure
+    for (int i = 0; i < created; i++) {
+        if (workers[i].remaining > 0) {
+            workers[i].grant = -1;
+            pthread_cond_signal(&workers[i].go);
+        }
+    }
+    pthread_mutex_unlock(&run.lock);
+
+    for (int i = 0; i < created; i++) {
+        pthread_join(workers[i].thread, NULL);
+        pthread_cond_destroy(&workers[i].go);
+    }
+    pthread_cond_destroy(&run.done);
+    pthread_mutex_destroy(&run.lock);
+    if (pinned) {
+        pthread_setaffinity_np(pthread_self(), sizeof(saved_mask), &saved_mask);
+    }
+
+    if (status == 0) {
+        // Measured times, rounded to time units so they read like the simulated ones
+        for (int i = 0; i < n; i++) {
+            Process* p = &live[i];
+            double arrival_us = (double)p->arrival_time * run.time_unit_us;
+            p->remaining_time = 0;
+            p->completion_time = p->arrival_time + (int)lround((workers[i].end_us - arrival_us) / run.time_unit_us);
+            p->response_time = (int)lround((workers[i].first_start_us - arrival_us) / run.time_unit_us);
+            p->started = true;
+        }
+        report->measured = calculate_metrics(live, n);
+        report->processes = live;
+        report->n = n;
+        report->time_unit_us = run.time_unit_us;
+    } else {
+        free_process_copy(live, n);
+    }
+
+    free(workers);
+    free(ring);
+    return status;
+}
+
+/**
+ * @brief Prints the measured metrics next to the simulated metrics
+ * @param report Measurements of live_run
+ * @param simulated Metrics of the same policy in the simulator
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_live_report(const LiveReport* report, Metrics simulated, const char* algorithm_name) {
+    printf("\n%s live execution (time unit = %d us):\n", algorithm_name, report->time_unit_us);
+    printf("%-24s %-18s %-18s\n", "", "Simulated", "Measured");
+    printf("----------------------------------------------------------------------------------\n");
+    printf("%-24s %-18.2f %-18.2f\n", "Average Turnaround Time", simulated.avg_turnaround_time,
+           report->measured.avg_turnaround_time);
+    printf("%-24s %-18.2f %-18.2f\n", "Average Waiting Time", simulated.avg_waiting_time,
+           report->measured.avg_waiting_time);
+    printf("%-24s %-18.2f %-18.2f\n", "Average Response Time", simulated.avg_response_time,
+           report->measured.avg_response_time);
+    printf("----------------------------------------------------------------------------------\n");
+
+    double average = report->dispatches > 0 ? report->total_latency_us / report->dispatches : 0.0;
+    double share = report->wall_us > 0 ? 100.0 * report->total_latency_us / report->wall_us : 0.0;
+    printf("Dispatches: %lld, latency avg %.1f us, max %.1f us (%.2f%% of %.0f us wall time)\n",
+           (long long)report->dispatches, average, report->max_latency_us, share, report->wall_us);
+    printf("----------------------------------------------------------------------------------\n");
+}
+
+/**
+ * @brief Releases the memory held by a report
+ * @param report Report to free
+ */
+void free_live_report(LiveReport* report) {
+    free_process_copy(report->processes, report->n);
+    memset(report, 0, sizeof(*report));
+}
@@ -0,0 +1,79 @@
+/**
+ * @file live.h
+ * @brief Execution of scheduling policies on real threads
+ */
+
+#ifndef LIVE_H
+#define LIVE_H
+
+#include "common.h"
+#include "sched.h"
+
+/** Largest number of processes live mode runs, one thread each */
+#define LIVE_MAX_PROCESSES 4096
+
+/**
+ * @struct LiveOptions
+ * @brief Time scale and placement of a live run
+ */
+typedef struct {
+    int time_unit_us; /**< Wall-clock microseconds per unit of burst and arrival time */
+    int cpu;          /**< Core the dispatcher and workers are pinned to, or -1 to leave them unpinned */
+} LiveOptions;
+
+/**
+ * @struct LiveReport
+ * @brief Measurements of a live run
+ */
+typedef struct {
+    Process* processes;      /**< Processes with measured times, in time units, sorted by arrival */
+    int n;                   /**< Number of processes */
+    Metrics measured;        /**< Metrics of the measured times */
+    int64_t dispatches;      /**< Time slices granted to worker threads */
+    double total_latency_us; /**< Sum of the dispatch latencies */
+    double max_latency_us;   /**< Longest dispatch latency */
+    double wall_us;          /**< Wall-clock duration of the run */
+    int time_unit_us;        /**< Time unit used for the run */
+} LiveReport;
+
+/**
+ * @brief Runs a policy on real threads, one per process
+ *
+ * Each process becomes a thread that spins for its burst time, scaled to
+ * microseconds, but only while the dispatcher allows it. The dispatcher
+ * runs on the calling thread. It admits processes when their arrival time
+ * has passed on the wall clock, picks one by the policy and hands it a time
+ * slice through a per-thread condition variable. Then it sleeps until the
+ * thread hands the CPU back. FCFS and SJF grant the whole remaining burst,
+ * SRTF grants time up to the next arrival and RR grants one quantum, so
+ * every run has the same preemption points as the simulator. The measured
+ * turnaround therefore includes thread wake-up and dispatch costs that the
+ * simulator does not model. The dispatch latency of a slice is the time
+ * from the CPU becoming free, or the process arriving if the CPU was idle,
+ * to the chosen thread starting to spin.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes, at most LIVE_MAX_PROCESSES
+ * @param options Time scale and placement
+ * @param report Where to store the measurements; release with free_live_report
+ * @return 0 on success, -1 on failure
+ */
+int live_run(const SchedParams* params, const Process* processes, int n, const LiveOptions* options,
+             LiveReport* report);
+
+/**
+ * @brief Prints the measured metrics next to the simulated metrics
+ * @param report Measurements of live_run
+ * @param simulated Metrics of the same policy in the simulator
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_live_report(const LiveReport* report, Metrics simulated, const char* algorithm_name);
+
+/**
+ * @brief Releases the memory held by a report
+ * @param report Report to free
+ */
+void free_live_report(LiveReport* report);
+
+#endif /* LIVE_H */
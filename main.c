@@ -7,12 +7,65 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <getopt.h>
 #include <unistd.h>
 
 #include "common.h"
+#include "admit.h"
+#include "closed.h"
 #include "fcfs.h"
+#include "footprint.h"
+#include "grid.h"
+#include "hugemem.h"
 #include "sjf.h"
 #include "rr.h"
+#include "live.h"
+#include "net.h"
+#include "online.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "sched.h"
+#include "shard.h"
+#include "tune.h"
+#include "window.h"
+
+/** Upper bound on the number of addresses given to --connect */
+#define MAX_REMOTES 256
+
+/** Values returned by getopt_long for options without a short form */
+enum {
+    OPT_SERVE = 256,
+    OPT_CONNECT,
+    OPT_WRITE_WORKLOAD,
+    OPT_TUNE_QUANTUM,
+    OPT_SWITCH_COST,
+    OPT_QUANTUM_RANGE,
+    OPT_LIVE,
+    OPT_TIME_UNIT,
+    OPT_PIN_CPU,
+    OPT_ONLINE,
+    OPT_MAX_QUEUE,
+    OPT_SHED,
+    OPT_TOKEN_RATE,
+    OPT_CLOSED_LOOP,
+    OPT_THINK_TIME,
+    OPT_GRID,
+    OPT_CACHE_DIR,
+    OPT_PROFILE_WORKLOAD,
+    OPT_PERCENTILES,
+    OPT_EXPORT_HISTOGRAMS,
+    OPT_FAIRNESS,
+    OPT_QUEUE_STATS,
+    OPT_STARVATION_THRESHOLD,
+    OPT_WINDOW,
+    OPT_SERIES_FILE,
+    OPT_PIPELINE,
+    OPT_NO_HUGE_PAGES,
+    OPT_HUGE_PAGE_REPORT,
+    OPT_SUMMARY_ONLY,
+    OPT_MAX_MEMORY,
+    OPT_MEMORY_REPORT
+};
 
 /**
  * @brief Prints usage information
@@ -27,9 +80,491 @@ void print_usage(const char* program_name) {
     printf("                  sjf  - Shortest Job First (non-preemptive)\n");
     printf("                  srtf - Shortest Remaining Time First (preemptive SJF)\n");
     printf("                  rr   - Round Robin\n");
-    printf("                  all  - Run all algorithms (default)\n");
-    printf("  -q <quantum>    Time quantum for Round Robin (default: 2)\n");
-    printf("  -h              Display this help message\n");
+    printf("                  arr-median - Round Robin, quantum = median remaining time\n");
+    printf("                  arr-mean   - Round Robin, quantum = mean remaining time\n");
+    printf("                  vrr  - Virtual Round Robin (favours processes back from I/O)\n");
+    printf("                  all  - Run fcfs, sjf, srtf and rr (default)\n");
+    printf("  -q <quantum>    Time quantum for rr and vrr (default: 2)\n");
+    printf("  -j <threads>    Parser threads for large input files (default: one per CPU)\n");
+    printf("  -S, --shard-by <column>\n");
+    printf("                  Simulate each value of <column> as an independent machine\n");
+    printf("  -w, --workers <n>\n");
+    printf("                  Worker processes for shard mode (default: one per CPU)\n");
+    printf("  -T, --shard-threads\n");
+    printf("                  Run shard workers as threads instead of processes\n");
+    printf("  --connect <host:port>[,<host:port>...]\n");
+    printf("                  Send shards to remote workers instead of forking\n");
+    printf("  --serve <[host:]port>\n");
+    printf("                  Run as a remote worker for --connect (default host: 127.0.0.1)\n");
+    printf("  --profile-workload\n");
+    printf("                  Print load, burst and inter-arrival statistics gathered while\n");
+    printf("                  the input is parsed, and exit\n");
+    printf("  --percentiles   Print p50, p90, p99, p99.9 and max of each time with the averages\n");
+    printf("  --fairness      Print Jain's fairness index, the longest wait and slowdown\n");
+    printf("                  (turnaround / burst) percentiles with the averages\n");
+    printf("  --queue-stats   Print average and peak ready-queue length and CPU utilisation,\n");
+    printf("                  checked against Little's law\n");
+    printf("  --starvation-threshold <time>\n");
+    printf("                  Raise an alarm for processes that wait longer than <time>\n");
+    printf("  --export-histograms <file>\n");
+    printf("                  Append the turnaround, waiting and response histograms of every\n");
+    printf("                  run to <file>, one line each (\"-\" for standard output)\n");
+    printf("  --write-workload <file>\n");
+    printf("                  Convert the input to the binary workload format and exit\n");
+    printf("  --tune-quantum <objective>\n");
+    printf("                  Search for the RR quantum minimising waiting, turnaround,\n");
+    printf("                  response or p99-response\n");
+    printf("  --switch-cost <time>\n");
+    printf("                  Context switch cost charged by --tune-quantum (default: 0)\n");
+    printf("  --quantum-range <min>:<max>\n");
+    printf("                  Quanta searched by --tune-quantum (default: 1 to longest burst)\n");
+    printf("  --live          Run fcfs, sjf, srtf or rr on real threads and measure them\n");
+    printf("  --time-unit <us>\n");
+    printf("                  Wall-clock microseconds per time unit in --live (default: 1000)\n");
+    printf("  --pin-cpu <cpu> Pin the --live dispatcher and threads to one core\n");
+    printf("  --online        Replay the input through the online engine, predicting each\n");
+    printf("                  completion at submission (fcfs, sjf, srtf or rr)\n");
+    printf("  --max-queue <n> Admit at most <n> waiting processes; arrivals beyond it are shed\n");
+    printf("  --shed <policy> Process shed from a full queue: newest (default) or\n");
+    printf("                  shortest-first (drops the longest waiting job instead)\n");
+    printf("  --token-rate <rate>[:<burst>]\n");
+    printf("                  Admit at most <rate> processes per time unit, deferring the\n");
+    printf("                  rest (default burst: 1)\n");
+    printf("  --closed-loop <clients>\n");
+    printf("                  Drive the input's bursts from 1, 2, 4, ... up to <clients>\n");
+    printf("                  closed-loop clients and print throughput against response time\n");
+    printf("  --think-time <dist>\n");
+    printf("                  Client think time for --closed-loop: const:<t>, exp:<mean> or\n");
+    printf("                  uniform:<low>:<high> (default: exp:10)\n");
+    printf("  --window <width>\n");
+    printf("                  Stream throughput, queue length, utilisation and turnaround\n");
+    printf("                  percentiles per <width> time units (fcfs, sjf, srtf or rr)\n");
+    printf("  --series-file <file>\n");
+    printf("                  Write the --window series to <file> (default: standard output)\n");
+    printf("  --pipeline      Overlap loading, simulation and printing on three threads for\n");
+    printf("                  input sorted by arrival time (fcfs, sjf, srtf or rr)\n");
+    printf("  --no-huge-pages Keep large process arrays on normal pages\n");
+    printf("  --huge-page-report\n");
+    printf("                  Print how much of the process array is on huge pages\n");
+    printf("  --summary-only  Print the metrics without a row per process, and the --window\n");
+    printf("                  summaries without the series unless --series-file is given\n");
+    printf("  --max-memory <size>\n");
+    printf("                  Stay within <size> bytes (K, M or G suffix) by streaming the\n");
+    printf("                  input, and printing metrics only, when loading it would not fit\n");
+    printf("  --memory-report Print the memory held by each subsystem at exit\n");
+    printf("  --grid <spec>   Run every combination of alg=..., q=..., cost=... and cores=...,\n");
+    printf("                  e.g. \"alg=fcfs,rr;q=1:8;cost=0,1;cores=1,2\", on -w threads\n");
+    printf("  --cache-dir <dir>\n");
+    printf("                  Directory of cached --grid results (default: .grid-cache)\n");
+    printf("  -h, --help      Display this help message\n\n");
+    printf("At most one of --serve, --pipeline, --profile-workload, --write-workload,\n");
+    printf("--tune-quantum, --online, --grid, --closed-loop, --window, --max-queue or\n");
+    printf("--token-rate, --live and --shard-by may be given (--shard-by may go with\n");
+    printf("--write-workload), and options that tune a mode require it.\n");
+}
+
+/**
+ * @brief Runs the selected algorithm(s) once per partition and prints the results
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Worker options
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a simulation failed
+ */
+static int run_sharded(const char* algorithm, int time_quantum, const Process* processes, int n,
+                       const ShardOptions* options) {
+    for (int a = 0; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        ShardReport report;
+        if (shard_run(&params, processes, process_partitions(), process_io(), n, options, &report) != 0) {
+            fprintf(stderr, "Error: Sharded %s simulation failed\n", algorithm_title((Algorithm)a));
+            return EXIT_FAILURE;
+        }
+        print_shard_report(&report, algorithm_title((Algorithm)a));
+        free_shard_report(&report);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Runs the selected algorithm(s) on real threads and prints measured and simulated results
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Time scale and placement
+ * @param summary_only Print the metrics without a row per process
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a run failed
+ */
+static int run_live(const char* algorithm, int time_quantum, const Process* processes, int n,
+                    const LiveOptions* options, bool summary_only) {
+    for (int a = 0; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        if (a > ALG_RR) {
+            fprintf(stderr, "Error: Live mode supports fcfs, sjf, srtf and rr\n");
+            return EXIT_FAILURE;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        Process* simulated = copy_processes((Process*)processes, n);
+        if (!simulated) {
+            return EXIT_FAILURE;
+        }
+        Metrics simulated_metrics = run_schedule(&params, simulated, process_io(), n);
+        free_process_copy(simulated, n);
+
+        printf("\nRunning %s algorithm on live threads...\n", algorithm_title((Algorithm)a));
+        LiveReport report;
+        if (live_run(&params, processes, n, options, &report) != 0) {
+            fprintf(stderr, "Error: Live %s run failed\n", algorithm_title((Algorithm)a));
+            return EXIT_FAILURE;
+        }
+        if (!summary_only) print_processes(report.processes, report.n);
+        print_live_report(&report, simulated_metrics, algorithm_title((Algorithm)a));
+        free_live_report(&report);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Replays the input through the online engine and prints the schedule and prediction accuracy
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param summary_only Print the metrics without a row per process
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a replay failed
+ */
+static int run_online(const char* algorithm, int time_quantum, const Process* processes, int n, bool summary_only) {
+    for (int a = 0; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        if (a > ALG_RR) {
+            fprintf(stderr, "Error: The online engine supports fcfs, sjf, srtf and rr\n");
+            return EXIT_FAILURE;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        Process* replay = copy_processes((Process*)processes, n);
+        int* predicted = (int*)malloc(n * sizeof(int));
+        Metrics metrics;
+        if (!replay || !predicted || online_replay(&params, replay, n, predicted, &metrics) != 0) {
+            fprintf(stderr, "Error: Online %s replay failed\n", algorithm_title((Algorithm)a));
+            free_process_copy(replay, n);
+            free(predicted);
+            return EXIT_FAILURE;
+        }
+
+        // Predictions assume no later arrivals, so they can only be early
+        int exact = 0;
+        int64_t error = 0;
+        for (int i = 0; i < n; i++) {
+            if (predicted[i] == replay[i].completion_time) exact++;
+            error += replay[i].completion_time - predicted[i];
+        }
+
+        printf("\nReplaying %s through the online engine...\n", algorithm_title((Algorithm)a));
+        if (!summary_only) print_processes(replay, n);
+        print_metrics(metrics, algorithm_title((Algorithm)a));
+        printf("Completion predicted at submission: %d of %d exact, average error %.2f\n", exact, n,
+               (double)error / n);
+        printf("----------------------------------------------------------------------------------\n");
+        free_process_copy(replay, n);
+        free(predicted);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Runs the selected algorithm(s) behind admission limits and prints the outcome
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Admission limits
+ * @param summary_only Print the metrics without a row per process
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a run failed
+ */
+static int run_admission(const char* algorithm, int time_quantum, const Process* processes, int n,
+                         const AdmissionOptions* options, bool summary_only) {
+    for (int a = 0; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        if (a > ALG_RR) {
+            fprintf(stderr, "Error: Admission control supports fcfs, sjf, srtf and rr\n");
+            return EXIT_FAILURE;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        Process* admitted = copy_processes((Process*)processes, n);
+        AdmissionReport report;
+        if (!admitted || admission_run(&params, admitted, n, options, &report) < 0) {
+            fprintf(stderr, "Error: %s run with admission control failed\n", algorithm_title((Algorithm)a));
+            free_process_copy(admitted, n);
+            return EXIT_FAILURE;
+        }
+
+        printf("\nRunning %s algorithm with admission control...\n", algorithm_title((Algorithm)a));
+        if (!summary_only) print_processes(admitted, report.completed);
+        print_admission_report(&report, options, algorithm_title((Algorithm)a));
+        free_process_copy(admitted, n);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Runs the selected algorithm(s) under a closed-loop workload and prints the curves
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Client counts and think times
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a run failed
+ */
+static int run_closed_loop(const char* algorithm, int time_quantum, const Process* processes, int n,
+                           const ClosedOptions* options) {
+    for (int a = 0; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        if (a > ALG_RR) {
+            fprintf(stderr, "Error: Closed-loop mode supports fcfs, sjf, srtf and rr\n");
+            return EXIT_FAILURE;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        ClosedResult result;
+        if (closed_loop_curve(&params, processes, n, options, &result) != 0) {
+            fprintf(stderr, "Error: Closed-loop %s run failed\n", algorithm_title((Algorithm)a));
+            return EXIT_FAILURE;
+        }
+        print_closed_result(&result, options, algorithm_title((Algorithm)a));
+        free_closed_result(&result);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Streams a windowed metrics series of the selected algorithm(s) and prints a summary of each
+ * @param algorithm Algorithm name from the command line, or "all"
+ * @param time_quantum Time quantum for Round Robin
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Window width; the destination is filled in here
+ * @param path File receiving the series, or NULL for standard output
+ * @param summary_only Print only the summaries unless path is given
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a run failed
+ */
+static int run_windows(const char* algorithm, int time_quantum, const Process* processes, int n,
+                       WindowOptions* options, const char* path, bool summary_only) {
+    options->file = path ? fopen(path, "w") : summary_only ? NULL : stdout;
+    if (path && !options->file) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    if (options->file) {
+        write_window_header(options->file);
+    }
+
+    int status = EXIT_SUCCESS;
+    for (int a = 0; a < ALG_COUNT && status == EXIT_SUCCESS; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        if (a > ALG_RR) {
+            fprintf(stderr, "Error: Windowed series support fcfs, sjf, srtf and rr\n");
+            status = EXIT_FAILURE;
+            break;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        WindowSummary summary;
+        if (window_series(&params, processes, n, options, &summary) != 0) {
+            fprintf(stderr, "Error: Windowed %s run failed\n", algorithm_title((Algorithm)a));
+            status = EXIT_FAILURE;
+            break;
+        }
+        print_window_summary(&summary, options, algorithm_title((Algorithm)a));
+    }
+
+    if (path && fclose(options->file) != 0) {
+        perror(path);
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+/**
+ * @brief Loads, schedules and prints the input in overlapping stages
+ * @param algorithm Algorithm name from the command line; fcfs, sjf, srtf, rr, or "all" to read a file once for each
+ * @param time_quantum Time quantum for Round Robin
+ * @param filename Input file
+ * @param read_options Loader options
+ * @param summary_only Print the metrics without a row per process
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int run_pipeline(const char* algorithm, int time_quantum, const char* filename,
+                        const ReadOptions* read_options, bool summary_only) {
+    Algorithm selected;
+    bool all = strcmp(algorithm, "all") == 0;
+    if (!all && (!parse_algorithm(algorithm, &selected) || selected > ALG_RR)) {
+        fprintf(stderr, "Error: --pipeline runs fcfs, sjf, srtf or rr; choose them with -a\n");
+        return EXIT_FAILURE;
+    }
+    if (all && strcmp(filename, "-") == 0) {
+        fprintf(stderr, "Error: --pipeline reads standard input only once; choose one algorithm with -a\n");
+        return EXIT_FAILURE;
+    }
+
+    // Each algorithm streams the file again rather than keeping it in memory
+    for (int a = ALG_FCFS; a <= ALG_RR; a++) {
+        if (!all && a != (int)selected) {
+            continue;
+        }
+
+        SchedParams params = {(Algorithm)a, time_quantum};
+        PipelineStats stats;
+        printf("Pipelining %s from %s...\n", algorithm_title((Algorithm)a), filename);
+        if (pipeline_run(&params, filename, read_options, summary_only ? NULL : stdout, &stats) != 0) {
+            fprintf(stderr, "Error: Pipelined %s run failed\n", algorithm_title((Algorithm)a));
+            return EXIT_FAILURE;
+        }
+
+        printf("Read %d processes from %s\n", stats.count, filename);
+        print_metrics(stats.metrics, algorithm_title((Algorithm)a));
+        printf("Pipeline: %.1f ms elapsed; busy %.1f ms reading, %.1f ms simulating, %.1f ms writing\n",
+               stats.wall_ms, stats.read_ms, stats.simulate_ms, stats.write_ms);
+        printf("----------------------------------------------------------------------------------\n");
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Chooses how to run the input within a memory budget and prints the choice
+ *
+ * The workload is loaded whole when its estimate fits, as without a budget.
+ * Otherwise, if the input is sorted by arrival time, the run is streamed
+ * through the pipeline with a row per process, or, if that does not fit
+ * either, with compact records, no identifiers and metrics only. When no
+ * mode fits, the one with the smallest estimate runs, so a streamed mode is
+ * never chosen over a smaller load. Modes other than the default run need
+ * the whole workload and are never switched; a warning is printed when they
+ * may exceed the budget.
+ *
+ * @param filename Input file
+ * @param algorithm Algorithm name from the command line
+ * @param budget Memory budget in bytes
+ * @param default_run Whether the default simulation runs, rather than a mode that needs the whole workload
+ * @param pipeline Whether --pipeline was given, which rules out loading the workload whole
+ * @return Mode to run in
+ */
+static FootprintMode plan_memory(const char* filename, const char* algorithm, size_t budget, bool default_run,
+                                 bool pipeline) {
+    FootprintEstimate estimate;
+    estimate_footprint(filename, &estimate);
+    bool known = estimate.processes >= 0;
+
+    Algorithm selected;
+    bool streamable = strcmp(algorithm, "all") == 0 ? strcmp(filename, "-") != 0
+                                                    : parse_algorithm(algorithm, &selected) && selected <= ALG_RR;
+    FootprintMode mode = FOOTPRINT_LOADED;
+    bool unsorted = false;
+    if (pipeline) {
+        mode = known && estimate.streamed <= budget ? FOOTPRINT_STREAMED : FOOTPRINT_SUMMARY;
+    } else if (default_run && streamable && !(known && estimate.loaded <= budget)) {
+        // The pipeline stops at the first arrival out of order, so only a sorted input may be switched to it
+        if (!footprint_input_sorted(filename)) {
+            unsorted = true;
+        } else if (!known) {
+            mode = FOOTPRINT_SUMMARY;
+        } else if (estimate.streamed <= budget) {
+            mode = FOOTPRINT_STREAMED;
+        } else if (estimate.summary < estimate.loaded) {
+            mode = FOOTPRINT_SUMMARY;
+        }
+    }
+
+    if (known) {
+        printf("Memory budget %.1f MB: about %lld processes, estimated peak %.1f MB loaded whole, "
+               "%.1f MB streamed, %.1f MB summary only\n",
+               budget / 1048576.0, (long long)estimate.processes, estimate.loaded / 1048576.0,
+               estimate.streamed / 1048576.0, estimate.summary / 1048576.0);
+    } else {
+        printf("Memory budget %.1f MB: input size unknown\n", budget / 1048576.0);
+    }
+    printf("Memory budget: running %s\n", footprint_mode_name(mode));
+
+    size_t needed = mode == FOOTPRINT_LOADED ? estimate.loaded
+                  : mode == FOOTPRINT_STREAMED ? estimate.streamed : estimate.summary;
+    if (mode == FOOTPRINT_LOADED && unsorted) {
+        fprintf(stderr, "Warning: %s is not known to be sorted by arrival_time, so it is loaded whole, "
+                        "which may exceed --max-memory\n", strcmp(filename, "-") == 0 ? "standard input" : filename);
+    } else if (mode == FOOTPRINT_LOADED && (!default_run || !streamable) && (!known || needed > budget)) {
+        fprintf(stderr, "Warning: %s%s needs the whole workload in memory, which may exceed --max-memory\n",
+                default_run ? "-a " : "this mode", default_run ? algorithm : "");
+    } else if (known && needed > budget) {
+        fprintf(stderr, "Warning: estimated peak of %.1f MB exceeds --max-memory in every mode\n",
+                needed / 1048576.0);
+    }
+    return mode;
+}
+
+/**
+ * @brief Runs a parameter grid and prints one row per cell
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param grid Grid to run
+ * @param options Worker count and cache directory
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the run failed
+ */
+static int run_grid(const Process* processes, int n, const GridSpec* grid, const GridOptions* options) {
+    GridResult result;
+    if (grid_run(processes, process_io(), n, grid, options, &result) != 0) {
+        return EXIT_FAILURE;
+    }
+    print_grid_result(&result);
+    free_grid_result(&result);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Searches for the best Round Robin quantum and prints the curve and the optimum
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param options Objective and search range
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the search failed
+ */
+static int run_tuning(const Process* processes, int n, const TuneOptions* options) {
+    TuneResult result;
+    if (tune_quantum(processes, n, options, &result) != 0) {
+        fprintf(stderr, "Error: Quantum search failed\n");
+        return EXIT_FAILURE;
+    }
+    print_tune_result(&result, options);
+
+    // Full metrics of the optimum, with the same switch cost
+    Process* optimum = copy_processes((Process*)processes, n);
+    if (optimum) {
+        RrOptions rr_options = {options->switch_cost, INT64_MAX, INT64_MAX, 0, INT64_MAX};
+        int quantum = result.points[result.best].quantum;
+        Metrics metrics = rr_schedule_with_options(optimum, n, quantum, &rr_options, NULL);
+        char title[64];
+        snprintf(title, sizeof(title), "Round Robin (quantum = %d)", quantum);
+        print_metrics(metrics, title);
+        free_process_copy(optimum, n);
+    }
+
+    free_tune_result(&result);
+    return optimum ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 /**
@@ -42,10 +577,79 @@ int main(int argc, char* argv[]) {
     char* filename = "data/processes.csv";
     char* algorithm = "all";
     int time_quantum = 2;
+    ReadOptions read_options = {0};
+    WorkloadProfile profile;
+    profile_init(&profile);
+    ShardOptions shard_options = {0};
+    const char* remotes[MAX_REMOTES];
+    const char* serve_address = NULL;
+    const char* workload_output = NULL;
+    bool tune = false;
+    TuneOptions tune_options = {OBJ_WAITING, 0, 0, 0};
+    bool live = false;
+    bool pipeline = false;
+    bool huge_page_report = false;
+    bool summary_only = false;
+    size_t memory_budget = 0;
+    bool online = false;
+    LiveOptions live_options = {1000, -1};
+    AdmissionOptions admission_options = {0, SHED_NEWEST, 0, 1};
+    ClosedOptions closed_options = {0, {THINK_EXPONENTIAL, 10, 0}, 1};
+    const char* grid_spec = NULL;
+    GridOptions grid_options = {0, ".grid-cache"};
+    MetricsOutput metrics_output = {false, false, false, NULL};
+    const char* histogram_output = NULL;
+    WindowOptions window_options = {0, NULL};
+    const char* series_output = NULL;
+    // Options whose defaults do not show whether they were given, by the name they were given under
+    const char* tune_option = NULL;
+    const char* live_option = NULL;
+    const char* shed_option = NULL;
+    const char* think_option = NULL;
+    const char* cache_option = NULL;
     
+    static const struct option long_options[] = {
+        {"shard-by", required_argument, NULL, 'S'},
+        {"workers", required_argument, NULL, 'w'},
+        {"shard-threads", no_argument, NULL, 'T'},
+        {"connect", required_argument, NULL, OPT_CONNECT},
+        {"serve", required_argument, NULL, OPT_SERVE},
+        {"write-workload", required_argument, NULL, OPT_WRITE_WORKLOAD},
+        {"profile-workload", no_argument, NULL, OPT_PROFILE_WORKLOAD},
+        {"tune-quantum", required_argument, NULL, OPT_TUNE_QUANTUM},
+        {"switch-cost", required_argument, NULL, OPT_SWITCH_COST},
+        {"quantum-range", required_argument, NULL, OPT_QUANTUM_RANGE},
+        {"live", no_argument, NULL, OPT_LIVE},
+        {"online", no_argument, NULL, OPT_ONLINE},
+        {"time-unit", required_argument, NULL, OPT_TIME_UNIT},
+        {"pin-cpu", required_argument, NULL, OPT_PIN_CPU},
+        {"max-queue", required_argument, NULL, OPT_MAX_QUEUE},
+        {"shed", required_argument, NULL, OPT_SHED},
+        {"token-rate", required_argument, NULL, OPT_TOKEN_RATE},
+        {"closed-loop", required_argument, NULL, OPT_CLOSED_LOOP},
+        {"think-time", required_argument, NULL, OPT_THINK_TIME},
+        {"grid", required_argument, NULL, OPT_GRID},
+        {"cache-dir", required_argument, NULL, OPT_CACHE_DIR},
+        {"percentiles", no_argument, NULL, OPT_PERCENTILES},
+        {"export-histograms", required_argument, NULL, OPT_EXPORT_HISTOGRAMS},
+        {"fairness", no_argument, NULL, OPT_FAIRNESS},
+        {"queue-stats", no_argument, NULL, OPT_QUEUE_STATS},
+        {"window", required_argument, NULL, OPT_WINDOW},
+        {"series-file", required_argument, NULL, OPT_SERIES_FILE},
+        {"pipeline", no_argument, NULL, OPT_PIPELINE},
+        {"no-huge-pages", no_argument, NULL, OPT_NO_HUGE_PAGES},
+        {"huge-page-report", no_argument, NULL, OPT_HUGE_PAGE_REPORT},
+        {"summary-only", no_argument, NULL, OPT_SUMMARY_ONLY},
+        {"max-memory", required_argument, NULL, OPT_MAX_MEMORY},
+        {"memory-report", no_argument, NULL, OPT_MEMORY_REPORT},
+        {"starvation-threshold", required_argument, NULL, OPT_STARVATION_THRESHOLD},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
     // Parse command line arguments
     int opt;
-    while ((opt = getopt(argc, argv, "f:a:q:h")) != -1) {
+    while ((opt = getopt_long(argc, argv, "f:a:q:j:S:w:Th", long_options, NULL)) != -1) {
         switch (opt) {
             case 'f':
                 filename = optarg;
@@ -60,6 +664,186 @@ int main(int argc, char* argv[]) {
                     return EXIT_FAILURE;
                 }
                 break;
+            case 'j':
+                read_options.threads = atoi(optarg);
+                if (read_options.threads <= 0) {
+                    fprintf(stderr, "Error: Thread count must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'S':
+                read_options.partition_column = optarg;
+                break;
+            case 'w':
+                shard_options.workers = atoi(optarg);
+                if (shard_options.workers <= 0) {
+                    fprintf(stderr, "Error: Worker count must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'T':
+                shard_options.use_threads = true;
+                break;
+            case OPT_CONNECT:
+                for (char* address = strtok(optarg, ","); address; address = strtok(NULL, ",")) {
+                    if (shard_options.remote_count == MAX_REMOTES) {
+                        fprintf(stderr, "Error: At most %d remote workers are supported\n", MAX_REMOTES);
+                        return EXIT_FAILURE;
+                    }
+                    remotes[shard_options.remote_count++] = address;
+                }
+                shard_options.remotes = remotes;
+                break;
+            case OPT_SERVE:
+                serve_address = optarg;
+                break;
+            case OPT_WRITE_WORKLOAD:
+                workload_output = optarg;
+                break;
+            case OPT_TUNE_QUANTUM:
+                if (!parse_objective(optarg, &tune_options.objective)) {
+                    fprintf(stderr, "Error: Unknown objective: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                tune = true;
+                break;
+            case OPT_SWITCH_COST:
+                tune_options.switch_cost = atoi(optarg);
+                if (tune_options.switch_cost < 0) {
+                    fprintf(stderr, "Error: Switch cost must not be negative\n");
+                    return EXIT_FAILURE;
+                }
+                tune_option = "--switch-cost";
+                break;
+            case OPT_QUANTUM_RANGE:
+                if (sscanf(optarg, "%d:%d", &tune_options.min_quantum, &tune_options.max_quantum) != 2 ||
+                    tune_options.min_quantum <= 0 || tune_options.max_quantum < tune_options.min_quantum) {
+                    fprintf(stderr, "Error: Quantum range must be <min>:<max> with 0 < min <= max\n");
+                    return EXIT_FAILURE;
+                }
+                tune_option = "--quantum-range";
+                break;
+            case OPT_LIVE:
+                live = true;
+                break;
+            case OPT_ONLINE:
+                online = true;
+                break;
+            case OPT_TIME_UNIT:
+                live_options.time_unit_us = atoi(optarg);
+                if (live_options.time_unit_us <= 0) {
+                    fprintf(stderr, "Error: Time unit must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                live_option = "--time-unit";
+                break;
+            case OPT_PIN_CPU:
+                live_options.cpu = atoi(optarg);
+                if (live_options.cpu < 0) {
+                    fprintf(stderr, "Error: CPU number must not be negative\n");
+                    return EXIT_FAILURE;
+                }
+                live_option = "--pin-cpu";
+                break;
+            case OPT_MAX_QUEUE:
+                admission_options.max_queue = atoi(optarg);
+                if (admission_options.max_queue <= 0) {
+                    fprintf(stderr, "Error: Queue limit must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case OPT_SHED:
+                if (!parse_shed_policy(optarg, &admission_options.shed)) {
+                    fprintf(stderr, "Error: Shed policy must be newest or shortest-first\n");
+                    return EXIT_FAILURE;
+                }
+                shed_option = "--shed";
+                break;
+            case OPT_TOKEN_RATE: {
+                int fields = sscanf(optarg, "%lf:%d", &admission_options.token_rate, &admission_options.token_burst);
+                if (fields < 1 || !(admission_options.token_rate > 0) || admission_options.token_burst <= 0) {
+                    fprintf(stderr, "Error: Token rate must be <rate>[:<burst>] with positive values\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+            case OPT_CLOSED_LOOP:
+                closed_options.max_clients = atoi(optarg);
+                if (closed_options.max_clients <= 0) {
+                    fprintf(stderr, "Error: Client count must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case OPT_PROFILE_WORKLOAD:
+                read_options.profile = &profile;
+                break;
+            case OPT_GRID:
+                grid_spec = optarg;
+                break;
+            case OPT_CACHE_DIR:
+                grid_options.cache_dir = optarg;
+                cache_option = "--cache-dir";
+                break;
+            case OPT_PERCENTILES:
+                metrics_output.percentiles = true;
+                break;
+            case OPT_WINDOW:
+                window_options.width = atoi(optarg);
+                if (window_options.width <= 0) {
+                    fprintf(stderr, "Error: Window width must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case OPT_SERIES_FILE:
+                series_output = optarg;
+                break;
+            case OPT_PIPELINE:
+                pipeline = true;
+                break;
+            case OPT_NO_HUGE_PAGES:
+                set_huge_pages(false);
+                break;
+            case OPT_HUGE_PAGE_REPORT:
+                huge_page_report = true;
+                break;
+            case OPT_SUMMARY_ONLY:
+                summary_only = true;
+                break;
+            case OPT_MAX_MEMORY:
+                if (!parse_memory_size(optarg, &memory_budget)) {
+                    fprintf(stderr, "Error: Memory budget must be a positive size such as 512M or 2G\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case OPT_MEMORY_REPORT:
+                // Printed after whichever mode runs, including its early returns
+                atexit(print_footprint_report);
+                break;
+            case OPT_FAIRNESS:
+                metrics_output.fairness = true;
+                break;
+            case OPT_QUEUE_STATS:
+                metrics_output.queue = true;
+                break;
+            case OPT_STARVATION_THRESHOLD: {
+                int threshold = atoi(optarg);
+                if (threshold <= 0) {
+                    fprintf(stderr, "Error: Starvation threshold must be positive\n");
+                    return EXIT_FAILURE;
+                }
+                set_starvation_threshold(threshold);
+                break;
+            }
+            case OPT_EXPORT_HISTOGRAMS:
+                histogram_output = optarg;
+                break;
+            case OPT_THINK_TIME:
+                if (!parse_think_time(optarg, &closed_options.think)) {
+                    fprintf(stderr, "Error: Think time must be const:<t>, exp:<mean> or uniform:<low>:<high>\n");
+                    return EXIT_FAILURE;
+                }
+                think_option = "--think-time";
+                break;
             case 'h':
                 print_usage(argv[0]);
                 return EXIT_SUCCESS;
@@ -69,9 +853,101 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // Each mode decides what the run does, so at most one may be given; a written workload keeps its partitions
+    bool sharded = read_options.partition_column && !workload_output;
+    bool admission = admission_options.max_queue > 0 || admission_options.token_rate > 0;
+    const struct {
+        bool set;
+        const char* name;
+    } modes[] = {
+        {serve_address != NULL, "--serve"},
+        {pipeline, "--pipeline"},
+        {read_options.profile != NULL, "--profile-workload"},
+        {workload_output != NULL, "--write-workload"},
+        {tune, "--tune-quantum"},
+        {online, "--online"},
+        {grid_spec != NULL, "--grid"},
+        {closed_options.max_clients > 0, "--closed-loop"},
+        {window_options.width > 0, "--window"},
+        {admission, admission_options.max_queue > 0 ? "--max-queue" : "--token-rate"},
+        {live, "--live"},
+        {sharded, "--shard-by"},
+    };
+    const char* mode = NULL;
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        if (!modes[i].set) {
+            continue;
+        }
+        if (mode) {
+            fprintf(stderr, "Error: %s and %s cannot be combined\n", mode, modes[i].name);
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        mode = modes[i].name;
+    }
+    
+    // Options that only change how one mode runs
+    const struct {
+        const char* name;
+        bool mode_set;
+        const char* mode_name;
+    } modifiers[] = {
+        {tune_option, tune, "--tune-quantum"},
+        {live_option, live, "--live"},
+        {shed_option, admission_options.max_queue > 0, "--max-queue"},
+        {think_option, closed_options.max_clients > 0, "--closed-loop"},
+        {cache_option, grid_spec != NULL, "--grid"},
+        {series_output ? "--series-file" : NULL, window_options.width > 0, "--window"},
+        {shard_options.workers > 0 ? "-w" : NULL, sharded || grid_spec, "--shard-by or --grid"},
+        {shard_options.use_threads ? "-T" : NULL, sharded, "--shard-by"},
+        {shard_options.remote_count > 0 ? "--connect" : NULL, sharded, "--shard-by"},
+    };
+    for (size_t i = 0; i < sizeof(modifiers) / sizeof(modifiers[0]); i++) {
+        if (modifiers[i].name && !modifiers[i].mode_set) {
+            fprintf(stderr, "Error: %s requires %s\n", modifiers[i].name, modifiers[i].mode_name);
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if (serve_address) {
+        return net_serve(serve_address);
+    }
+    if (histogram_output) {
+        // Left open until exit, which flushes and closes it with the standard streams
+        metrics_output.export_file = strcmp(histogram_output, "-") == 0 ? stdout : fopen(histogram_output, "a");
+        if (!metrics_output.export_file) {
+            perror(histogram_output);
+            return EXIT_FAILURE;
+        }
+    }
+    set_metrics_output(&metrics_output);
+    
+    if (memory_budget > 0) {
+        bool default_run = !read_options.profile && !workload_output && !tune && !online && !grid_spec &&
+                           closed_options.max_clients == 0 && window_options.width == 0 &&
+                           admission_options.max_queue == 0 && !(admission_options.token_rate > 0) && !live &&
+                           !read_options.partition_column;
+        FootprintMode mode = plan_memory(filename, algorithm, memory_budget, default_run, pipeline);
+        if (mode != FOOTPRINT_LOADED) {
+            pipeline = true;
+        }
+        if (mode == FOOTPRINT_SUMMARY) {
+            summary_only = true;
+        }
+    }
+    
+    if (pipeline) {
+        // Identifiers only label the rows, so a summary does not keep them
+        read_options.discard_ids = summary_only;
+        int status = run_pipeline(algorithm, time_quantum, filename, &read_options, summary_only);
+        free_process_ids();
+        return status;
+    }
+    
     // Read process data from file
     Process* processes = NULL;
-    int n = read_processes(filename, &processes);
+    int n = read_processes_with_options(filename, &processes, &read_options);
     
     if (n <= 0) {
         fprintf(stderr, "Error reading processes from file: %s\n", filename);
@@ -80,81 +956,181 @@ int main(int argc, char* argv[]) {
     
     printf("Read %d processes from %s\n", n, filename);
     
-    // Create copies of the processes for each algorithm
-    Process* fcfs_processes = NULL;
-    Process* sjf_processes = NULL;
-    Process* srtf_processes = NULL;
-    Process* rr_processes = NULL;
+    if (huge_page_report) {
+        print_huge_page_report("process array", processes, (size_t)n * sizeof(Process));
+    }
+    
+    if (read_options.profile) {
+        print_workload_profile(&profile, filename);
+        free_processes(processes, n);
+        free_process_ids();
+        return EXIT_SUCCESS;
+    }
     
-    // Run the selected algorithm(s)
+    if (workload_output) {
+        int status = write_processes_binary(workload_output, processes, n);
+        if (status == 0) {
+            printf("Wrote %d processes to %s\n", n, workload_output);
+        }
+        free_processes(processes, n);
+        free_process_ids();
+        return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    
+    if (tune) {
+        int status = run_tuning(processes, n, &tune_options);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (online) {
+        int status = run_online(algorithm, time_quantum, processes, n, summary_only);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (grid_spec) {
+        GridSpec grid;
+        int status = EXIT_FAILURE;
+        if (!parse_grid_spec(grid_spec, time_quantum, &grid)) {
+            fprintf(stderr, "Error: Invalid grid specification: %s\n", grid_spec);
+        } else {
+            grid_options.workers = shard_options.workers;
+            status = run_grid(processes, n, &grid, &grid_options);
+        }
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (closed_options.max_clients > 0) {
+        int status = run_closed_loop(algorithm, time_quantum, processes, n, &closed_options);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (window_options.width > 0) {
+        int status = run_windows(algorithm, time_quantum, processes, n, &window_options, series_output, summary_only);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (admission_options.max_queue > 0 || admission_options.token_rate > 0) {
+        int status = run_admission(algorithm, time_quantum, processes, n, &admission_options, summary_only);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (live) {
+        int status = run_live(algorithm, time_quantum, processes, n, &live_options, summary_only);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    if (read_options.partition_column) {
+        int status = run_sharded(algorithm, time_quantum, processes, n, &shard_options);
+        free_processes(processes, n);
+        free_process_ids();
+        return status;
+    }
+    
+    // Run the selected algorithm(s), each on its own copy, released before the next is made
     if (strcmp(algorithm, "all") == 0 || strcmp(algorithm, "fcfs") == 0) {
-        fcfs_processes = copy_processes(processes, n);
+        Process* fcfs_processes = copy_processes(processes, n);
         if (!fcfs_processes) {
             fprintf(stderr, "Error: Memory allocation failed\n");
-            free(processes);
+            free_processes(processes, n);
             return EXIT_FAILURE;
         }
         
         printf("\nRunning First-Come-First-Serve (FCFS) algorithm...\n");
         Metrics fcfs_metrics = fcfs_schedule(fcfs_processes, n);
-        print_processes(fcfs_processes, n);
+        if (!summary_only) print_processes(fcfs_processes, n);
         print_metrics(fcfs_metrics, "FCFS");
+        free_process_copy(fcfs_processes, n);
     }
     
     if (strcmp(algorithm, "all") == 0 || strcmp(algorithm, "sjf") == 0) {
-        sjf_processes = copy_processes(processes, n);
+        Process* sjf_processes = copy_processes(processes, n);
         if (!sjf_processes) {
             fprintf(stderr, "Error: Memory allocation failed\n");
-            free(processes);
-            free(fcfs_processes);
+            free_processes(processes, n);
             return EXIT_FAILURE;
         }
         
         printf("\nRunning Shortest Job First (SJF) non-preemptive algorithm...\n");
         Metrics sjf_metrics = sjf_non_preemptive_schedule(sjf_processes, n);
-        print_processes(sjf_processes, n);
+        if (!summary_only) print_processes(sjf_processes, n);
         print_metrics(sjf_metrics, "SJF (non-preemptive)");
+        free_process_copy(sjf_processes, n);
     }
     
     if (strcmp(algorithm, "all") == 0 || strcmp(algorithm, "srtf") == 0) {
-        srtf_processes = copy_processes(processes, n);
+        Process* srtf_processes = copy_processes(processes, n);
         if (!srtf_processes) {
             fprintf(stderr, "Error: Memory allocation failed\n");
-            free(processes);
-            free(fcfs_processes);
-            free(sjf_processes);
+            free_processes(processes, n);
             return EXIT_FAILURE;
         }
         
         printf("\nRunning Shortest Remaining Time First (SRTF) preemptive algorithm...\n");
         Metrics srtf_metrics = sjf_preemptive_schedule(srtf_processes, n);
-        print_processes(srtf_processes, n);
+        if (!summary_only) print_processes(srtf_processes, n);
         print_metrics(srtf_metrics, "SRTF (preemptive SJF)");
+        free_process_copy(srtf_processes, n);
     }
     
     if (strcmp(algorithm, "all") == 0 || strcmp(algorithm, "rr") == 0) {
-        rr_processes = copy_processes(processes, n);
+        Process* rr_processes = copy_processes(processes, n);
         if (!rr_processes) {
             fprintf(stderr, "Error: Memory allocation failed\n");
-            free(processes);
-            free(fcfs_processes);
-            free(sjf_processes);
-            free(srtf_processes);
+            free_processes(processes, n);
             return EXIT_FAILURE;
         }
         
         printf("\nRunning Round Robin (RR) algorithm with time quantum = %d...\n", time_quantum);
-        Metrics rr_metrics = rr_schedule(rr_processes, n, time_quantum);
-        print_processes(rr_processes, n);
+        Metrics rr_metrics = rr_schedule(rr_processes, process_io(), n, time_quantum);
+        if (!summary_only) print_processes(rr_processes, n);
         print_metrics(rr_metrics, "Round Robin");
+        free_process_copy(rr_processes, n);
+    }
+    
+    // Variants that "all" does not include
+    for (int a = ALG_RR + 1; a < ALG_COUNT; a++) {
+        if (!algorithm_selected(algorithm, (Algorithm)a)) {
+            continue;
+        }
+        
+        Process* variant_processes = copy_processes(processes, n);
+        if (!variant_processes) {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            free_processes(processes, n);
+            return EXIT_FAILURE;
+        }
+        
+        printf("\nRunning %s algorithm...\n", algorithm_title((Algorithm)a));
+        SchedParams params = {(Algorithm)a, time_quantum};
+        Metrics variant_metrics = run_schedule(&params, variant_processes, process_io(), n);
+        if (variant_metrics.count != n) {
+            fprintf(stderr, "Error: %s simulation failed\n", algorithm_title((Algorithm)a));
+            free_process_copy(variant_processes, n);
+            free_processes(processes, n);
+            return EXIT_FAILURE;
+        }
+        if (!summary_only) print_processes(variant_processes, n);
+        print_metrics(variant_metrics, algorithm_title((Algorithm)a));
+        free_process_copy(variant_processes, n);
     }
     
     // Free allocated memory
-    free(processes);
-    if (fcfs_processes) free(fcfs_processes);
-    if (sjf_processes) free(sjf_processes);
-    if (srtf_processes) free(srtf_processes);
-    if (rr_processes) free(rr_processes);
+    free_processes(processes, n);
+    free_process_ids();
     
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,377 @@
+/**
+ * @file net.c
+ * @brief Implementation of the coordinator/worker TCP protocol
+ */
+
+#include "net.h"
+#include "intern.h"
+#include "workload.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** First bytes of every request */
+#define NET_REQUEST_MAGIC "CPUSREQ4"
+
+/** First bytes of every reply */
+#define NET_REPLY_MAGIC "CPUSRES4"
+
+/** Size of the fixed part of a request, before the workload */
+#define NET_REQUEST_SIZE 20
+
+/** Size of the fixed part of a reply, before the histograms */
+#define NET_REPLY_SIZE 96
+
+/** Size of the fixed part of an encoded histogram: count, min, max and bucket count */
+#define NET_HISTOGRAM_SIZE 20
+
+/** Size of each non-empty bucket of an encoded histogram: index and count */
+#define NET_BUCKET_SIZE 8
+
+/** Host used when an address names only a port */
+#define NET_DEFAULT_HOST "127.0.0.1"
+
+/**
+ * @brief Resolves an address of the form "port" or "host:port"
+ * @param address Address to resolve
+ * @param passive Whether the address is for listening
+ * @param result Where to store the list from getaddrinfo
+ * @return true if successful, false if the address could not be resolved
+ */
+static bool resolve(const char* address, bool passive, struct addrinfo** result) {
+    char host[256];
+    const char* port = strrchr(address, ':');
+    if (port) {
+        size_t len = (size_t)(port - address);
+        if (len >= sizeof(host)) {
+            fprintf(stderr, "Error: Host name too long: %s\n", address);
+            return false;
+        }
+        memcpy(host, address, len);
+        host[len] = '\0';
+        port++;
+    } else {
+        strcpy(host, NET_DEFAULT_HOST);
+        port = address;
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    int error = getaddrinfo(host[0] ? host : NULL, port, &hints, result);
+    if (error != 0) {
+        fprintf(stderr, "Error: Cannot resolve %s: %s\n", address, gai_strerror(error));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Opens a connection to a worker
+ * @param address Worker address, as "port" (loopback) or "host:port"
+ * @return Connected socket, or -1 on failure
+ */
+int net_connect(const char* address) {
+    struct addrinfo* list;
+    if (!resolve(address, false, &list)) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo* ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot connect to %s: %s\n", address, strerror(errno));
+    }
+    return fd;
+}
+
+/**
+ * @brief Stores a double as its little-endian IEEE 754 bit pattern
+ * @param p Destination (8 bytes)
+ * @param value Value to store
+ */
+static void put_double(unsigned char* p, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_le64(p, bits);
+}
+
+/**
+ * @brief Loads a double stored by put_double
+ * @param p Source (8 bytes)
+ * @return Stored value
+ */
+static double get_double(const unsigned char* p) {
+    uint64_t bits = get_le64(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Sends a histogram, listing only its non-empty buckets
+ * @param out Stream to write to
+ * @param histogram Histogram to send
+ * @return true if the histogram was written
+ */
+static bool send_histogram(FILE* out, const Histogram* histogram) {
+    unsigned char buffer[NET_HISTOGRAM_SIZE + HISTOGRAM_BUCKETS * NET_BUCKET_SIZE];
+    size_t len = NET_HISTOGRAM_SIZE;
+    for (int k = 0; k < HISTOGRAM_BUCKETS; k++) {
+        if (histogram->buckets[k] > 0) {
+            put_le32(buffer + len, (uint32_t)k);
+            put_le32(buffer + len + 4, histogram->buckets[k]);
+            len += NET_BUCKET_SIZE;
+        }
+    }
+    put_le64(buffer, (uint64_t)histogram->count);
+    put_le32(buffer + 8, (uint32_t)histogram->min);
+    put_le32(buffer + 12, (uint32_t)histogram->max);
+    put_le32(buffer + 16, (uint32_t)((len - NET_HISTOGRAM_SIZE) / NET_BUCKET_SIZE));
+    return fwrite(buffer, 1, len, out) == len;
+}
+
+/**
+ * @brief Receives a histogram sent by send_histogram
+ * @param in Stream to read from
+ * @param histogram Where to store the histogram
+ * @return true if a consistent histogram was read
+ */
+static bool receive_histogram(FILE* in, Histogram* histogram) {
+    unsigned char buffer[NET_HISTOGRAM_SIZE + HISTOGRAM_BUCKETS * NET_BUCKET_SIZE];
+    if (fread(buffer, 1, NET_HISTOGRAM_SIZE, in) != NET_HISTOGRAM_SIZE) {
+        return false;
+    }
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->count = (int64_t)get_le64(buffer);
+    histogram->min = (int)get_le32(buffer + 8);
+    histogram->max = (int)get_le32(buffer + 12);
+    uint32_t entries = get_le32(buffer + 16);
+    if (entries > HISTOGRAM_BUCKETS) {
+        return false;
+    }
+
+    size_t len = (size_t)entries * NET_BUCKET_SIZE;
+    if (fread(buffer, 1, len, in) != len) {
+        return false;
+    }
+    int64_t total = 0;
+    for (uint32_t e = 0; e < entries; e++) {
+        uint32_t k = get_le32(buffer + e * NET_BUCKET_SIZE);
+        if (k >= HISTOGRAM_BUCKETS) {
+            return false;
+        }
+        histogram->buckets[k] = get_le32(buffer + e * NET_BUCKET_SIZE + 4);
+        total += histogram->buckets[k];
+    }
+    return total == histogram->count;
+}
+
+/**
+ * @brief Sends one shard to a worker and waits for its metrics
+ * @param out Stream writing to the worker
+ * @param in Stream reading from the worker
+ * @param params Algorithm and parameters
+ * @param processes Processes of the shard
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param metrics Where to store the metrics of the shard
+ * @return 0 on success, -1 on a connection or protocol error
+ */
+int net_request(FILE* out, FILE* in, const SchedParams* params, const Process* processes, const ProcessIo* io,
+                int n, Metrics* metrics) {
+    unsigned char request[NET_REQUEST_SIZE];
+    memcpy(request, NET_REQUEST_MAGIC, 8);
+    put_le32(request + 8, (uint32_t)params->algorithm);
+    put_le32(request + 12, (uint32_t)params->time_quantum);
+    put_le32(request + 16, (uint32_t)starvation_threshold());
+
+    // Workers only report metrics, so names and partition keys stay behind
+    ProcessArray shard = {(Process*)processes, NULL, (ProcessIo*)io, n, n};
+    if (fwrite(request, 1, sizeof(request), out) != sizeof(request) ||
+        workload_write(out, &shard, NULL, NULL) != 0 || fflush(out) != 0) {
+        return -1;
+    }
+
+    unsigned char reply[NET_REPLY_SIZE];
+    if (fread(reply, 1, sizeof(reply), in) != sizeof(reply) || memcmp(reply, NET_REPLY_MAGIC, 8) != 0 ||
+        get_le32(reply + 8) != 0) {
+        return -1;
+    }
+
+    Metrics result = {0};
+    result.count = (int64_t)get_le64(reply + 16);
+    result.total_turnaround = (int64_t)get_le64(reply + 24);
+    result.total_waiting = (int64_t)get_le64(reply + 32);
+    result.total_response = (int64_t)get_le64(reply + 40);
+    result.starved = get_le32(reply + 12);
+    result.total_slowdown = get_double(reply + 48);
+    result.total_slowdown_sq = get_double(reply + 56);
+    result.queue_area = (int64_t)get_le64(reply + 64);
+    result.busy_time = (int64_t)get_le64(reply + 72);
+    result.span = (int64_t)get_le64(reply + 80);
+    result.max_queue = (int)get_le32(reply + 88);
+    result.cpus = (int)get_le32(reply + 92);
+    if (!receive_histogram(in, &result.turnaround) || !receive_histogram(in, &result.waiting) ||
+        !receive_histogram(in, &result.response) || !receive_histogram(in, &result.slowdown)) {
+        return -1;
+    }
+
+    // Averages are recomputed from the totals, as when merging shards
+    Metrics empty = {0};
+    *metrics = merge_metrics(result, empty);
+    return 0;
+}
+
+/**
+ * @brief Sends a reply: status and totals, then the four histograms
+ * @param out Stream writing to the coordinator
+ * @param status 0 on success, nonzero if the request failed
+ * @param metrics Metrics to report
+ * @return true if the reply was sent
+ */
+static bool send_reply(FILE* out, uint32_t status, const Metrics* metrics) {
+    unsigned char reply[NET_REPLY_SIZE];
+    memcpy(reply, NET_REPLY_MAGIC, 8);
+    put_le32(reply + 8, status);
+    put_le32(reply + 12, (uint32_t)metrics->starved);
+    put_le64(reply + 16, (uint64_t)metrics->count);
+    put_le64(reply + 24, (uint64_t)metrics->total_turnaround);
+    put_le64(reply + 32, (uint64_t)metrics->total_waiting);
+    put_le64(reply + 40, (uint64_t)metrics->total_response);
+    put_double(reply + 48, metrics->total_slowdown);
+    put_double(reply + 56, metrics->total_slowdown_sq);
+    put_le64(reply + 64, (uint64_t)metrics->queue_area);
+    put_le64(reply + 72, (uint64_t)metrics->busy_time);
+    put_le64(reply + 80, (uint64_t)metrics->span);
+    put_le32(reply + 88, (uint32_t)metrics->max_queue);
+    put_le32(reply + 92, (uint32_t)metrics->cpus);
+    return fwrite(reply, 1, sizeof(reply), out) == sizeof(reply) && send_histogram(out, &metrics->turnaround) &&
+           send_histogram(out, &metrics->waiting) && send_histogram(out, &metrics->response) &&
+           send_histogram(out, &metrics->slowdown) && fflush(out) == 0;
+}
+
+/**
+ * @brief Answers requests on one connection until the peer closes it
+ * @param fd Connected socket; closed on return
+ */
+static void serve_connection(int fd) {
+    int write_fd = dup(fd);
+    FILE* in = fdopen(fd, "rb");
+    FILE* out = write_fd >= 0 ? fdopen(write_fd, "wb") : NULL;
+    if (!in || !out) {
+        perror("fdopen");
+        if (in) fclose(in); else close(fd);
+        if (out) fclose(out); else if (write_fd >= 0) close(write_fd);
+        return;
+    }
+
+    unsigned char request[NET_REQUEST_SIZE];
+    while (fread(request, 1, sizeof(request), in) == sizeof(request)) {
+        if (memcmp(request, NET_REQUEST_MAGIC, 8) != 0) {
+            fprintf(stderr, "worker: bad request\n");
+            break;
+        }
+
+        SchedParams params;
+        memset(&params, 0, sizeof(params));
+        uint32_t algorithm = get_le32(request + 8);
+        params.algorithm = (Algorithm)(algorithm < ALG_COUNT ? algorithm : ALG_COUNT);
+        params.time_quantum = (int)get_le32(request + 12);
+
+        // Starvation is counted against the coordinator's threshold
+        set_starvation_threshold((int)get_le32(request + 16));
+
+        IdTable ids;
+        IdTable partitions;
+        id_table_init(&ids);
+        id_table_init(&partitions);
+        ProcessArray shard = {0};
+        int n = workload_read("worker", in, 0, &ids, &partitions, NULL, &shard);
+        id_table_free(&ids);
+        id_table_free(&partitions);
+        if (n < 0) {
+            break;
+        }
+
+        Metrics metrics = {0};
+        uint32_t status = 0;
+        if (algorithm >= ALG_COUNT || ((params.algorithm == ALG_RR || params.algorithm == ALG_VRR) && params.time_quantum <= 0)) {
+            status = 1;
+        } else {
+            metrics = run_schedule(&params, shard.processes, shard.io, n);
+        }
+        process_array_free(&shard);
+
+        if (!send_reply(out, status, &metrics)) {
+            break;
+        }
+    }
+
+    fclose(in);
+    fclose(out);
+}
+
+/**
+ * @brief Serves simulation requests until the process is killed
+ * @param address Address to listen on, as "port" (loopback) or "host:port"
+ * @return EXIT_FAILURE if the socket could not be set up
+ */
+int net_serve(const char* address) {
+    struct addrinfo* list;
+    if (!resolve(address, true, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    int listener = -1;
+    for (struct addrinfo* ai = list; ai && listener < 0; ai = ai->ai_next) {
+        listener = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (listener < 0) {
+            continue;
+        }
+        int yes = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (bind(listener, ai->ai_addr, ai->ai_addrlen) != 0 || listen(listener, 16) != 0) {
+            close(listener);
+            listener = -1;
+        }
+    }
+    freeaddrinfo(list);
+
+    if (listener < 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", address, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    // A coordinator that goes away must not take the worker with it
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Worker listening on %s\n", address);
+    fflush(stdout);
+
+    for (;;) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("accept");
+            close(listener);
+            return EXIT_FAILURE;
+        }
+        serve_connection(fd);
+    }
+}
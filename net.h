@@ -0,0 +1,61 @@
+/**
+ * @file net.h
+ * @brief TCP protocol between a coordinator and remote simulation workers
+ *
+ * A coordinator sends each shard as a request and receives its metrics in
+ * the reply. Requests carry the shard in the binary workload format of
+ * workload.h, so a worker decodes it with the same reader used for files.
+ *
+ *   request:  magic "CPUSREQ4", u32 algorithm, u32 time_quantum,
+ *             u32 starvation_threshold, workload
+ *   reply:    magic "CPUSRES4", u32 status, u32 starved, u64 count,
+ *             i64 total_turnaround, i64 total_waiting, i64 total_response,
+ *             f64 total_slowdown, f64 total_slowdown_sq, i64 queue_area,
+ *             i64 busy_time, i64 span, u32 max_queue, u32 cpus, then the
+ *             turnaround, waiting, response and slowdown histograms
+ *   histogram: u64 count, i32 min, i32 max, u32 entries,
+ *             entries x (u32 bucket, u32 count) for non-empty buckets
+ *
+ * All integers are little-endian. A connection may carry any number of
+ * requests, each answered before the next is read.
+ */
+
+#ifndef NET_H
+#define NET_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @brief Serves simulation requests until the process is killed
+ *
+ * Connections are served one at a time; start one worker per CPU to use
+ * every core of a host.
+ *
+ * @param address Address to listen on, as "port" (loopback) or "host:port"
+ * @return EXIT_FAILURE if the socket could not be set up
+ */
+int net_serve(const char* address);
+
+/**
+ * @brief Opens a connection to a worker
+ * @param address Worker address, as "port" (loopback) or "host:port"
+ * @return Connected socket, or -1 on failure
+ */
+int net_connect(const char* address);
+
+/**
+ * @brief Sends one shard to a worker and waits for its metrics
+ * @param out Stream writing to the worker
+ * @param in Stream reading from the worker
+ * @param params Algorithm and parameters
+ * @param processes Processes of the shard
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param metrics Where to store the metrics of the shard
+ * @return 0 on success, -1 on a connection or protocol error
+ */
+int net_request(FILE* out, FILE* in, const SchedParams* params, const Process* processes, const ProcessIo* io,
+                int n, Metrics* metrics);
+
+#endif /* NET_H */
@@ -0,0 +1,768 @@
+/**
+ * @file online.c
+ * @brief Implementation of the online scheduling engine
+ */
+
+#include "online.h"
+#include "footprint.h"
+
+/**
+ * @brief Recomputes the size, sum and maximum of a treap node from its children
+ * @param jobs Job array
+ * @param t Node to update
+ */
+static void update(OnlineJob* jobs, int t) {
+    OnlineJob* node = &jobs[t];
+    node->size = 1;
+    node->sum = node->remaining_time;
+    node->max_remaining = node->remaining_time;
+    if (node->left >= 0) {
+        node->size += jobs[node->left].size;
+        node->sum += jobs[node->left].sum;
+        if (jobs[node->left].max_remaining > node->max_remaining) {
+            node->max_remaining = jobs[node->left].max_remaining;
+        }
+    }
+    if (node->right >= 0) {
+        node->size += jobs[node->right].size;
+        node->sum += jobs[node->right].sum;
+        if (jobs[node->right].max_remaining > node->max_remaining) {
+            node->max_remaining = jobs[node->right].max_remaining;
+        }
+    }
+}
+
+/**
+ * @brief Splits a treap by key
+ * @param jobs Job array
+ * @param t Root of the treap, or -1
+ * @param key Split point
+ * @param left Where to store the treap of keys below key
+ * @param right Where to store the treap of keys from key up
+ */
+static void split(OnlineJob* jobs, int t, int64_t key, int* left, int* right) {
+    if (t < 0) {
+        *left = -1;
+        *right = -1;
+    } else if (jobs[t].key < key) {
+        split(jobs, jobs[t].right, key, &jobs[t].right, right);
+        update(jobs, t);
+        *left = t;
+    } else {
+        split(jobs, jobs[t].left, key, left, &jobs[t].left);
+        update(jobs, t);
+        *right = t;
+    }
+}
+
+/**
+ * @brief Joins two treaps whose keys do not overlap
+ * @param jobs Job array
+ * @param a Treap with the smaller keys, or -1
+ * @param b Treap with the larger keys, or -1
+ * @return Root of the joined treap
+ */
+static int merge(OnlineJob* jobs, int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (jobs[a].weight > jobs[b].weight) {
+        jobs[a].right = merge(jobs, jobs[a].right, b);
+        update(jobs, a);
+        return a;
+    }
+    jobs[b].left = merge(jobs, a, jobs[b].left);
+    update(jobs, b);
+    return b;
+}
+
+/**
+ * @brief Builds the treap key of a job under the engine's policy
+ * @param engine Engine
+ * @param value Burst or remaining time of the job
+ * @param sequence Submission number of the job, which breaks ties by submission order
+ * @return Key
+ */
+static int64_t job_key(const OnlineEngine* engine, int value, uint32_t sequence) {
+    if (engine->params.algorithm == ALG_FCFS) {
+        value = 0;
+    }
+    return ((int64_t)value << 32) | sequence;
+}
+
+/**
+ * @brief Returns whether the engine serves a FIFO kept in the ring
+ * @param engine Engine
+ * @return true for FCFS and RR, false for SJF and SRTF
+ */
+static bool uses_ring(const OnlineEngine* engine) {
+    return engine->params.algorithm == ALG_FCFS || engine->params.algorithm == ALG_RR;
+}
+
+/**
+ * @brief Adds a job to the treap, keyed by its current remaining time
+ * @param engine Engine
+ * @param handle Job to add
+ */
+static void treap_insert(OnlineEngine* engine, int handle) {
+    OnlineJob* job = &engine->jobs[handle];
+    int value = engine->params.algorithm == ALG_SJF ? job->burst_time : job->remaining_time;
+    job->key = job_key(engine, value, job->sequence);
+    job->indexed = true;
+    job->left = -1;
+    job->right = -1;
+    update(engine->jobs, handle);
+
+    int left;
+    int right;
+    split(engine->jobs, engine->root, job->key, &left, &right);
+    engine->root = merge(engine->jobs, merge(engine->jobs, left, handle), right);
+}
+
+/**
+ * @brief Removes a job from the treap
+ * @param engine Engine
+ * @param handle Job to remove
+ */
+static void treap_erase(OnlineEngine* engine, int handle) {
+    engine->jobs[handle].indexed = false;
+    int left;
+    int middle;
+    int right;
+    split(engine->jobs, engine->root, engine->jobs[handle].key, &left, &middle);
+    split(engine->jobs, middle, engine->jobs[handle].key + 1, &middle, &right);
+    engine->root = merge(engine->jobs, left, right);
+}
+
+/**
+ * @brief Sums the remaining times of the queued jobs with keys up to a bound
+ * @param engine Engine
+ * @param key Largest key to include
+ * @param count Where to store the number of such jobs
+ * @return Their total remaining time
+ */
+static int64_t prefix_sum(const OnlineEngine* engine, int64_t key, int* count) {
+    const OnlineJob* jobs = engine->jobs;
+    int64_t sum = 0;
+    *count = 0;
+    for (int t = engine->root; t >= 0;) {
+        if (jobs[t].key <= key) {
+            sum += jobs[t].remaining_time;
+            (*count)++;
+            if (jobs[t].left >= 0) {
+                sum += jobs[jobs[t].left].sum;
+                *count += jobs[jobs[t].left].size;
+            }
+            t = jobs[t].right;
+        } else {
+            t = jobs[t].left;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Sums min(remaining, limit) over the queued jobs
+ * @param engine Engine
+ * @param limit Cap on each job's contribution (at least 0)
+ * @return The sum; this is the CPU time queued jobs receive in limit / quantum Round Robin rounds
+ */
+static int64_t capped_sum(const OnlineEngine* engine, int64_t limit) {
+    if (limit <= 0 || engine->root < 0) {
+        return 0;
+    }
+    if (limit > INT32_MAX) {
+        return engine->jobs[engine->root].sum;
+    }
+    int below;
+    int64_t sum = prefix_sum(engine, ((int64_t)limit << 32) | UINT32_MAX, &below);
+    return sum + limit * (engine->jobs[engine->root].size - below);
+}
+
+/**
+ * @brief Grows the Round Robin queue so that it can hold every submitted job
+ * @param engine Engine
+ * @param needed Number of entries required
+ * @return true if successful, false if memory allocation failed
+ */
+static bool ring_reserve(OnlineEngine* engine, int needed) {
+    if (needed <= engine->ring_capacity) {
+        return true;
+    }
+    int capacity = engine->ring_capacity ? engine->ring_capacity * 2 : 64;
+    int* ring = (int*)malloc(capacity * sizeof(int));
+    if (!ring) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    for (int i = 0; i < engine->ring_size; i++) {
+        ring[i] = engine->ring[(engine->ring_head + i) % engine->ring_capacity];
+    }
+    footprint_charge(SUBSYSTEM_QUEUES, (size_t)capacity * sizeof(int));
+    footprint_release(SUBSYSTEM_QUEUES, (size_t)engine->ring_capacity * sizeof(int));
+    free(engine->ring);
+    engine->ring = ring;
+    engine->ring_head = 0;
+    engine->ring_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Notes that a job's treap entry is out of date, if FCFS or RR keep the treap
+ *
+ * If the stale list cannot grow, the treap is dropped and the next query
+ * builds it again from the ring.
+ *
+ * @param engine Engine
+ * @param handle Job that was queued, dispatched or withdrawn
+ */
+static void mark_stale(OnlineEngine* engine, int handle) {
+    OnlineJob* job = &engine->jobs[handle];
+    if (!engine->indexed || job->stale) {
+        return;
+    }
+    if (engine->stale_count == engine->stale_capacity) {
+        int capacity = engine->stale_capacity ? engine->stale_capacity * 2 : 64;
+        int* stale = (int*)realloc(engine->stale, capacity * sizeof(int));
+        if (!stale) {
+            perror("Memory allocation failed");
+            engine->indexed = false;
+            return;
+        }
+        footprint_charge(SUBSYSTEM_QUEUES, (size_t)capacity * sizeof(int));
+        footprint_release(SUBSYSTEM_QUEUES, (size_t)engine->stale_capacity * sizeof(int));
+        engine->stale = stale;
+        engine->stale_capacity = capacity;
+    }
+    engine->stale[engine->stale_count++] = handle;
+    job->stale = true;
+}
+
+/**
+ * @brief Brings the FCFS and RR treap index up to date with the ring, building it on first use
+ * @param engine Engine
+ */
+static void sync_index(OnlineEngine* engine) {
+    if (!uses_ring(engine)) {
+        return;
+    }
+    if (!engine->indexed) {
+        for (int i = 0; i < engine->count; i++) {
+            engine->jobs[i].indexed = false;
+            engine->jobs[i].stale = false;
+        }
+        engine->root = -1;
+        engine->stale_count = 0;
+        for (int i = 0; i < engine->ring_size; i++) {
+            int handle = engine->ring[(engine->ring_head + i) % engine->ring_capacity];
+            if (engine->jobs[handle].queued) {
+                treap_insert(engine, handle);
+            }
+        }
+        engine->indexed = true;
+        return;
+    }
+    for (int i = 0; i < engine->stale_count; i++) {
+        int handle = engine->stale[i];
+        OnlineJob* job = &engine->jobs[handle];
+        job->stale = false;
+        if (job->indexed) {
+            treap_erase(engine, handle);
+        }
+        if (job->queued) {
+            treap_insert(engine, handle);
+        }
+    }
+    engine->stale_count = 0;
+}
+
+/**
+ * @brief Integrates the queue length and busy time up to a change of state
+ * @param engine Engine whose state held since engine->accounted
+ * @param time Time of the change
+ */
+static void account(OnlineEngine* engine, int64_t time) {
+    if (engine->submitted == 0) {
+        engine->accounted = time;
+        return;
+    }
+    if (time > engine->accounted) {
+        int queued = engine->queued;
+        int64_t span = time - engine->accounted;
+        engine->queue_area += queued * span;
+        if (engine->running >= 0) {
+            engine->busy_time += span;
+        }
+        if (queued > engine->max_queue) {
+            engine->max_queue = queued;
+        }
+        engine->accounted = time;
+    }
+}
+
+/**
+ * @brief Queues a job that is ready but not running
+ * @param engine Engine
+ * @param handle Job to queue
+ */
+static void enqueue_job(OnlineEngine* engine, int handle) {
+    engine->jobs[handle].queued = true;
+    engine->queued++;
+    if (uses_ring(engine)) {
+        engine->ring[(engine->ring_head + engine->ring_size) % engine->ring_capacity] = handle;
+        engine->ring_size++;
+        mark_stale(engine, handle);
+    } else {
+        treap_insert(engine, handle);
+    }
+}
+
+/**
+ * @brief Gives the CPU to the next queued job, if any
+ * @param engine Engine
+ * @param time Time the CPU becomes free
+ */
+static void dispatch(OnlineEngine* engine, int time) {
+    engine->running = -1;
+    if (engine->queued == 0) {
+        return;
+    }
+
+    int handle;
+    if (uses_ring(engine)) {
+        do {
+            handle = engine->ring[engine->ring_head];
+            engine->ring_head = (engine->ring_head + 1) % engine->ring_capacity;
+            engine->ring_size--;
+        } while (engine->jobs[handle].cancelled);
+    } else {
+        // The leftmost node has the smallest key
+        handle = engine->root;
+        while (engine->jobs[handle].left >= 0) {
+            handle = engine->jobs[handle].left;
+        }
+        treap_erase(engine, handle);
+    }
+
+    OnlineJob* job = &engine->jobs[handle];
+    job->queued = false;
+    engine->queued--;
+    mark_stale(engine, handle);
+    if (job->start_time < 0) {
+        job->start_time = time;
+    }
+    int slice = job->remaining_time;
+    if (engine->params.algorithm == ALG_RR && engine->params.time_quantum < slice) {
+        slice = engine->params.time_quantum;
+    }
+    engine->running = handle;
+    engine->run_start = time;
+    engine->slice_end = time + slice;
+}
+
+/**
+ * @brief Ends the running job's slice and dispatches the next job
+ * @param engine Engine with a running job
+ * @return Handle of the job if the slice completed it, or -1
+ */
+static int retire_slice(OnlineEngine* engine) {
+    int handle = engine->running;
+    OnlineJob* job = &engine->jobs[handle];
+    int end = engine->slice_end;
+    account(engine, end);
+    job->remaining_time -= end - engine->run_start;
+    engine->running = -1;
+
+    // Jobs submitted during the slice are already queued ahead of a preempted one
+    int completed = -1;
+    if (job->remaining_time == 0) {
+        job->completion_time = end;
+        completed = handle;
+    } else {
+        enqueue_job(engine, handle);
+    }
+    dispatch(engine, end);
+    return completed;
+}
+
+/**
+ * @brief Initializes an engine with no jobs at time 0
+ * @param engine Engine to initialize
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @return true if successful, false for an unsupported algorithm or quantum
+ */
+bool online_init(OnlineEngine* engine, const SchedParams* params) {
+    memset(engine, 0, sizeof(*engine));
+    if (params->algorithm > ALG_RR || (params->algorithm == ALG_RR && params->time_quantum <= 0)) {
+        return false;
+    }
+    engine->params = *params;
+    engine->root = -1;
+    engine->running = -1;
+    engine->free_list = -1;
+    return true;
+}
+
+/**
+ * @brief Advances the clock, running the schedule up to the given time
+ * @param engine Engine to advance
+ * @param time New current time; earlier times are ignored
+ */
+void online_advance(OnlineEngine* engine, int time) {
+    while (engine->running >= 0 && engine->slice_end < time) {
+        retire_slice(engine);
+    }
+    if (time > engine->now) {
+        engine->now = time;
+    }
+}
+
+/**
+ * @brief Retires a slice that ends at the current time
+ * @param engine Engine to update
+ * @return Handle of the job that completed with the slice, or -1
+ */
+int online_complete_due(OnlineEngine* engine) {
+    if (engine->running < 0 || engine->slice_end != engine->now) {
+        return -1;
+    }
+    return retire_slice(engine);
+}
+
+/**
+ * @brief Submits a job at the current time
+ * @param engine Engine to submit to
+ * @param burst_time CPU time required (positive)
+ * @return Handle of the job, or -1 on an invalid burst or allocation failure
+ */
+int online_submit(OnlineEngine* engine, int burst_time) {
+    if (burst_time <= 0) {
+        return -1;
+    }
+    if (uses_ring(engine) && !ring_reserve(engine, engine->count + 1)) {
+        return -1;
+    }
+    if (engine->free_list < 0 && engine->count == engine->capacity) {
+        int capacity = engine->capacity ? engine->capacity * 2 : 64;
+        OnlineJob* jobs = (OnlineJob*)realloc(engine->jobs, capacity * sizeof(OnlineJob));
+        if (!jobs) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)capacity * sizeof(OnlineJob));
+        footprint_release(SUBSYSTEM_ALGORITHM, (size_t)engine->capacity * sizeof(OnlineJob));
+        engine->jobs = jobs;
+        engine->capacity = capacity;
+    }
+
+    account(engine, engine->now);
+    int handle = engine->free_list;
+    if (handle >= 0) {
+        engine->free_list = engine->jobs[handle].left;
+    } else {
+        handle = engine->count++;
+    }
+    uint32_t sequence = (uint32_t)engine->submitted++;
+    OnlineJob* job = &engine->jobs[handle];
+    memset(job, 0, sizeof(*job));
+    job->arrival_time = engine->now;
+    job->burst_time = burst_time;
+    job->remaining_time = burst_time;
+    job->start_time = -1;
+    job->completion_time = -1;
+    job->sequence = sequence;
+    job->weight = sequence * 2654435761u ^ 0x9E3779B9u;
+
+    // A job handed the CPU at this instant has not run yet, so the choice is made again with the new one
+    // queued too; FCFS and Round Robin serve in arrival order either way
+    if (engine->running >= 0 && engine->run_start == engine->now && !uses_ring(engine)) {
+        OnlineJob* current = &engine->jobs[engine->running];
+        if (current->start_time == engine->now) {
+            current->start_time = -1;
+        }
+        enqueue_job(engine, engine->running);
+        engine->running = -1;
+    }
+
+    // SRTF preempts the running job for a strictly shorter one
+    if (engine->params.algorithm == ALG_SRTF && engine->running >= 0) {
+        OnlineJob* current = &engine->jobs[engine->running];
+        int left = current->remaining_time - (engine->now - engine->run_start);
+        if (burst_time < left) {
+            current->remaining_time = left;
+            enqueue_job(engine, engine->running);
+            engine->running = -1;
+        }
+    }
+
+    enqueue_job(engine, handle);
+    if (engine->running < 0) {
+        dispatch(engine, engine->now);
+    }
+    return handle;
+}
+
+/**
+ * @brief Gives back the handle of a completed job for reuse by a later submission
+ * @param engine Engine to update
+ * @param handle Job to release
+ * @return true if the handle was released, false if it is unknown, not completed or already released
+ */
+bool online_release(OnlineEngine* engine, int handle) {
+    if (handle < 0 || handle >= engine->count || engine->jobs[handle].completion_time < 0 ||
+        engine->jobs[handle].released) {
+        return false;
+    }
+    // The treap may still hold the job's dispatch, which must be applied before the handle is reused
+    if (engine->jobs[handle].stale) {
+        sync_index(engine);
+    }
+    engine->jobs[handle].released = true;
+    engine->jobs[handle].left = engine->free_list;
+    engine->free_list = handle;
+    return true;
+}
+
+/**
+ * @brief Returns the number of jobs waiting for the CPU
+ * @param engine Engine to query
+ * @return Queued jobs, not counting the running one
+ */
+int online_queue_length(const OnlineEngine* engine) {
+    return engine->queued;
+}
+
+/**
+ * @brief Finds the queued job with the most remaining time, in O(log n)
+ * @param engine Engine to query
+ * @return Handle of the job (the latest submitted on ties), or -1 if the queue is empty
+ */
+int online_longest_queued(OnlineEngine* engine) {
+    sync_index(engine);
+    const OnlineJob* jobs = engine->jobs;
+    int t = engine->root;
+    while (t >= 0) {
+        int target = jobs[t].max_remaining;
+        if (jobs[t].right >= 0 && jobs[jobs[t].right].max_remaining == target) {
+            t = jobs[t].right;
+        } else if (jobs[t].remaining_time == target) {
+            return t;
+        } else {
+            t = jobs[t].left;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Withdraws a queued job, which then never runs
+ * @param engine Engine to update
+ * @param handle Job to withdraw
+ * @return true if the job was withdrawn, false if it is unknown, running or finished
+ */
+bool online_cancel(OnlineEngine* engine, int handle) {
+    if (handle < 0 || handle >= engine->count || handle == engine->running ||
+        engine->jobs[handle].completion_time >= 0 || engine->jobs[handle].cancelled) {
+        return false;
+    }
+    account(engine, engine->now);
+    OnlineJob* job = &engine->jobs[handle];
+    job->cancelled = true;
+    job->queued = false;
+    engine->queued--;
+    if (uses_ring(engine)) {
+        mark_stale(engine, handle);
+    } else {
+        treap_erase(engine, handle);
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the time the CPU is next free and the running job's remaining time after its slice
+ * @param engine Engine
+ * @param left Where to store the running job's remaining time after the slice (0 if none)
+ * @return End of the current slice, or the current time if the CPU is idle
+ */
+static int cpu_free_at(const OnlineEngine* engine, int* left) {
+    *left = 0;
+    if (engine->running < 0) {
+        return engine->now;
+    }
+    *left = engine->jobs[engine->running].remaining_time - (engine->slice_end - engine->run_start);
+    return engine->slice_end;
+}
+
+/**
+ * @brief Returns the number of Round Robin slices a job needs
+ * @param engine Engine
+ * @param remaining Remaining time of the job
+ * @return ceil(remaining / quantum)
+ */
+static int64_t slices_needed(const OnlineEngine* engine, int remaining) {
+    int q = engine->params.time_quantum;
+    return ((int64_t)remaining + q - 1) / q;
+}
+
+/**
+ * @brief Clamps a predicted time to the range of int
+ * @param time Predicted time
+ * @return The time, or INT_MAX if it does not fit
+ */
+static int clamp_time(int64_t time) {
+    return time > INT32_MAX ? INT32_MAX : (int)time;
+}
+
+/**
+ * @brief Predicts when a job completes if nothing else is submitted
+ * @param engine Engine to query
+ * @param handle Handle returned by online_submit
+ * @return Predicted completion time, the actual one if the job is done, or -1 for an unknown,
+ *         withdrawn or released handle
+ */
+int online_predict(OnlineEngine* engine, int handle) {
+    if (handle < 0 || handle >= engine->count || engine->jobs[handle].released) {
+        return -1;
+    }
+    sync_index(engine);
+    const OnlineJob* job = &engine->jobs[handle];
+    if (job->completion_time >= 0 || job->cancelled) {
+        return job->completion_time;
+    }
+
+    int left;
+    int free_at = cpu_free_at(engine, &left);
+    int64_t q = engine->params.time_quantum;
+
+    if (handle == engine->running) {
+        if (engine->params.algorithm != ALG_RR || left == 0) {
+            return engine->slice_end;
+        }
+        // Requeued behind everything waiting now, which is then served first in every round
+        int64_t k = slices_needed(engine, left);
+        return clamp_time(free_at + capped_sum(engine, k * q) + left);
+    }
+
+    if (engine->params.algorithm != ALG_RR) {
+        int ahead;
+        return clamp_time(free_at + prefix_sum(engine, job->key, &ahead));
+    }
+
+    // Jobs ahead of this one in the FIFO get one more round than those behind it
+    int64_t k = slices_needed(engine, job->remaining_time);
+    int64_t total = (int64_t)free_at + job->remaining_time;
+    bool behind = false;
+    for (int i = 0; i < engine->ring_size; i++) {
+        int other = engine->ring[(engine->ring_head + i) % engine->ring_capacity];
+        if (other == handle) {
+            behind = true;
+            continue;
+        }
+        if (engine->jobs[other].cancelled) {
+            continue;
+        }
+        int64_t cap = (behind ? k - 1 : k) * q;
+        int remaining = engine->jobs[other].remaining_time;
+        total += remaining < cap ? remaining : cap;
+    }
+    total += left < (k - 1) * q ? left : (k - 1) * q;
+    return clamp_time(total);
+}
+
+/**
+ * @brief Predicts when a job submitted now would complete, without submitting it
+ * @param engine Engine to query
+ * @param burst_time CPU time the job would require (positive)
+ * @return Predicted completion time, or -1 for an invalid burst
+ */
+int online_predict_submit(OnlineEngine* engine, int burst_time) {
+    if (burst_time <= 0) {
+        return -1;
+    }
+    if (engine->running < 0) {
+        return clamp_time((int64_t)engine->now + burst_time);
+    }
+    sync_index(engine);
+
+    int left;
+    int free_at = cpu_free_at(engine, &left);
+    int ahead;
+    switch (engine->params.algorithm) {
+        case ALG_RR: {
+            // Queued behind every waiting job but ahead of the preempted running one
+            int64_t q = engine->params.time_quantum;
+            int64_t k = slices_needed(engine, burst_time);
+            int64_t running_share = left < (k - 1) * q ? left : (k - 1) * q;
+            return clamp_time(free_at + capped_sum(engine, k * q) + running_share + burst_time);
+        }
+        case ALG_SRTF: {
+            int current = engine->jobs[engine->running].remaining_time - (engine->now - engine->run_start);
+            if (burst_time < current) {
+                return clamp_time((int64_t)engine->now + burst_time);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    int64_t key = job_key(engine, burst_time, (uint32_t)engine->submitted);
+    return clamp_time(free_at + prefix_sum(engine, key, &ahead) + burst_time);
+}
+
+/**
+ * @brief Replays processes through an engine, submitting each at its arrival time
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (sorted by arrival time and updated in place)
+ * @param n Number of processes
+ * @param predicted Where to store the completion predicted for each process at its arrival
+ * @param metrics Where to store the metrics of the replay
+ * @return 0 on success, -1 on failure
+ */
+int online_replay(const SchedParams* params, Process* processes, int n, int* predicted, Metrics* metrics) {
+    OnlineEngine engine;
+    if (!online_init(&engine, params)) {
+        return -1;
+    }
+    qsort(processes, n, sizeof(Process), compare_arrival_time);
+
+    for (int i = 0; i < n; i++) {
+        online_advance(&engine, processes[i].arrival_time);
+        predicted[i] = online_predict_submit(&engine, processes[i].burst_time);
+        if (online_submit(&engine, processes[i].burst_time) != i) {
+            online_free(&engine);
+            return -1;
+        }
+    }
+    online_advance(&engine, INT32_MAX);
+
+    for (int i = 0; i < n; i++) {
+        const OnlineJob* job = &engine.jobs[i];
+        processes[i].remaining_time = job->remaining_time;
+        processes[i].completion_time = job->completion_time;
+        processes[i].response_time = job->start_time - job->arrival_time;
+        processes[i].started = true;
+    }
+
+    // The engine integrated its queue from the first submission to the last completion
+    *metrics = calculate_metrics(processes, n);
+    metrics->queue_area = engine.queue_area;
+    metrics->busy_time = engine.busy_time;
+    metrics->span = n > 0 ? engine.accounted - processes[0].arrival_time : 0;
+    metrics->max_queue = engine.max_queue;
+    metrics->cpus = 1;
+    online_free(&engine);
+    return 0;
+}
+
+/**
+ * @brief Releases the memory held by an engine
+ * @param engine Engine to free
+ */
+void online_free(OnlineEngine* engine) {
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)engine->capacity * sizeof(OnlineJob));
+    footprint_release(SUBSYSTEM_QUEUES, (size_t)engine->ring_capacity * sizeof(int));
+    footprint_release(SUBSYSTEM_QUEUES, (size_t)engine->stale_capacity * sizeof(int));
+    free(engine->jobs);
+    free(engine->ring);
+    free(engine->stale);
+    memset(engine, 0, sizeof(*engine));
+}
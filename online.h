@@ -0,0 +1,220 @@
+/**
+ * @file online.h
+ * @brief Online scheduling engine with incremental submission and completion prediction
+ */
+
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @struct OnlineJob
+ * @brief A process submitted to an online engine
+ */
+typedef struct {
+    int arrival_time;    /**< Time the job was submitted */
+    int burst_time;      /**< CPU time required */
+    int remaining_time;  /**< CPU time left, as of the start of the current slice if running */
+    int start_time;      /**< Time the job first got the CPU, or -1 */
+    int completion_time; /**< Time the job completed, or -1 */
+    bool cancelled;      /**< Whether the job was withdrawn from the queue */
+    bool released;       /**< Whether the handle was given back with online_release */
+    bool queued;         /**< Whether the job is waiting for the CPU */
+    bool indexed;        /**< Whether the job is in the treap */
+    bool stale;          /**< Whether the job is on the engine's stale list */
+    uint32_t sequence;   /**< Submission number, which breaks ties between equal policy values */
+    int64_t key;         /**< Order among queued jobs: (policy value << 32) | sequence */
+    uint32_t weight;     /**< Random treap priority */
+    int left;            /**< Left child in the treap, or the next released handle */
+    int right;           /**< Right child in the treap, or -1 */
+    int size;            /**< Jobs in this subtree */
+    int64_t sum;         /**< Remaining time of the jobs in this subtree */
+    int max_remaining;   /**< Largest remaining time in this subtree */
+} OnlineJob;
+
+/**
+ * @struct OnlineEngine
+ * @brief Persistent scheduling state that advances with the clock
+ *
+ * SJF and SRTF keep their queued jobs in a treap ordered by the policy's
+ * key, burst time for SJF and remaining time for SRTF. FCFS and RR serve a
+ * FIFO, kept as a growable ring of handles; withdrawn jobs stay in the ring
+ * and are skipped on dispatch. Each treap node also holds the size, total
+ * and largest remaining time of its subtree, which the prediction and
+ * longest-job queries read. For FCFS and RR the treap is only such an index,
+ * keyed by submission order and by remaining time respectively: it is built
+ * from the ring by the first query, and jobs queued, dispatched or withdrawn
+ * after that are put on a stale list and re-indexed by the next query, so a
+ * caller that never asks pays only for the ring.
+ * Handles of completed jobs given back with online_release are reused by
+ * later submissions, so a caller that releases them keeps the job table as
+ * small as the number of jobs in the system at once.
+ */
+typedef struct {
+    SchedParams params;  /**< Policy and quantum */
+    int now;             /**< Current time */
+    OnlineJob* jobs;     /**< Every submitted job not yet released, indexed by handle */
+    int count;           /**< Number of handles handed out, released or not */
+    int capacity;        /**< Allocated number of jobs */
+    int submitted;       /**< Number of jobs submitted */
+    int free_list;       /**< Most recently released handle, or -1 */
+    int queued;          /**< Number of jobs waiting for the CPU */
+    int root;            /**< Root of the treap of queued jobs, or -1 */
+    bool indexed;        /**< FCFS and RR: whether the treap is kept, once a query has built it */
+    int* stale;          /**< FCFS and RR: jobs whose treap entry is out of date */
+    int stale_count;     /**< Number of entries in stale */
+    int stale_capacity;  /**< Allocated number of entries in stale */
+    int* ring;           /**< FCFS and Round Robin queue of handles */
+    int ring_head;       /**< Index of the first entry in ring */
+    int ring_size;       /**< Number of entries in ring */
+    int ring_capacity;   /**< Allocated number of entries in ring */
+    int running;         /**< Job holding the CPU, or -1 */
+    int run_start;       /**< Time the current slice started */
+    int slice_end;       /**< Time the current slice ends if no job preempts it */
+    int64_t accounted;   /**< Time up to which the queue and busy integrals are taken */
+    int64_t queue_area;  /**< Integral of the queue length since the first submission */
+    int64_t busy_time;   /**< Time the CPU has been running a job */
+    int max_queue;       /**< Longest queue held for a positive time */
+} OnlineEngine;
+
+/**
+ * @brief Initializes an engine with no jobs at time 0
+ * @param engine Engine to initialize
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @return true if successful, false for an unsupported algorithm or quantum
+ */
+bool online_init(OnlineEngine* engine, const SchedParams* params);
+
+/**
+ * @brief Advances the clock, running the schedule up to the given time
+ *
+ * Slices that end before the time are retired. A slice ending exactly at
+ * the new time is retired by the next call, after any submissions made at
+ * that time, so jobs arriving when a slice ends are queued as the batch
+ * simulators queue them.
+ *
+ * @param engine Engine to advance
+ * @param time New current time; earlier times are ignored
+ */
+void online_advance(OnlineEngine* engine, int time);
+
+/**
+ * @brief Retires a slice that ends at the current time
+ *
+ * online_advance leaves such a slice for the next call. A caller that
+ * reacts to completions, such as a closed-loop client that submits its next
+ * job when the last one finishes, calls this after making the submissions
+ * due at the current time, so it sees each completion when it happens. At
+ * most one slice ends at a given time.
+ *
+ * @param engine Engine to update
+ * @return Handle of the job that completed with the slice, or -1
+ */
+int online_complete_due(OnlineEngine* engine);
+
+/**
+ * @brief Submits a job at the current time
+ *
+ * A job handed the CPU at the current time has not run yet. Under FCFS,
+ * SJF and SRTF the choice is made again with each job submitted at the
+ * same time, and the displaced job keeps no start time, so jobs arriving
+ * together at an idle CPU are ordered as in the batch simulators.
+ *
+ * @param engine Engine to submit to
+ * @param burst_time CPU time required (positive)
+ * @return Handle of the job, or -1 on an invalid burst or allocation failure
+ */
+int online_submit(OnlineEngine* engine, int burst_time);
+
+/**
+ * @brief Gives back the handle of a completed job for reuse by a later submission
+ *
+ * The job's record must not be read afterwards. Callers that keep every
+ * job to the end, such as online_replay, never release.
+ *
+ * @param engine Engine to update
+ * @param handle Job to release
+ * @return true if the handle was released, false if it is unknown, not completed or already released
+ */
+bool online_release(OnlineEngine* engine, int handle);
+
+/**
+ * @brief Returns the number of jobs waiting for the CPU
+ * @param engine Engine to query
+ * @return Queued jobs, not counting the running one
+ */
+int online_queue_length(const OnlineEngine* engine);
+
+/**
+ * @brief Finds the queued job with the most remaining time, in O(log n)
+ *
+ * Under FCFS and RR this brings the treap index up to date first (see
+ * OnlineEngine).
+ *
+ * @param engine Engine to query
+ * @return Handle of the job (the latest submitted on ties), or -1 if the queue is empty
+ */
+int online_longest_queued(OnlineEngine* engine);
+
+/**
+ * @brief Withdraws a queued job, which then never runs
+ * @param engine Engine to update
+ * @param handle Job to withdraw
+ * @return true if the job was withdrawn, false if it is unknown, running or finished
+ */
+bool online_cancel(OnlineEngine* engine, int handle);
+
+/**
+ * @brief Predicts when a job completes if nothing else is submitted
+ *
+ * O(log n) for the running job under every policy and for queued jobs
+ * under FCFS, SJF and SRTF. A queued Round Robin job depends on which jobs
+ * are ahead of it in the FIFO as well as on their remaining times, so that
+ * case walks the queue in O(n). Under FCFS and RR the treap index is
+ * brought up to date first (see OnlineEngine).
+ *
+ * @param engine Engine to query
+ * @param handle Handle returned by online_submit
+ * @return Predicted completion time, the actual one if the job is done, or -1 for an unknown,
+ *         withdrawn or released handle
+ */
+int online_predict(OnlineEngine* engine, int handle);
+
+/**
+ * @brief Predicts when a job submitted now would complete, without submitting it
+ *
+ * The job would be last among equals under every policy, so the answer is
+ * a prefix sum over the treap, or a sum of min(remaining, k * quantum) for
+ * Round Robin, in O(log n) once the treap index is up to date.
+ *
+ * @param engine Engine to query
+ * @param burst_time CPU time the job would require (positive)
+ * @return Predicted completion time, or -1 for an invalid burst
+ */
+int online_predict_submit(OnlineEngine* engine, int burst_time);
+
+/**
+ * @brief Replays processes through an engine, submitting each at its arrival time
+ *
+ * Before each submission the engine is asked when the process would
+ * complete, which shows how far later arrivals move the answer. The
+ * completion and response times written back match the batch simulators.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (sorted by arrival time and updated in place)
+ * @param n Number of processes
+ * @param predicted Where to store the completion predicted for each process at its arrival
+ * @param metrics Where to store the metrics of the replay
+ * @return 0 on success, -1 on failure
+ */
+int online_replay(const SchedParams* params, Process* processes, int n, int* predicted, Metrics* metrics);
+
+/**
+ * @brief Releases the memory held by an engine
+ * @param engine Engine to free
+ */
+void online_free(OnlineEngine* engine);
+
+#endif /* ONLINE_H */
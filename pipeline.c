@@ -0,0 +1,747 @@
+/**
+ * @file pipeline.c
+ * @brief Implementation of the pipelined load, simulate and print run
+ */
+
+#include "pipeline.h"
+#include "footprint.h"
+#include "online.h"
+
+#include <pthread.h>
+#include <time.h>
+
+/** Batches each queue holds before its producer waits */
+#define PIPELINE_DEPTH 2
+
+/** Completed processes per batch sent to the writer */
+#define PIPELINE_ROWS 4096
+
+/** Initial bytes for the names of an output batch */
+#define PIPELINE_NAME_BYTES 65536
+
+/**
+ * @brief Bounded queue of batches between two stages
+ */
+typedef struct {
+    pthread_mutex_t lock;         /**< Protects every field below */
+    pthread_cond_t change;        /**< Signalled on every push, pop, close and cancel */
+    void* items[PIPELINE_DEPTH];  /**< Ring of batches */
+    int head;                     /**< Index of the oldest batch */
+    int size;                     /**< Number of batches queued */
+    bool closed;                  /**< The producer will push nothing more */
+    bool cancelled;               /**< The consumer stopped; pushes fail */
+} Channel;
+
+/**
+ * @brief What the simulator needs of a process when no rows are printed
+ */
+typedef struct {
+    int arrival_time; /**< Time at which the process arrives */
+    int burst_time;   /**< CPU time required by the process */
+} Arrival;
+
+/**
+ * @brief A batch of parsed processes with copies of their names
+ *
+ * Without rows to print, only the arrival and burst of each process are
+ * passed on, in 8 bytes instead of a whole Process, and names are not copied.
+ */
+typedef struct {
+    int count;          /**< Number of processes */
+    Process* processes; /**< Processes in input order, or NULL if arrivals is used */
+    Arrival* arrivals;  /**< Arrival and burst of each process when no rows are printed, or NULL */
+    const char** names; /**< Name of each process, pointing into arena, or NULL */
+    char* arena;        /**< NUL-terminated names, or NULL */
+    size_t bytes;       /**< Bytes held by the batch apart from its arena */
+    size_t arena_size;  /**< Bytes held by arena */
+} InputBatch;
+
+/**
+ * @brief The names of one input batch, kept while any of its processes is in the engine
+ */
+typedef struct {
+    char* arena;  /**< NUL-terminated names */
+    size_t size;  /**< Bytes held by arena */
+    int pending;  /**< Processes of the batch not yet completed, plus one while it is being submitted */
+} NameArena;
+
+/**
+ * @brief A completed process as printed by the writer
+ */
+typedef struct {
+    size_t name;     /**< Offset of the process name in the batch's names */
+    Process process; /**< Process with its completion, turnaround and waiting times */
+} Row;
+
+/**
+ * @brief A batch of completed processes with copies of their names
+ */
+typedef struct {
+    int count;                /**< Rows in use */
+    char* names;              /**< NUL-terminated names of the rows */
+    size_t names_size;        /**< Bytes used in names */
+    size_t names_capacity;    /**< Bytes allocated for names */
+    Row rows[PIPELINE_ROWS];  /**< Rows in completion order */
+} OutputBatch;
+
+/**
+ * @brief State shared by the three stages
+ */
+typedef struct {
+    const char* filename;       /**< Input file */
+    ReadOptions options;        /**< Loader options */
+    FILE* file;                 /**< Stream receiving the rows, or NULL to print none */
+    Channel input;              /**< Reader to simulator */
+    Channel output;             /**< Simulator to writer */
+    int read_status;            /**< Result of read_processes_streaming */
+    double read_wait_ms;        /**< Time the reader waited for room in the input queue */
+    double read_ms;             /**< Elapsed time of the reader */
+    double write_wait_ms;       /**< Time the writer waited for rows */
+    double write_ms;            /**< Elapsed time of the writer */
+} Pipeline;
+
+/**
+ * @brief State of the simulation stage
+ */
+typedef struct {
+    Pipeline* pipeline;   /**< Shared state */
+    OnlineEngine engine;  /**< Schedule being run; handles are released as their jobs complete */
+    Process* jobs;        /**< Process of each job in the engine, indexed by handle (only when printing rows) */
+    const char** names;   /**< Name of each job in the engine, indexed by handle (only when printing rows) */
+    NameArena** owners;   /**< Arena holding each job's name, indexed by handle (only when printing rows) */
+    int capacity;         /**< Allocated entries in jobs, names and owners */
+    int first_arrival;    /**< Arrival time of the first process submitted */
+    int last_arrival;     /**< Arrival time of the last process submitted */
+    OutputBatch* batch;   /**< Batch being filled for the writer, or NULL */
+    Process* completed;   /**< Completed processes not yet folded into metrics */
+    int completed_count;  /**< Entries in use in completed */
+    Metrics metrics;      /**< Metrics of the processes folded so far */
+    double wait_ms;       /**< Time spent waiting on either queue */
+} Simulation;
+
+/**
+ * @brief Returns a monotonic time in milliseconds
+ * @return Milliseconds since an arbitrary origin
+ */
+static double now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Initializes an empty, open queue
+ * @param channel Queue to initialize
+ */
+static void channel_init(Channel* channel) {
+    memset(channel, 0, sizeof(*channel));
+    pthread_mutex_init(&channel->lock, NULL);
+    pthread_cond_init(&channel->change, NULL);
+}
+
+/**
+ * @brief Adds a batch, waiting while the queue is full
+ * @param channel Queue to push to
+ * @param item Batch to add; the consumer takes ownership
+ * @param wait_ms Incremented by the time spent waiting
+ * @return true if the batch was queued, false if the consumer has stopped
+ */
+static bool channel_push(Channel* channel, void* item, double* wait_ms) {
+    pthread_mutex_lock(&channel->lock);
+    if (channel->size == PIPELINE_DEPTH && !channel->cancelled) {
+        double start = now_ms();
+        while (channel->size == PIPELINE_DEPTH && !channel->cancelled) {
+            pthread_cond_wait(&channel->change, &channel->lock);
+        }
+        *wait_ms += now_ms() - start;
+    }
+    bool queued = !channel->cancelled;
+    if (queued) {
+        channel->items[(channel->head + channel->size) % PIPELINE_DEPTH] = item;
+        channel->size++;
+        pthread_cond_broadcast(&channel->change);
+    }
+    pthread_mutex_unlock(&channel->lock);
+    return queued;
+}
+
+/**
+ * @brief Removes the oldest batch, waiting while the queue is empty and open
+ * @param channel Queue to pop from
+ * @param wait_ms Incremented by the time spent waiting
+ * @return Oldest batch, or NULL once the queue is closed and empty
+ */
+static void* channel_pop(Channel* channel, double* wait_ms) {
+    pthread_mutex_lock(&channel->lock);
+    if (channel->size == 0 && !channel->closed) {
+        double start = now_ms();
+        while (channel->size == 0 && !channel->closed) {
+            pthread_cond_wait(&channel->change, &channel->lock);
+        }
+        *wait_ms += now_ms() - start;
+    }
+    void* item = NULL;
+    if (channel->size > 0) {
+        item = channel->items[channel->head];
+        channel->head = (channel->head + 1) % PIPELINE_DEPTH;
+        channel->size--;
+        pthread_cond_broadcast(&channel->change);
+    }
+    pthread_mutex_unlock(&channel->lock);
+    return item;
+}
+
+/**
+ * @brief Marks the end of the producer's batches
+ * @param channel Queue to close
+ */
+static void channel_close(Channel* channel) {
+    pthread_mutex_lock(&channel->lock);
+    channel->closed = true;
+    pthread_cond_broadcast(&channel->change);
+    pthread_mutex_unlock(&channel->lock);
+}
+
+/**
+ * @brief Stops the producer: pending and later pushes fail
+ * @param channel Queue to cancel
+ */
+static void channel_cancel(Channel* channel) {
+    pthread_mutex_lock(&channel->lock);
+    channel->cancelled = true;
+    pthread_cond_broadcast(&channel->change);
+    pthread_mutex_unlock(&channel->lock);
+}
+
+/**
+ * @brief Releases a queue whose stages have both finished
+ * @param channel Queue to release
+ */
+static void channel_destroy(Channel* channel) {
+    pthread_cond_destroy(&channel->change);
+    pthread_mutex_destroy(&channel->lock);
+}
+
+/**
+ * @brief Releases an input batch; the arena is released separately
+ * @param batch Batch to release
+ */
+static void free_input_batch(InputBatch* batch) {
+    footprint_release(SUBSYSTEM_WORKLOAD, batch->bytes);
+    free(batch->processes);
+    free(batch->arrivals);
+    free(batch->names);
+    free(batch);
+}
+
+/**
+ * @brief Releases a name arena that no longer belongs to a batch
+ * @param arena Arena to free, or NULL
+ * @param size Bytes held by the arena
+ */
+static void free_arena(char* arena, size_t size) {
+    footprint_release(SUBSYSTEM_OUTPUT, size);
+    free(arena);
+}
+
+/**
+ * @brief Drops one reference to the names of an input batch, freeing them with the last
+ * @param owner Names of the batch
+ */
+static void release_names(NameArena* owner) {
+    if (--owner->pending == 0) {
+        free_arena(owner->arena, owner->size);
+        free(owner);
+    }
+}
+
+/**
+ * @brief Releases an output batch and the copies of its names
+ * @param batch Batch to release
+ */
+static void free_output_batch(OutputBatch* batch) {
+    footprint_release(SUBSYSTEM_OUTPUT, sizeof(OutputBatch) + batch->names_capacity);
+    free(batch->names);
+    free(batch);
+}
+
+/**
+ * @brief Copies the arrival and burst of each process in a batch from the loader
+ * @param processes Processes parsed since the last batch
+ * @param n Number of processes
+ * @param batch Batch to fill
+ * @return true if successful, false if memory allocation failed
+ */
+static bool copy_arrivals(const Process* processes, int n, InputBatch* batch) {
+    batch->arrivals = (Arrival*)malloc((size_t)n * sizeof(Arrival));
+    if (!batch->arrivals) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        batch->arrivals[i].arrival_time = processes[i].arrival_time;
+        batch->arrivals[i].burst_time = processes[i].burst_time;
+    }
+    batch->bytes = (size_t)n * sizeof(Arrival);
+    return true;
+}
+
+/**
+ * @brief Copies the processes of a batch from the loader, with their names
+ * @param processes Processes parsed since the last batch
+ * @param n Number of processes
+ * @param batch Batch to fill
+ * @return true if successful, false if memory allocation failed
+ */
+static bool copy_rows(const Process* processes, int n, InputBatch* batch) {
+    // Names are copied here because only this thread may look them up while the table grows
+    size_t arena_size = 0;
+    for (int i = 0; i < n; i++) {
+        arena_size += strlen(process_name(&processes[i])) + 1;
+    }
+    batch->processes = (Process*)malloc((size_t)n * sizeof(Process));
+    batch->names = (const char**)malloc((size_t)n * sizeof(const char*));
+    batch->arena = (char*)malloc(arena_size);
+    if (!batch->processes || !batch->names || !batch->arena) {
+        return false;
+    }
+    memcpy(batch->processes, processes, (size_t)n * sizeof(Process));
+    char* cursor = batch->arena;
+    for (int i = 0; i < n; i++) {
+        const char* name = process_name(&processes[i]);
+        size_t len = strlen(name) + 1;
+        memcpy(cursor, name, len);
+        batch->names[i] = cursor;
+        cursor += len;
+    }
+    batch->bytes = (size_t)n * (sizeof(Process) + sizeof(const char*));
+    batch->arena_size = arena_size;
+    return true;
+}
+
+/**
+ * @brief Copies a batch from the loader and queues it for the simulator
+ * @param context Pipeline
+ * @param processes Processes parsed since the last batch
+ * @param n Number of processes
+ * @return 0 on success, -1 if the simulator stopped or memory ran out
+ */
+static int reader_batch(void* context, const Process* processes, int n) {
+    Pipeline* pipeline = (Pipeline*)context;
+    InputBatch* batch = (InputBatch*)calloc(1, sizeof(InputBatch));
+    bool copied = batch && (pipeline->file ? copy_rows(processes, n, batch) : copy_arrivals(processes, n, batch));
+    if (!copied) {
+        perror("Memory allocation failed");
+        if (batch) {
+            free(batch->arena);
+            free_input_batch(batch);
+        }
+        return -1;
+    }
+    batch->count = n;
+    footprint_charge(SUBSYSTEM_WORKLOAD, batch->bytes);
+    footprint_charge(SUBSYSTEM_OUTPUT, batch->arena_size);
+
+    if (!channel_push(&pipeline->input, batch, &pipeline->read_wait_ms)) {
+        free_arena(batch->arena, batch->arena_size);
+        free_input_batch(batch);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reader thread: loads the input and closes the input queue
+ * @param arg Pipeline
+ * @return NULL
+ */
+static void* reader_thread(void* arg) {
+    Pipeline* pipeline = (Pipeline*)arg;
+    double start = now_ms();
+    pipeline->read_status = read_processes_streaming(pipeline->filename, &pipeline->options, reader_batch, pipeline);
+    pipeline->read_ms = now_ms() - start;
+    channel_close(&pipeline->input);
+    return NULL;
+}
+
+/**
+ * @brief Writer thread: prints the rows of each batch until the output queue closes
+ * @param arg Pipeline
+ * @return NULL
+ */
+static void* writer_thread(void* arg) {
+    Pipeline* pipeline = (Pipeline*)arg;
+    double start = now_ms();
+    OutputBatch* batch;
+    while ((batch = (OutputBatch*)channel_pop(&pipeline->output, &pipeline->write_wait_ms)) != NULL) {
+        for (int i = 0; i < batch->count; i++) {
+            const Row* row = &batch->rows[i];
+            const Process* p = &row->process;
+            fprintf(pipeline->file, "%-10s %-12d %-10d %-10d %-15d %-15d %-15d\n", batch->names + row->name,
+                    p->arrival_time, p->burst_time, p->priority, p->completion_time, p->turnaround_time,
+                    p->waiting_time);
+        }
+        free_output_batch(batch);
+    }
+    fflush(pipeline->file);
+    pipeline->write_ms = now_ms() - start;
+    return NULL;
+}
+
+/**
+ * @brief Folds the completed processes held back so far into the metrics
+ * @param sim Simulation
+ */
+static void fold_completed(Simulation* sim) {
+    if (sim->completed_count > 0) {
+        sim->metrics = merge_metrics(sim->metrics, calculate_metrics(sim->completed, sim->completed_count));
+        sim->completed_count = 0;
+    }
+}
+
+/**
+ * @brief Records a completed job without keeping it
+ *
+ * Completions are gathered into a fixed block and folded into the metrics
+ * whenever it fills; the sums and histograms merge exactly, so the result
+ * matches calculate_metrics over the whole run.
+ *
+ * @param sim Simulation
+ * @param job Job that completed
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int fold_completion(Simulation* sim, const OnlineJob* job) {
+    if (!sim->completed) {
+        sim->completed = (Process*)malloc(PIPELINE_ROWS * sizeof(Process));
+        if (!sim->completed) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        footprint_charge(SUBSYSTEM_ALGORITHM, PIPELINE_ROWS * sizeof(Process));
+    }
+    Process* p = &sim->completed[sim->completed_count++];
+    memset(p, 0, sizeof(*p));
+    p->arrival_time = job->arrival_time;
+    p->burst_time = job->burst_time;
+    p->completion_time = job->completion_time;
+    p->turnaround_time = p->completion_time - p->arrival_time;
+    p->waiting_time = p->turnaround_time - p->burst_time;
+    p->response_time = job->start_time - job->arrival_time;
+    p->started = true;
+    if (sim->completed_count == PIPELINE_ROWS) {
+        fold_completed(sim);
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends a row to the batch being filled for the writer, copying its name
+ * @param sim Simulation
+ * @param name Name of the process
+ * @param p Completed process
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int queue_row(Simulation* sim, const char* name, const Process* p) {
+    if (!sim->batch) {
+        sim->batch = (OutputBatch*)calloc(1, sizeof(OutputBatch));
+        if (!sim->batch) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        footprint_charge(SUBSYSTEM_OUTPUT, sizeof(OutputBatch));
+    }
+    OutputBatch* batch = sim->batch;
+    size_t len = strlen(name) + 1;
+    if (batch->names_size + len > batch->names_capacity) {
+        size_t capacity = batch->names_capacity ? batch->names_capacity : PIPELINE_NAME_BYTES;
+        while (batch->names_size + len > capacity) {
+            capacity *= 2;
+        }
+        char* names = (char*)realloc(batch->names, capacity);
+        if (!names) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        footprint_charge(SUBSYSTEM_OUTPUT, capacity - batch->names_capacity);
+        batch->names = names;
+        batch->names_capacity = capacity;
+    }
+    Row* row = &batch->rows[batch->count++];
+    row->name = batch->names_size;
+    row->process = *p;
+    memcpy(batch->names + batch->names_size, name, len);
+    batch->names_size += len;
+    if (batch->count == PIPELINE_ROWS) {
+        channel_push(&sim->pipeline->output, batch, &sim->wait_ms);
+        sim->batch = NULL;
+    }
+    return 0;
+}
+
+/**
+ * @brief Records a completed job, queues its row for the writer and releases its handle
+ *
+ * The row takes a copy of the name, so the batch the process came in can
+ * be freed once its last process completes.
+ *
+ * @param sim Simulation
+ * @param handle Job that completed
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int emit_completion(Simulation* sim, int handle) {
+    const OnlineJob* job = &sim->engine.jobs[handle];
+    if (fold_completion(sim, job) != 0) {
+        return -1;
+    }
+    if (sim->pipeline->file) {
+        Process* p = &sim->jobs[handle];
+        p->completion_time = job->completion_time;
+        p->turnaround_time = p->completion_time - p->arrival_time;
+        p->waiting_time = p->turnaround_time - p->burst_time;
+        p->response_time = job->start_time - job->arrival_time;
+        p->remaining_time = 0;
+        p->started = true;
+        if (queue_row(sim, sim->names[handle], p) != 0) {
+            return -1;
+        }
+        release_names(sim->owners[handle]);
+        sim->owners[handle] = NULL;
+    }
+    online_release(&sim->engine, handle);
+    return 0;
+}
+
+/**
+ * @brief Runs the schedule up to a time, emitting every job that completes before it
+ * @param sim Simulation
+ * @param limit Slices ending before this time are retired
+ * @return 0 on success, -1 on failure
+ */
+static int retire_before(Simulation* sim, int64_t limit) {
+    OnlineEngine* engine = &sim->engine;
+    while (engine->running >= 0 && engine->slice_end < limit) {
+        online_advance(engine, engine->slice_end);
+        int handle = online_complete_due(engine);
+        if (handle >= 0 && emit_completion(sim, handle) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Grows the per-handle tables to the engine's job table
+ * @param sim Simulation printing rows
+ * @return true if successful, false if memory allocation failed
+ */
+static bool reserve_handles(Simulation* sim) {
+    int capacity = sim->engine.capacity;
+    if (capacity <= sim->capacity) {
+        return true;
+    }
+    Process* jobs = (Process*)realloc(sim->jobs, (size_t)capacity * sizeof(Process));
+    if (jobs) sim->jobs = jobs;
+    const char** names = (const char**)realloc(sim->names, (size_t)capacity * sizeof(const char*));
+    if (names) sim->names = names;
+    NameArena** owners = (NameArena**)realloc(sim->owners, (size_t)capacity * sizeof(NameArena*));
+    if (owners) sim->owners = owners;
+    if (!jobs || !names || !owners) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    size_t added = (size_t)(capacity - sim->capacity);
+    footprint_charge(SUBSYSTEM_ALGORITHM, added * sizeof(Process));
+    footprint_charge(SUBSYSTEM_OUTPUT, added * (sizeof(const char*) + sizeof(NameArena*)));
+    memset(sim->owners + sim->capacity, 0, added * sizeof(NameArena*));
+    sim->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Submits the processes of a batch at their arrival times
+ * @param sim Simulation
+ * @param batch Batch from the reader; takes ownership of its arena, which is freed once its last process completes
+ * @return 0 on success, -1 on unsorted input or memory allocation failure
+ */
+static int simulate_batch(Simulation* sim, InputBatch* batch) {
+    OnlineEngine* engine = &sim->engine;
+    bool rows = sim->pipeline->file != NULL;
+    NameArena* owner = NULL;
+    if (rows) {
+        owner = (NameArena*)malloc(sizeof(NameArena));
+        if (!owner) {
+            perror("Memory allocation failed");
+            free_arena(batch->arena, batch->arena_size);
+            return -1;
+        }
+        owner->arena = batch->arena;
+        owner->size = batch->arena_size;
+        owner->pending = 1;
+    }
+
+    // Arrivals at the end of a slice are submitted before it is retired, as in the batch simulators
+    int status = 0;
+    for (int i = 0; i < batch->count; i++) {
+        int arrival = rows ? batch->processes[i].arrival_time : batch->arrivals[i].arrival_time;
+        int burst = rows ? batch->processes[i].burst_time : batch->arrivals[i].burst_time;
+        if (engine->submitted > 0 && arrival < sim->last_arrival) {
+            char label[32];
+            snprintf(label, sizeof(label), "process %d", engine->submitted + 1);
+            fprintf(stderr, "%s: %s arrives at %d, earlier than the process before it (%d); "
+                            "--pipeline needs input sorted by arrival_time\n",
+                    sim->pipeline->filename, rows ? batch->names[i] : label, arrival, sim->last_arrival);
+            status = -1;
+            break;
+        }
+        if (retire_before(sim, arrival) != 0) {
+            status = -1;
+            break;
+        }
+        online_advance(engine, arrival);
+        int handle = online_submit(engine, burst);
+        if (handle < 0) {
+            status = -1;
+            break;
+        }
+        if (engine->submitted == 1) {
+            sim->first_arrival = arrival;
+        }
+        sim->last_arrival = arrival;
+        if (rows) {
+            if (!reserve_handles(sim)) {
+                status = -1;
+                break;
+            }
+            sim->jobs[handle] = batch->processes[i];
+            sim->names[handle] = batch->names[i];
+            sim->owners[handle] = owner;
+            owner->pending++;
+        }
+    }
+    if (owner) {
+        release_names(owner);
+    }
+    return status;
+}
+
+/**
+ * @brief Loads, schedules and prints a workload in three overlapping stages
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param filename Input file, or "-" for standard input, in any format read_processes accepts
+ * @param options Loader options, or NULL for the defaults
+ * @param file Stream receiving the process rows, or NULL to compute the metrics only
+ * @param stats Where to store the metrics and stage timings
+ * @return 0 on success, -1 on failure
+ */
+int pipeline_run(const SchedParams* params, const char* filename, const ReadOptions* options, FILE* file,
+                 PipelineStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    Pipeline pipeline = {0};
+    pipeline.filename = filename;
+    // Names are copied out of each batch as it is handed over, so the loader need not keep them
+    if (options) {
+        pipeline.options = *options;
+    }
+    pipeline.options.batch_ids = true;
+    pipeline.file = file;
+    pipeline.read_status = -1;
+
+    Simulation sim = {0};
+    sim.pipeline = &pipeline;
+    if (!online_init(&sim.engine, params)) {
+        return -1;
+    }
+    channel_init(&pipeline.input);
+    channel_init(&pipeline.output);
+
+    if (file) {
+        fprintf(file, "\n%-10s %-12s %-10s %-10s %-15s %-15s %-15s\n", "Process", "Arrival", "Burst", "Priority",
+                "Completion", "Turnaround", "Waiting");
+        fprintf(file, "----------------------------------------------------------------------------------\n");
+    }
+
+    // Without rows there is nothing for a writer to do
+    double start = now_ms();
+    pthread_t reader;
+    pthread_t writer;
+    bool reader_started = pthread_create(&reader, NULL, reader_thread, &pipeline) == 0;
+    bool writer_started = reader_started && file && pthread_create(&writer, NULL, writer_thread, &pipeline) == 0;
+    int status = reader_started && (writer_started || !file) ? 0 : -1;
+    if (status != 0) {
+        fprintf(stderr, "Error: Cannot start the pipeline threads\n");
+    }
+
+    InputBatch* batch;
+    while (status == 0 && (batch = (InputBatch*)channel_pop(&pipeline.input, &sim.wait_ms)) != NULL) {
+        status = simulate_batch(&sim, batch);
+        free_input_batch(batch);
+    }
+    if (reader_started) {
+        // A failed simulation stops the reader at its next batch
+        channel_cancel(&pipeline.input);
+        pthread_join(reader, NULL);
+        while ((batch = (InputBatch*)channel_pop(&pipeline.input, &sim.wait_ms)) != NULL) {
+            free_arena(batch->arena, batch->arena_size);
+            free_input_batch(batch);
+        }
+    }
+    if (status == 0 && pipeline.read_status < 0) {
+        status = -1;
+    }
+    if (status == 0 && retire_before(&sim, INT64_MAX) != 0) {
+        status = -1;
+    }
+    if (status == 0 && sim.batch) {
+        channel_push(&pipeline.output, sim.batch, &sim.wait_ms);
+        sim.batch = NULL;
+    }
+    if (sim.batch) {
+        free_output_batch(sim.batch);
+    }
+    fold_completed(&sim);
+    double simulate_ms = now_ms() - start;
+    channel_close(&pipeline.output);
+    if (writer_started) {
+        pthread_join(writer, NULL);
+    }
+    if (file) {
+        fprintf(file, "----------------------------------------------------------------------------------\n");
+    }
+
+    int n = sim.engine.submitted;
+    if (status == 0 && n > 0) {
+        // The engine integrated its queue from the first submission to the last completion
+        stats->count = n;
+        stats->wall_ms = now_ms() - start;
+        stats->read_ms = pipeline.read_ms - pipeline.read_wait_ms;
+        stats->simulate_ms = simulate_ms - sim.wait_ms;
+        stats->write_ms = pipeline.write_ms - pipeline.write_wait_ms;
+        stats->metrics = sim.metrics;
+        stats->metrics.queue_area = sim.engine.queue_area;
+        stats->metrics.busy_time = sim.engine.busy_time;
+        stats->metrics.span = sim.engine.accounted - sim.first_arrival;
+        stats->metrics.max_queue = sim.engine.max_queue;
+        stats->metrics.cpus = 1;
+    } else if (status == 0) {
+        status = -1;
+    }
+
+    // Jobs left in the engine by a failed run still hold the names of their batches
+    for (int h = 0; h < sim.capacity; h++) {
+        if (sim.owners[h]) {
+            release_names(sim.owners[h]);
+        }
+    }
+    footprint_release(SUBSYSTEM_OUTPUT, (size_t)sim.capacity * (sizeof(const char*) + sizeof(NameArena*)));
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)sim.capacity * sizeof(Process));
+    if (sim.completed) {
+        footprint_release(SUBSYSTEM_ALGORITHM, PIPELINE_ROWS * sizeof(Process));
+    }
+    free(sim.jobs);
+    free(sim.names);
+    free(sim.owners);
+    free(sim.completed);
+    online_free(&sim.engine);
+    channel_destroy(&pipeline.input);
+    channel_destroy(&pipeline.output);
+    return status;
+}
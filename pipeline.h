@@ -0,0 +1,65 @@
+/**
+ * @file pipeline.h
+ * @brief Pipelined run that overlaps loading, simulation and output
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @struct PipelineStats
+ * @brief Outcome of a pipelined run
+ */
+typedef struct {
+    int count;          /**< Processes read and scheduled */
+    double wall_ms;     /**< Elapsed time from the start of loading to the last row written */
+    double read_ms;     /**< Time the reader spent reading and parsing, excluding waits */
+    double simulate_ms; /**< Time the simulator spent scheduling, excluding waits */
+    double write_ms;    /**< Time the writer spent formatting and writing, excluding waits */
+    Metrics metrics;    /**< Metrics of the whole run */
+} PipelineStats;
+
+/**
+ * @brief Loads, schedules and prints a workload in three overlapping stages
+ *
+ * A reader thread parses the input in batches of about a megabyte and
+ * passes them on through a queue two batches deep. The calling thread
+ * submits each process to an online engine at its arrival time and
+ * retires the slices that end before it, so it only needs the arrivals
+ * parsed so far. Completed processes go in batches through a second
+ * two-deep queue to a writer thread, which prints one row per process in
+ * completion order. Each queue blocks its producer when full, so memory
+ * stays bounded whichever stage is slowest and the elapsed time approaches
+ * that of the slowest stage. FCFS and RR run from the engine's FIFO ring in
+ * O(1) per slice; nothing here asks for predictions, so the engine never
+ * builds its treap index for them.
+ *
+ * Nothing is kept for a process once its row is queued: the engine reuses
+ * its handle, the row carries a copy of its name, and the names of a batch
+ * are freed with its last process. The loader forgets identifiers after
+ * each batch. Memory then depends on the jobs in the system at once, not on
+ * the length of the trace, except for binary workloads, which are decoded
+ * whole before the first batch.
+ *
+ * The input must be sorted by arrival time, as traces usually are; an
+ * arrival earlier than the one before it stops the run.
+ *
+ * Completions are folded into the metrics in fixed-size blocks. With no
+ * output stream, no rows are printed, batches carry only arrival and burst
+ * times and names are not copied. Setting ReadOptions.discard_ids as well
+ * keeps the loader from interning the names.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param filename Input file, or "-" for standard input, in any format read_processes accepts
+ * @param options Loader options, or NULL for the defaults
+ * @param file Stream receiving the process rows, or NULL to compute the metrics only
+ * @param stats Where to store the metrics and stage timings
+ * @return 0 on success, -1 on failure
+ */
+int pipeline_run(const SchedParams* params, const char* filename, const ReadOptions* options, FILE* file,
+                 PipelineStats* stats);
+
+#endif /* PIPELINE_H */
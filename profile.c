@@ -0,0 +1,174 @@
+/**
+ * @file profile.c
+ * @brief Implementation of workload statistics
+ */
+
+#include "profile.h"
+
+#include <math.h>
+
+/**
+ * @brief Initializes an empty profile
+ * @param profile Profile to initialize
+ */
+void profile_init(WorkloadProfile* profile) {
+    memset(profile, 0, sizeof(*profile));
+}
+
+/**
+ * @brief Combines running statistics of two disjoint sets of values (Chan et al.)
+ * @param stats Statistics of the first set, updated
+ * @param other Statistics of the second set
+ */
+static void running_stats_merge(RunningStats* stats, const RunningStats* other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (stats->count == 0) {
+        *stats = *other;
+        return;
+    }
+    int64_t count = stats->count + other->count;
+    double delta = other->mean - stats->mean;
+    stats->mean += delta * other->count / count;
+    stats->m2 += other->m2 + delta * delta * ((double)stats->count * other->count / count);
+    stats->count = count;
+    if (other->min < stats->min) stats->min = other->min;
+    if (other->max > stats->max) stats->max = other->max;
+}
+
+/**
+ * @brief Appends the profile of the following part of the input
+ * @param profile Profile of the earlier part, updated
+ * @param next Profile of the part that follows it
+ */
+void profile_append(WorkloadProfile* profile, const WorkloadProfile* next) {
+    if (next->burst.count == 0) {
+        return;
+    }
+    if (profile->burst.count == 0) {
+        *profile = *next;
+        return;
+    }
+
+    // The first process of next follows the last process of profile
+    if (next->first_arrival < profile->last_arrival) {
+        profile->out_of_order++;
+    } else {
+        int gap = next->first_arrival - profile->last_arrival;
+        running_stats_add(&profile->gap, gap);
+        profile->gap_histogram[gap == 0 ? 0 : profile_bucket(gap) + 1]++;
+    }
+
+    running_stats_merge(&profile->burst, &next->burst);
+    running_stats_merge(&profile->gap, &next->gap);
+    profile->total_burst += next->total_burst;
+    profile->last_arrival = next->last_arrival;
+    if (next->min_arrival < profile->min_arrival) profile->min_arrival = next->min_arrival;
+    if (next->max_arrival > profile->max_arrival) profile->max_arrival = next->max_arrival;
+    profile->out_of_order += next->out_of_order;
+    profile->io_processes += next->io_processes;
+    for (int k = 0; k < PROFILE_BUCKETS; k++) {
+        profile->burst_histogram[k] += next->burst_histogram[k];
+        profile->gap_histogram[k] += next->gap_histogram[k];
+    }
+}
+
+/**
+ * @brief Prints one row of the statistics table
+ * @param label Row label
+ * @param stats Statistics to print
+ */
+static void print_stats_row(const char* label, const RunningStats* stats) {
+    if (stats->count == 0) {
+        printf("%-14s %-10s\n", label, "0");
+        return;
+    }
+    double stddev = sqrt(stats->m2 / stats->count);
+    printf("%-14s %-10lld %-10.2f %-10.2f %-7.3f %-8d %-8d\n", label, (long long)stats->count, stats->mean, stddev,
+           stats->mean > 0 ? stddev / stats->mean : 0.0, stats->min, stats->max);
+}
+
+/**
+ * @brief Prints a power-of-two histogram with a bar per bucket
+ * @param title Heading
+ * @param histogram Bucket counts
+ * @param zero_bucket Whether bucket 0 holds zeros and bucket k values in [2^(k-1), 2^k)
+ */
+static void print_histogram(const char* title, const int64_t* histogram, bool zero_bucket) {
+    int64_t total = 0;
+    int64_t largest = 0;
+    int first = -1;
+    int last = -1;
+    for (int k = 0; k < PROFILE_BUCKETS; k++) {
+        total += histogram[k];
+        if (histogram[k] > largest) largest = histogram[k];
+        if (histogram[k] > 0) {
+            if (first < 0) first = k;
+            last = k;
+        }
+    }
+    if (total == 0) {
+        return;
+    }
+
+    printf("\n%s:\n", title);
+    for (int k = first; k <= last; k++) {
+        char range[32];
+        int shift = zero_bucket ? k - 1 : k;
+        if (zero_bucket && k == 0) {
+            snprintf(range, sizeof(range), "0");
+        } else if (shift == 0) {
+            snprintf(range, sizeof(range), "1");
+        } else {
+            snprintf(range, sizeof(range), "%lld-%lld", 1LL << shift, (2LL << shift) - 1);
+        }
+        char bar[41];
+        int width = (int)(40 * histogram[k] / largest);
+        memset(bar, '#', (size_t)width);
+        bar[width] = '\0';
+        printf("  %-24s %-10lld %5.1f%%  %s\n", range, (long long)histogram[k], 100.0 * histogram[k] / total, bar);
+    }
+}
+
+/**
+ * @brief Prints offered load, burst and inter-arrival statistics and histograms
+ * @param profile Profile to print
+ * @param name Input name
+ */
+void print_workload_profile(const WorkloadProfile* profile, const char* name) {
+    const RunningStats* burst = &profile->burst;
+    printf("\nWorkload profile of %s:\n", name);
+    printf("Processes: %lld (%lld block for I/O)\n", (long long)burst->count, (long long)profile->io_processes);
+    if (burst->count == 0) {
+        return;
+    }
+
+    int span = profile->max_arrival - profile->min_arrival;
+    printf("Arrivals: %d to %d (span %d)\n", profile->min_arrival, profile->max_arrival, span);
+    printf("Total work: %lld\n", (long long)profile->total_burst);
+    if (span > 0) {
+        // Offered load = arrival rate x mean service time = work per unit of arrival window
+        double load = (double)profile->total_burst / span;
+        printf("Offered load: %.3f (arrival rate %.4f x mean burst %.2f)\n", load, (double)burst->count / span,
+               burst->mean);
+        printf("Expected single-CPU utilisation: %.1f%%%s\n", load < 1.0 ? 100.0 * load : 100.0,
+               load < 1.0 ? "" : " (saturated: the backlog grows while arrivals continue)");
+    } else {
+        printf("Offered load: unbounded (every process arrives at once)\n");
+    }
+
+    printf("\n%-14s %-10s %-10s %-10s %-7s %-8s %-8s\n", "Statistic", "Count", "Mean", "Std Dev", "CV", "Min", "Max");
+    printf("----------------------------------------------------------------------------------\n");
+    print_stats_row("Burst", burst);
+    print_stats_row("Inter-arrival", &profile->gap);
+    printf("----------------------------------------------------------------------------------\n");
+    printf("Inter-arrival CV is 1 for Poisson arrivals; above 1 the trace is bursty, below 1 regular\n");
+    if (profile->out_of_order > 0) {
+        printf("Out-of-order arrivals: %lld (the input is not sorted by arrival time; they add no gap)\n",
+               (long long)profile->out_of_order);
+    }
+
+    print_histogram("Burst time histogram", profile->burst_histogram, false);
+    print_histogram("Inter-arrival histogram", profile->gap_histogram, true);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file profile.h
+ * @brief Workload statistics gathered while processes are parsed
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "common.h"
+
+/** Number of power-of-two histogram buckets */
+#define PROFILE_BUCKETS 32
+
+/**
+ * @struct RunningStats
+ * @brief Count, mean and variance accumulated one value at a time (Welford)
+ */
+typedef struct {
+    int64_t count; /**< Number of values */
+    double mean;   /**< Mean of the values */
+    double m2;     /**< Sum of squared deviations from the mean */
+    int min;       /**< Smallest value */
+    int max;       /**< Largest value */
+} RunningStats;
+
+/**
+ * @struct WorkloadProfile
+ * @brief Summary of a trace, built in input order
+ *
+ * Inter-arrival gaps are taken between consecutive processes of the input.
+ * A process that arrives earlier than its predecessor is counted as out of
+ * order and contributes no gap, so an unsorted trace is visible as such
+ * rather than skewing the gap statistics.
+ */
+typedef struct WorkloadProfile {
+    RunningStats burst;                       /**< Burst times */
+    RunningStats gap;                         /**< Inter-arrival gaps */
+    int64_t total_burst;                      /**< Sum of burst times */
+    int first_arrival;                        /**< Arrival of the first process in input order */
+    int last_arrival;                         /**< Arrival of the last process in input order */
+    int min_arrival;                          /**< Earliest arrival */
+    int max_arrival;                          /**< Latest arrival */
+    int64_t out_of_order;                     /**< Processes arriving before their predecessor */
+    int64_t io_processes;                     /**< Processes that block for I/O */
+    int64_t burst_histogram[PROFILE_BUCKETS]; /**< Bucket k counts bursts in [2^k, 2^(k+1)) */
+    int64_t gap_histogram[PROFILE_BUCKETS];   /**< Bucket 0 counts gaps of 0, bucket k gaps in [2^(k-1), 2^k) */
+} WorkloadProfile;
+
+/**
+ * @brief Initializes an empty profile
+ * @param profile Profile to initialize
+ */
+void profile_init(WorkloadProfile* profile);
+
+/**
+ * @brief Adds a value to running statistics
+ * @param stats Statistics to update
+ * @param value Value to add
+ */
+static inline void running_stats_add(RunningStats* stats, int value) {
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+    if (stats->count == 1 || value < stats->min) stats->min = value;
+    if (stats->count == 1 || value > stats->max) stats->max = value;
+}
+
+/**
+ * @brief Returns the power-of-two bucket of a positive value
+ * @param value Value to classify (at least 1)
+ * @return floor(log2(value))
+ */
+static inline int profile_bucket(int value) {
+    return 31 - __builtin_clz((unsigned)value);
+}
+
+/**
+ * @brief Adds the next process of the input to a profile
+ * @param profile Profile to update
+ * @param process Process just parsed
+ * @param io_interval CPU time between the process's I/O requests, 0 if it never blocks
+ */
+static inline void profile_add(WorkloadProfile* profile, const Process* process, int io_interval) {
+    int arrival = process->arrival_time;
+    if (profile->burst.count == 0) {
+        profile->first_arrival = arrival;
+        profile->min_arrival = arrival;
+        profile->max_arrival = arrival;
+    } else if (arrival < profile->last_arrival) {
+        profile->out_of_order++;
+    } else {
+        int gap = arrival - profile->last_arrival;
+        running_stats_add(&profile->gap, gap);
+        profile->gap_histogram[gap == 0 ? 0 : profile_bucket(gap) + 1]++;
+    }
+    if (arrival < profile->min_arrival) profile->min_arrival = arrival;
+    if (arrival > profile->max_arrival) profile->max_arrival = arrival;
+    profile->last_arrival = arrival;
+
+    running_stats_add(&profile->burst, process->burst_time);
+    profile->total_burst += process->burst_time;
+    profile->burst_histogram[profile_bucket(process->burst_time)]++;
+    if (io_interval > 0) {
+        profile->io_processes++;
+    }
+}
+
+/**
+ * @brief Appends the profile of the following part of the input
+ *
+ * Used to combine profiles built by parser threads over consecutive
+ * chunks: statistics are merged exactly, and the gap between the last
+ * process of profile and the first of next is added.
+ *
+ * @param profile Profile of the earlier part, updated
+ * @param next Profile of the part that follows it
+ */
+void profile_append(WorkloadProfile* profile, const WorkloadProfile* next);
+
+/**
+ * @brief Prints offered load, burst and inter-arrival statistics and histograms
+ * @param profile Profile to print
+ * @param name Input name
+ */
+void print_workload_profile(const WorkloadProfile* profile, const char* name);
+
+#endif /* PROFILE_H */
@@ -4,18 +4,8 @@
  */
 
 #include "rr.h"
-
-/**
- * @brief Comparison function for sorting processes by arrival time
- * @param a First process
- * @param b Second process
- * @return Negative if a arrives before b, positive if a arrives after b
- */
-static int compare_arrival_time(const void* a, const void* b) {
-    Process* p1 = (Process*)a;
-    Process* p2 = (Process*)b;
-    return p1->arrival_time - p2->arrival_time;
-}
+#include "footprint.h"
+#include "heap.h"
 
 /**
  * @brief Simple queue implementation for Round Robin scheduling
@@ -47,6 +37,7 @@ static Queue* create_queue(int capacity) {
         return NULL;
     }
     
+    footprint_charge(SUBSYSTEM_QUEUES, capacity * sizeof(int));
     queue->capacity = capacity;
     queue->size = 0;
     queue->front = 0;
@@ -115,11 +106,214 @@ static bool dequeue(Queue* queue, int* value) {
  */
 static void free_queue(Queue* queue) {
     if (queue) {
+        footprint_release(SUBSYSTEM_QUEUES, queue->capacity * sizeof(int));
         free(queue->data);
         free(queue);
     }
 }
 
+/**
+ * @brief Processes waiting for the CPU or for I/O in io_round_robin
+ */
+typedef struct {
+    Process* processes; /**< Processes being scheduled, sorted by arrival */
+    int n;              /**< Number of processes */
+    int next_arrival;   /**< Index of the first process that has not arrived */
+    Queue* ready;       /**< Processes with a full quantum due */
+    Queue* auxiliary;   /**< Processes back from I/O with part of their quantum left, or NULL */
+    Heap blocked;       /**< Processes in I/O, keyed by (return time << 32) | index */
+    int* slice_left;    /**< Unused part of the quantum of each process when it blocked */
+    QueueIntegral integral; /**< Ready-queue length and busy time */
+} IoQueues;
+
+/**
+ * @brief Moves processes that have arrived or finished their I/O by a given time to the queues
+ * @param queues Queues to update
+ * @param current_time Current time
+ */
+static void admit_ready(IoQueues* queues, int current_time) {
+    while (queues->next_arrival < queues->n && queues->processes[queues->next_arrival].arrival_time <= current_time) {
+        enqueue(queues->ready, queues->next_arrival++);
+    }
+    while (queues->blocked.size > 0 && (heap_top(&queues->blocked) >> 32) <= current_time) {
+        int64_t key = heap_pop(&queues->blocked);
+        int idx = (int)(key & 0xFFFFFFFF);
+        queue_integral_ready(&queues->integral, key >> 32);
+        if (queues->auxiliary && queues->slice_left[idx] > 0) {
+            enqueue(queues->auxiliary, idx);
+        } else {
+            enqueue(queues->ready, idx);
+        }
+    }
+}
+
+/**
+ * @brief Executes Round Robin on processes that block for I/O
+ *
+ * A process blocks for its I/O time after every I/O interval of CPU time,
+ * unless its burst is complete. Every process is in at most one of the
+ * queues or the blocked heap at a time, so each queue holds at most n
+ * entries.
+ *
+ * @param processes Array of processes
+ * @param io I/O of each process, indexed like processes, or NULL if none blocks
+ * @param n Number of processes
+ * @param time_quantum Time slice allocated to each process
+ * @param auxiliary Whether processes returning from I/O are served first (Virtual RR)
+ * @return Metrics structure containing the performance metrics, with time
+ *         spent in I/O excluded from the waiting times and slowdowns
+ */
+static Metrics io_round_robin(Process* processes, const ProcessIo* io, int n, int time_quantum, bool auxiliary) {
+    Metrics empty = {0};
+    if (n <= 0) {
+        return empty;
+    }
+
+    // Sort processes by arrival time initially; their I/O follows them, and without any none blocks
+    ProcessIo* io_of = (ProcessIo*)calloc(n, sizeof(ProcessIo));
+    if (!io_of) {
+        perror("Memory allocation failed");
+        return empty;
+    }
+    footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(ProcessIo));
+    if (!sort_by_arrival(processes, io, io_of, n)) {
+        footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(ProcessIo));
+        free(io_of);
+        return empty;
+    }
+
+    IoQueues queues;
+    memset(&queues, 0, sizeof(queues));
+    queues.processes = processes;
+    queues.n = n;
+    queue_integral_init(&queues.integral, processes, n);
+    queues.ready = create_queue(n);
+    queues.auxiliary = auxiliary ? create_queue(n) : NULL;
+    queues.slice_left = (int*)calloc(n, sizeof(int));
+    int* cpu_since_io = (int*)calloc(n, sizeof(int));
+    bool ok = queues.ready && (queues.auxiliary || !auxiliary) && heap_init(&queues.blocked, 64);
+    if (!queues.slice_left || !cpu_since_io) {
+        perror("Memory allocation failed");
+        ok = false;
+    } else {
+        footprint_charge(SUBSYSTEM_ALGORITHM, 2 * (size_t)n * sizeof(int));
+    }
+
+    int current_time = 0;
+    int completed = 0;
+
+    while (ok && completed < n) {
+        admit_ready(&queues, current_time);
+
+        // If nothing is ready, advance time to the next arrival or I/O completion
+        bool aux_ready = auxiliary && !is_empty(queues.auxiliary);
+        if (!aux_ready && is_empty(queues.ready)) {
+            int64_t next = INT64_MAX;
+            if (queues.next_arrival < n) {
+                next = processes[queues.next_arrival].arrival_time;
+            }
+            if (queues.blocked.size > 0 && (heap_top(&queues.blocked) >> 32) < next) {
+                next = heap_top(&queues.blocked) >> 32;
+            }
+            if (next == INT64_MAX) {
+                break;
+            }
+            current_time = (int)next;
+            continue;
+        }
+
+        // Processes back from I/O only get the rest of the quantum they blocked in
+        int process_idx;
+        int allowed = time_quantum;
+        if (aux_ready) {
+            dequeue(queues.auxiliary, &process_idx);
+            allowed = queues.slice_left[process_idx];
+        } else {
+            dequeue(queues.ready, &process_idx);
+        }
+        Process* p = &processes[process_idx];
+        const ProcessIo* pio = &io_of[process_idx];
+
+        // Set response time when process first gets CPU
+        if (!p->started) {
+            p->response_time = current_time - p->arrival_time;
+            p->started = true;
+        }
+
+        // Run until the slice ends, the burst completes or the process requests I/O
+        int execution_time = p->remaining_time < allowed ? p->remaining_time : allowed;
+        if (pio->interval > 0 && pio->interval - cpu_since_io[process_idx] < execution_time) {
+            execution_time = pio->interval - cpu_since_io[process_idx];
+        }
+        queue_integral_dispatch(&queues.integral, current_time);
+        p->remaining_time -= execution_time;
+        cpu_since_io[process_idx] += execution_time;
+        current_time += execution_time;
+
+        // Processes that arrived during the slice queue ahead of a preempted one
+        admit_ready(&queues, current_time);
+
+        bool requeue = p->remaining_time > 0 && !(pio->interval > 0 && cpu_since_io[process_idx] == pio->interval);
+        queue_integral_release(&queues.integral, current_time, requeue);
+        if (p->remaining_time == 0) {
+            p->completion_time = current_time;
+            completed++;
+        } else if (pio->interval > 0 && cpu_since_io[process_idx] == pio->interval) {
+            cpu_since_io[process_idx] = 0;
+            queues.slice_left[process_idx] = allowed - execution_time;
+            int64_t return_time = (int64_t)current_time + pio->time;
+            ok = heap_push(&queues.blocked, (return_time << 32) | (uint32_t)process_idx);
+        } else {
+            enqueue(queues.ready, process_idx);
+        }
+    }
+
+    heap_free(&queues.blocked);
+    if (queues.slice_left && cpu_since_io) {
+        footprint_release(SUBSYSTEM_ALGORITHM, 2 * (size_t)n * sizeof(int));
+    }
+    free(queues.slice_left);
+    free(cpu_since_io);
+    free_queue(queues.auxiliary);
+    free_queue(queues.ready);
+
+    if (!ok) {
+        footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(ProcessIo));
+        free(io_of);
+        return empty;
+    }
+
+    // Time spent blocked is neither running nor waiting for the CPU, so waiting times and slowdowns leave it out
+    Metrics metrics = calculate_metrics(processes, n);
+    int64_t io_total = 0;
+    memset(&metrics.waiting, 0, sizeof(metrics.waiting));
+    memset(&metrics.slowdown, 0, sizeof(metrics.slowdown));
+    metrics.total_slowdown = 0.0;
+    metrics.total_slowdown_sq = 0.0;
+    metrics.starved = 0;
+    int threshold = starvation_threshold();
+    for (int i = 0; i < n; i++) {
+        Process* p = &processes[i];
+        int blocked = 0;
+        if (io_of[i].interval > 0) {
+            blocked = (p->burst_time - 1) / io_of[i].interval * io_of[i].time;
+            p->waiting_time -= blocked;
+            io_total += blocked;
+        }
+        histogram_record(&metrics.waiting, p->waiting_time);
+        record_slowdown(&metrics, p->turnaround_time - blocked, p->burst_time);
+        if (threshold > 0 && p->waiting_time > threshold) {
+            metrics.starved++;
+        }
+    }
+    metrics.total_waiting -= io_total;
+    metrics.avg_waiting_time = (float)((double)metrics.total_waiting / n);
+    queue_integral_store(&queues.integral, &metrics);
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(ProcessIo));
+    free(io_of);
+    return metrics;
+}
+
 /**
  * @brief Executes the Round Robin (RR) scheduling algorithm
  * 
@@ -129,16 +323,74 @@ static void free_queue(Queue* queue) {
  * ready queue.
  * 
  * @param processes Array of processes
+ * @param io I/O of each process, indexed like processes, or NULL if none blocks
+ * @param n Number of processes
+ * @param time_quantum Time slice allocated to each process
+ * @return Metrics structure containing the performance metrics
+ */
+Metrics rr_schedule(Process* processes, const ProcessIo* io, int n, int time_quantum) {
+    for (int i = 0; io && i < n; i++) {
+        if (io[i].interval > 0) {
+            return io_round_robin(processes, io, n, time_quantum, false);
+        }
+    }
+    return rr_schedule_with_options(processes, n, time_quantum, NULL, NULL);
+}
+
+/**
+ * @brief Executes the Virtual Round Robin (VRR) scheduling algorithm
+ * @param processes Array of processes
+ * @param io I/O of each process, indexed like processes, or NULL if none blocks
  * @param n Number of processes
  * @param time_quantum Time slice allocated to each process
  * @return Metrics structure containing the performance metrics
  */
-Metrics rr_schedule(Process* processes, int n, int time_quantum) {
+Metrics vrr_schedule(Process* processes, const ProcessIo* io, int n, int time_quantum) {
+    return io_round_robin(processes, io, n, time_quantum, true);
+}
+
+/**
+ * @brief Checks whether a run can no longer meet the limits in its options
+ *
+ * The bounds only ever grow: a finished process contributes its final
+ * times, and a process still waiting contributes the time it has waited so
+ * far, which its final waiting (or response) time can only exceed.
+ *
+ * @param options Limits to check against
+ * @param waiting_bound Lower bound on the total waiting time
+ * @param response_bound Lower bound on the total response time
+ * @param late Number of processes whose response time exceeds options->response_limit
+ * @return true if the run should be abandoned
+ */
+static bool exceeds_limits(const RrOptions* options, int64_t waiting_bound, int64_t response_bound, int64_t late) {
+    return waiting_bound > options->max_total_waiting || response_bound > options->max_total_response ||
+           late > options->max_late;
+}
+
+/**
+ * @brief Executes Round Robin with context switch costs and early termination
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param time_quantum Time slice allocated to each process
+ * @param options Switch cost and limits, or NULL for free switches and no limits
+ * @param stats Where to store switch counts and whether the run was abandoned, or NULL
+ * @return Metrics structure containing the performance metrics, or empty
+ *         metrics if the run was abandoned
+ */
+Metrics rr_schedule_with_options(Process* processes, int n, int time_quantum, const RrOptions* options,
+                                 RrStats* stats) {
+    RrStats local_stats;
+    if (!stats) {
+        stats = &local_stats;
+    }
+    memset(stats, 0, sizeof(*stats));
+    int switch_cost = options ? options->switch_cost : 0;
+
     // Sort processes by arrival time initially
     qsort(processes, n, sizeof(Process), compare_arrival_time);
     
     // Create a queue for ready processes
-    Queue* ready_queue = create_queue(n * 100);  // Large enough to handle all possible enqueues
+    Queue* ready_queue = create_queue(n);  // A process is never queued twice, so enqueue cannot fail
     if (!ready_queue) {
         Metrics empty = {0};
         return empty;
@@ -154,6 +406,7 @@ Metrics rr_schedule(Process* processes, int n, int time_quantum) {
         Metrics empty = {0};
         return empty;
     }
+    footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(int));
     
     // Initialize arrival index array
     for (int i = 0; i < n; i++) {
@@ -161,12 +414,29 @@ Metrics rr_schedule(Process* processes, int n, int time_quantum) {
     }
     
     int next_arrival_idx = 0;
+    int last_idx = -1;
+    QueueIntegral integral;
+    queue_integral_init(&integral, processes, n);
+    
+    // Running sums behind the lower bounds used for early termination
+    int64_t waiting_done = 0;       // Final waiting time of completed processes
+    int64_t pending_count = 0;      // Arrived processes not yet completed
+    int64_t pending_arrival = 0;    // Sum of their arrival times
+    int64_t pending_executed = 0;   // Sum of the CPU time they have received
+    int64_t response_done = 0;      // Response time of started processes
+    int64_t unstarted_count = 0;    // Arrived processes not yet started
+    int64_t unstarted_arrival = 0;  // Sum of their arrival times
+    int64_t late = 0;               // Started processes with response time over the limit
     
     // Continue until all processes are completed
     while (completed < n) {
         // Check for newly arrived processes and add them to the ready queue
         while (next_arrival_idx < n && processes[next_arrival_idx].arrival_time <= current_time) {
             enqueue(ready_queue, next_arrival_idx);
+            pending_count++;
+            pending_arrival += processes[next_arrival_idx].arrival_time;
+            unstarted_count++;
+            unstarted_arrival += processes[next_arrival_idx].arrival_time;
             next_arrival_idx++;
         }
         
@@ -186,10 +456,25 @@ Metrics rr_schedule(Process* processes, int n, int time_quantum) {
         dequeue(ready_queue, &process_idx);
         Process* p = &processes[process_idx];
         
+        // Charge the dispatcher when the CPU moves to a different process
+        if (last_idx >= 0 && last_idx != process_idx) {
+            stats->context_switches++;
+            queue_integral_switch(&integral, current_time);
+            current_time += switch_cost;
+        }
+        last_idx = process_idx;
+        queue_integral_dispatch(&integral, current_time);
+        
         // Set response time when process first gets CPU
         if (!p->started) {
             p->response_time = current_time - p->arrival_time;
             p->started = true;
+            response_done += p->response_time;
+            unstarted_count--;
+            unstarted_arrival -= p->arrival_time;
+            if (options && p->response_time > options->response_limit) {
+                late++;
+            }
         }
         
         // Determine how long this process will run
@@ -198,10 +483,15 @@ Metrics rr_schedule(Process* processes, int n, int time_quantum) {
         // Execute the process for the determined time
         p->remaining_time -= execution_time;
         current_time += execution_time;
+        pending_executed += execution_time;
         
         // Check for newly arrived processes during this execution and add them to the ready queue
         while (next_arrival_idx < n && processes[next_arrival_idx].arrival_time <= current_time) {
             enqueue(ready_queue, next_arrival_idx);
+            pending_count++;
+            pending_arrival += processes[next_arrival_idx].arrival_time;
+            unstarted_count++;
+            unstarted_arrival += processes[next_arrival_idx].arrival_time;
             next_arrival_idx++;
         }
         
@@ -209,15 +499,309 @@ Metrics rr_schedule(Process* processes, int n, int time_quantum) {
         if (p->remaining_time == 0) {
             p->completion_time = current_time;
             completed++;
+            waiting_done += (int64_t)p->completion_time - p->arrival_time - p->burst_time;
+            pending_count--;
+            pending_arrival -= p->arrival_time;
+            pending_executed -= p->burst_time;
+            queue_integral_release(&integral, current_time, false);
         } else {
             // Process still has remaining time, add it back to the ready queue
             enqueue(ready_queue, process_idx);
+            queue_integral_release(&integral, current_time, true);
+        }
+        
+        if (options) {
+            int64_t waiting_bound = waiting_done + pending_count * current_time - pending_arrival - pending_executed;
+            int64_t response_bound = response_done + unstarted_count * current_time - unstarted_arrival;
+            if (exceeds_limits(options, waiting_bound, response_bound, late)) {
+                stats->aborted = true;
+                stats->abort_time = current_time;
+                break;
+            }
         }
     }
     
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(int));
     free(arrival_index);
     free_queue(ready_queue);
     
+    if (stats->aborted) {
+        Metrics empty = {0};
+        return empty;
+    }
+    
     // Calculate and return metrics
-    return calculate_metrics(processes, n);
-}
\ No newline at end of file
+    Metrics metrics = calculate_metrics(processes, n);
+    queue_integral_store(&integral, &metrics);
+    return metrics;
+}
+/**
+ * @brief Remaining-time statistics of the ready set, updated incrementally
+ *
+ * The mean comes from a running sum. The median is kept by two heaps
+ * holding the lower and upper halves of the ready set, keyed by
+ * (remaining_time << 32) | index so that every key is unique. A process
+ * leaving the ready set is only counted out; its key stays in the heap and
+ * is discarded when it reaches the top, or in bulk when stale keys
+ * outnumber live ones. A process's key changes each time it runs, because
+ * its remaining time strictly decreases, so a key is live exactly when its
+ * process is ready and still has that remaining time.
+ */
+typedef struct {
+    const Process* processes; /**< Processes being scheduled */
+    bool* ready;              /**< Whether each process is in the ready set */
+    Heap lower;               /**< Lower half, as negated keys (a max-heap) */
+    Heap upper;               /**< Upper half */
+    int lower_size;           /**< Live keys in lower */
+    int upper_size;           /**< Live keys in upper */
+    int64_t sum;              /**< Sum of remaining times in the ready set */
+} ReadyStats;
+
+/**
+ * @brief Builds the heap key of a process
+ * @param processes Processes being scheduled
+ * @param idx Index of the process
+ * @return Key ordering by remaining time, then index
+ */
+static int64_t ready_key(const Process* processes, int idx) {
+    return ((int64_t)processes[idx].remaining_time << 32) | (uint32_t)idx;
+}
+
+/**
+ * @brief Checks whether a key still describes a ready process
+ * @param stats Ready-set statistics
+ * @param key Key to check
+ * @return true if the key is live
+ */
+static bool key_is_live(const ReadyStats* stats, int64_t key) {
+    int idx = (int)(key & 0xFFFFFFFF);
+    return stats->ready[idx] && stats->processes[idx].remaining_time == (int)(key >> 32);
+}
+
+/**
+ * @brief Drops stale keys from the top of a heap, and from the whole heap
+ *        once they outnumber live ones
+ * @param stats Ready-set statistics
+ * @param heap Heap to clean
+ * @param sign 1 for the upper heap, -1 for the negated lower heap
+ * @param live Number of live keys in the heap
+ */
+static void prune_heap(const ReadyStats* stats, Heap* heap, int sign, int live) {
+    if (heap->size > 2 * live + 64) {
+        int kept = 0;
+        for (int i = 0; i < heap->size; i++) {
+            if (key_is_live(stats, sign * heap->keys[i])) {
+                heap->keys[kept++] = heap->keys[i];
+            }
+        }
+        heap->size = kept;
+        heap_rebuild(heap);
+    }
+    while (heap->size > 0 && !key_is_live(stats, sign * heap_top(heap))) {
+        heap_pop(heap);
+    }
+}
+
+/**
+ * @brief Moves keys between the halves until lower has as many live keys
+ *        as upper, or one more
+ * @param stats Ready-set statistics
+ * @return true if successful, false if memory allocation failed
+ */
+static bool rebalance(ReadyStats* stats) {
+    prune_heap(stats, &stats->lower, -1, stats->lower_size);
+    prune_heap(stats, &stats->upper, 1, stats->upper_size);
+
+    while (stats->lower_size > stats->upper_size + 1) {
+        if (!heap_push(&stats->upper, -heap_pop(&stats->lower))) return false;
+        stats->lower_size--;
+        stats->upper_size++;
+        prune_heap(stats, &stats->lower, -1, stats->lower_size);
+    }
+    while (stats->upper_size > stats->lower_size) {
+        if (!heap_push(&stats->lower, -heap_pop(&stats->upper))) return false;
+        stats->upper_size--;
+        stats->lower_size++;
+        prune_heap(stats, &stats->upper, 1, stats->upper_size);
+    }
+    return true;
+}
+
+/**
+ * @brief Adds a process that has just become ready
+ * @param stats Ready-set statistics
+ * @param idx Index of the process
+ * @return true if successful, false if memory allocation failed
+ */
+static bool ready_stats_add(ReadyStats* stats, int idx) {
+    stats->ready[idx] = true;
+    int64_t key = ready_key(stats->processes, idx);
+    stats->sum += stats->processes[idx].remaining_time;
+
+    bool ok;
+    if (stats->lower_size == 0 || key <= -heap_top(&stats->lower)) {
+        ok = heap_push(&stats->lower, -key);
+        stats->lower_size++;
+    } else {
+        ok = heap_push(&stats->upper, key);
+        stats->upper_size++;
+    }
+    return ok && rebalance(stats);
+}
+
+/**
+ * @brief Removes a process that is leaving the ready set
+ * @param stats Ready-set statistics
+ * @param idx Index of the process
+ * @return true if successful, false if memory allocation failed
+ */
+static bool ready_stats_remove(ReadyStats* stats, int idx) {
+    int64_t key = ready_key(stats->processes, idx);
+    stats->sum -= stats->processes[idx].remaining_time;
+
+    // The tops are live, so comparing with the lower top finds the half
+    if (stats->lower_size > 0 && key <= -heap_top(&stats->lower)) {
+        stats->lower_size--;
+    } else {
+        stats->upper_size--;
+    }
+    stats->ready[idx] = false;
+    return rebalance(stats);
+}
+
+/**
+ * @brief Returns the quantum for the next round
+ * @param stats Ready-set statistics (non-empty)
+ * @param rule Statistic to use
+ * @return Median or rounded-up mean remaining time, at least 1
+ */
+static int ready_stats_quantum(const ReadyStats* stats, AdaptiveQuantum rule) {
+    int count = stats->lower_size + stats->upper_size;
+    int64_t quantum;
+    if (rule == RR_QUANTUM_MEAN) {
+        quantum = (stats->sum + count - 1) / count;
+    } else {
+        quantum = -heap_top(&stats->lower) >> 32;
+    }
+    return quantum > 0 ? (int)quantum : 1;
+}
+
+/**
+ * @brief Executes Round Robin with a quantum recomputed every round
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param rule Statistic of the ready set used as the quantum
+ * @return Metrics structure containing the performance metrics, with a
+ *         count of 0 if memory ran out during the run
+ */
+Metrics rr_adaptive_schedule(Process* processes, int n, AdaptiveQuantum rule) {
+    Metrics empty = {0};
+    if (n <= 0) {
+        return empty;
+    }
+
+    // Sort processes by arrival time initially
+    qsort(processes, n, sizeof(Process), compare_arrival_time);
+
+    // Each process is queued at most once at a time
+    Queue* ready_queue = create_queue(n);
+    if (!ready_queue) {
+        return empty;
+    }
+    bool* ready = (bool*)calloc(n, sizeof(bool));
+    if (!ready) {
+        perror("Memory allocation failed");
+        free_queue(ready_queue);
+        return empty;
+    }
+    footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
+
+    // ok turns false when a heap cannot grow; heap_init and heap_push report the allocation
+    ReadyStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.processes = processes;
+    stats.ready = ready;
+    bool ok = heap_init(&stats.lower, 64) && heap_init(&stats.upper, 64);
+
+    int current_time = 0;
+    int completed = 0;
+    int next_arrival_idx = 0;
+    int round_left = 0;
+    int quantum = 1;
+    QueueIntegral integral;
+    queue_integral_init(&integral, processes, n);
+
+    while (ok && completed < n) {
+        // Check for newly arrived processes and add them to the ready queue
+        while (ok && next_arrival_idx < n && processes[next_arrival_idx].arrival_time <= current_time) {
+            enqueue(ready_queue, next_arrival_idx);
+            ok = ready_stats_add(&stats, next_arrival_idx);
+            next_arrival_idx++;
+        }
+
+        // If ready queue is empty, advance time to the next arrival
+        if (is_empty(ready_queue)) {
+            if (next_arrival_idx >= n) {
+                break;
+            }
+            current_time = processes[next_arrival_idx].arrival_time;
+            continue;
+        }
+
+        // A round serves every process that was ready when it started
+        if (round_left == 0) {
+            round_left = ready_queue->size;
+            quantum = ready_stats_quantum(&stats, rule);
+        }
+
+        int process_idx;
+        dequeue(ready_queue, &process_idx);
+        ok = ready_stats_remove(&stats, process_idx);
+        round_left--;
+        Process* p = &processes[process_idx];
+
+        // Set response time when process first gets CPU
+        if (!p->started) {
+            p->response_time = current_time - p->arrival_time;
+            p->started = true;
+        }
+
+        // Execute the process for at most one quantum
+        int execution_time = (p->remaining_time < quantum) ? p->remaining_time : quantum;
+        queue_integral_dispatch(&integral, current_time);
+        p->remaining_time -= execution_time;
+        current_time += execution_time;
+        queue_integral_release(&integral, current_time, p->remaining_time > 0);
+
+        // Processes that arrived during the slice join the next round
+        while (ok && next_arrival_idx < n && processes[next_arrival_idx].arrival_time <= current_time) {
+            enqueue(ready_queue, next_arrival_idx);
+            ok = ready_stats_add(&stats, next_arrival_idx);
+            next_arrival_idx++;
+        }
+
+        if (p->remaining_time == 0) {
+            p->completion_time = current_time;
+            completed++;
+        } else if (ok) {
+            enqueue(ready_queue, process_idx);
+            ok = ready_stats_add(&stats, process_idx);
+        }
+    }
+
+    heap_free(&stats.lower);
+    heap_free(&stats.upper);
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
+    free(ready);
+    free_queue(ready_queue);
+
+    if (!ok) {
+        fprintf(stderr, "Error: Adaptive Round Robin stopped after %d of %d processes\n", completed, n);
+        return empty;
+    }
+
+    // Calculate and return metrics
+    Metrics metrics = calculate_metrics(processes, n);
+    queue_integral_store(&integral, &metrics);
+    return metrics;
+}
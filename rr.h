@@ -8,6 +8,41 @@
 
 #include "common.h"
 
+/**
+ * @struct RrOptions
+ * @brief Context switch cost and early-termination limits for Round Robin
+ *
+ * A run is abandoned as soon as a lower bound on one of its totals exceeds
+ * the corresponding limit, so a search can skip the rest of a run that
+ * cannot beat the best one found so far. Set unused limits to INT64_MAX.
+ */
+typedef struct {
+    int switch_cost;             /**< Time charged each time the CPU moves to a different process */
+    int64_t max_total_waiting;   /**< Abandon once total waiting time must exceed this */
+    int64_t max_total_response;  /**< Abandon once total response time must exceed this */
+    int response_limit;          /**< Response time counted as late for max_late */
+    int64_t max_late;            /**< Abandon once more processes than this are late */
+} RrOptions;
+
+/**
+ * @struct RrStats
+ * @brief Counters reported by rr_schedule_with_options
+ */
+typedef struct {
+    int64_t context_switches; /**< Dispatches of a process other than the previous one */
+    bool aborted;             /**< Whether the run was abandoned because of a limit */
+    int abort_time;           /**< Simulated time at which the run was abandoned */
+} RrStats;
+
+/**
+ * @enum AdaptiveQuantum
+ * @brief Statistic of the ready set used as the quantum by adaptive Round Robin
+ */
+typedef enum {
+    RR_QUANTUM_MEDIAN, /**< Median remaining time */
+    RR_QUANTUM_MEAN    /**< Mean remaining time, rounded up */
+} AdaptiveQuantum;
+
 /**
  * @brief Executes the Round Robin (RR) scheduling algorithm
  * 
@@ -15,12 +50,76 @@
  * fixed time slice (quantum) in a cyclic way. If a process's remaining burst time
  * exceeds the time quantum, the process is preempted and added to the end of the
  * ready queue.
+ *
+ * Processes with an I/O interval block for I/O as described for
+ * vrr_schedule, and rejoin the tail of the ready queue when it completes.
  * 
  * @param processes Array of processes
+ * @param io I/O of each process, indexed like processes, or NULL if none blocks
  * @param n Number of processes
  * @param time_quantum Time slice allocated to each process
  * @return Metrics structure containing the performance metrics
  */
-Metrics rr_schedule(Process* processes, int n, int time_quantum);
+Metrics rr_schedule(Process* processes, const ProcessIo* io, int n, int time_quantum);
+
+/**
+ * @brief Executes the Virtual Round Robin (VRR) scheduling algorithm
+ *
+ * A process blocks for its I/O time after every I/O interval of CPU time.
+ * In plain Round Robin it then rejoins the tail of the ready queue behind
+ * CPU-bound processes that use their whole quantum, so I/O-bound processes
+ * get a smaller share of the CPU. VRR puts a process that blocked before
+ * its quantum expired in an auxiliary FIFO instead. That queue is served
+ * before the ready queue, for the unused rest of the quantum only. Both
+ * queues are ring buffers, so each dispatch is O(1). Processes in I/O wait
+ * in a heap ordered by return time. Without I/O columns VRR is identical to
+ * Round Robin.
+ *
+ * Waiting times and slowdowns exclude the time spent in I/O.
+ *
+ * @param processes Array of processes
+ * @param io I/O of each process, indexed like processes, or NULL if none blocks
+ * @param n Number of processes
+ * @param time_quantum Time slice allocated to each process
+ * @return Metrics structure containing the performance metrics
+ */
+Metrics vrr_schedule(Process* processes, const ProcessIo* io, int n, int time_quantum);
+
+/**
+ * @brief Executes Round Robin with context switch costs and early termination
+ *
+ * Switch costs delay every later event, so they show up in the waiting,
+ * turnaround and response times. The lower bounds for the limits are kept
+ * as running sums and checked after every time slice in O(1).
+ *
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param time_quantum Time slice allocated to each process
+ * @param options Switch cost and limits, or NULL for free switches and no limits
+ * @param stats Where to store switch counts and whether the run was abandoned, or NULL
+ * @return Metrics structure containing the performance metrics, or empty
+ *         metrics if the run was abandoned
+ */
+Metrics rr_schedule_with_options(Process* processes, int n, int time_quantum, const RrOptions* options,
+                                 RrStats* stats);
+
+/**
+ * @brief Executes Round Robin with a quantum recomputed every round
+ *
+ * A round serves each process that was ready when it started, once, with
+ * the same quantum; processes arriving or returning during the round wait
+ * for the next one. The quantum of each round is the median or mean
+ * remaining time of the ready set at its start, so short jobs finish in one
+ * slice while long jobs are not cut into many tiny ones. The statistics are
+ * maintained incrementally, in O(log n) per dispatch for the median and
+ * O(1) for the mean, instead of rescanning the queue each round.
+ *
+ * @param processes Array of processes
+ * @param n Number of processes
+ * @param rule Statistic of the ready set used as the quantum
+ * @return Metrics structure containing the performance metrics, with a
+ *         count of 0 if memory ran out during the run
+ */
+Metrics rr_adaptive_schedule(Process* processes, int n, AdaptiveQuantum rule);
 
 #endif /* RR_H */
\ No newline at end of file
@@ -0,0 +1,246 @@
+/**
+ * @file scan.c
+ * @brief Implementation of vectorised delimiter scanning and SWAR integer parsing
+ */
+
+#include "scan.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SCAN_SWAR 1
+#endif
+
+/** Signature shared by all classification kernels */
+typedef uint64_t (*ClassifyKernel)(const char*);
+
+/**
+ * @brief Portable classification kernel
+ */
+static uint64_t classify_scalar(const char* block) {
+    uint64_t mask = 0;
+    for (int i = 0; i < SCAN_BLOCK; i++) {
+        if (block[i] == ',' || block[i] == '\n' || block[i] == '"') {
+            mask |= (uint64_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+#ifdef SCAN_X86
+
+/**
+ * @brief Classification kernel using SSE2 (four 16-byte lanes)
+ */
+__attribute__((target("sse2")))
+static uint64_t classify_sse2(const char* block) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('"');
+    uint64_t mask = 0;
+
+    for (int i = 0; i < SCAN_BLOCK; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(block + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, comma), _mm_cmpeq_epi8(x, newline)),
+                                   _mm_cmpeq_epi8(x, quote));
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(hit) << i;
+    }
+    return mask;
+}
+
+/**
+ * @brief Classification kernel using AVX2 (two 32-byte lanes)
+ */
+__attribute__((target("avx2")))
+static uint64_t classify_avx2(const char* block) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i quote = _mm256_set1_epi8('"');
+
+    __m256i lo = _mm256_loadu_si256((const __m256i*)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(block + 32));
+    __m256i hit_lo = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline)),
+                                     _mm256_cmpeq_epi8(lo, quote));
+    __m256i hit_hi = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline)),
+                                     _mm256_cmpeq_epi8(hi, quote));
+
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(hit_lo) |
+           ((uint64_t)(uint32_t)_mm256_movemask_epi8(hit_hi) << 32);
+}
+
+/**
+ * @brief Classification kernel using AVX-512BW (one 64-byte lane)
+ */
+__attribute__((target("avx512bw")))
+static uint64_t classify_avx512(const char* block) {
+    __m512i x = _mm512_loadu_si512((const void*)block);
+    return _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8(',')) |
+           _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8('\n')) |
+           _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8('"'));
+}
+
+#endif /* SCAN_X86 */
+
+/** Runs select_kernel once, as parser, shard and grid threads may make the first call together */
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+/** Kernel selected on first use */
+static ClassifyKernel classify_kernel = NULL;
+
+/** Name of the selected kernel */
+static const char* classify_isa = "scalar";
+
+/**
+ * @brief Selects the widest kernel supported by the running CPU
+ */
+static void select_kernel(void) {
+    classify_kernel = classify_scalar;
+    classify_isa = "scalar";
+
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        classify_kernel = classify_avx512;
+        classify_isa = "avx512bw";
+    } else if (__builtin_cpu_supports("avx2")) {
+        classify_kernel = classify_avx2;
+        classify_isa = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        classify_kernel = classify_sse2;
+        classify_isa = "sse2";
+    }
+#endif
+}
+
+/**
+ * @brief Classifies one block into a bitmask of comma, newline and quote positions
+ * @param block Start of the block (SCAN_BLOCK readable bytes)
+ * @param len Number of bytes to classify (at most SCAN_BLOCK)
+ * @return Bit i is set if block[i] is a delimiter
+ */
+uint64_t scan_classify(const char* block, size_t len) {
+    pthread_once(&kernel_once, select_kernel);
+
+    uint64_t mask = classify_kernel(block);
+    if (len < SCAN_BLOCK) {
+        mask &= ((uint64_t)1 << len) - 1;
+    }
+    return mask;
+}
+
+/**
+ * @brief Returns the name of the instruction set used by scan_classify
+ * @return "avx512bw", "avx2", "sse2" or "scalar"
+ */
+const char* scan_isa(void) {
+    pthread_once(&kernel_once, select_kernel);
+    return classify_isa;
+}
+
+/**
+ * @brief Starts scanning a buffer for delimiters
+ * @param cursor Cursor to initialize
+ * @param begin Start of the buffer
+ * @param end End of the buffer (SCAN_PADDING readable bytes must follow)
+ */
+void delim_cursor_init(DelimCursor* cursor, const char* begin, const char* end) {
+    size_t len = (size_t)(end - begin);
+    cursor->block = begin;
+    cursor->end = end;
+    cursor->mask = len > 0 ? scan_classify(begin, len < SCAN_BLOCK ? len : SCAN_BLOCK) : 0;
+}
+
+/**
+ * @brief Checks whether a character is ignored around numeric fields
+ * @param c Character to check
+ * @return true for spaces, tabs and carriage returns
+ */
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Parses a decimal integer with a scalar loop
+ * @param begin Start of the trimmed field
+ * @param end End of the trimmed field
+ * @param value Where to store the parsed value
+ * @return true if the field is a valid integer in int range
+ */
+static bool parse_int_scalar(const char* begin, const char* end, int* value) {
+    bool negative = false;
+    if (*begin == '-' || *begin == '+') {
+        negative = *begin == '-';
+        begin++;
+    }
+    if (begin == end) {
+        return false;
+    }
+
+    long long result = 0;
+    for (const char* p = begin; p < end; p++) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        result = result * 10 + (*p - '0');
+        if (result > (long long)INT_MAX + 1) {
+            return false;
+        }
+    }
+
+    result = negative ? -result : result;
+    if (result > INT_MAX) {
+        return false;
+    }
+    *value = (int)result;
+    return true;
+}
+
+/**
+ * @brief Parses a decimal integer field
+ * @param begin Start of the field
+ * @param end End of the field (8 readable bytes must follow begin)
+ * @param value Where to store the parsed value
+ * @return true if the field is a valid integer, false otherwise
+ */
+bool scan_parse_int(const char* begin, const char* end, int* value) {
+    while (begin < end && is_blank(*begin)) begin++;
+    while (end > begin && is_blank(end[-1])) end--;
+
+    size_t len = (size_t)(end - begin);
+    if (len == 0) {
+        return false;
+    }
+
+#ifdef SCAN_SWAR
+    if (len <= 8) {
+        const uint64_t zeros = 0x3030303030303030ULL;
+        const uint64_t high = 0xF0F0F0F0F0F0F0F0ULL;
+        uint64_t v;
+        memcpy(&v, begin, sizeof(v));
+
+        // Right-align the digits in the word and pad the front with '0'
+        if (len < 8) {
+            v = (v << (8 * (8 - len))) | (zeros >> (8 * len));
+        }
+
+        // Every byte must be in '0'..'9'
+        if ((v & high) == zeros && ((v + 0x0606060606060606ULL) & high) == zeros) {
+            v -= zeros;
+            v = ((v * 10) + (v >> 8)) & 0x00FF00FF00FF00FFULL;
+            v = ((v * 100) + (v >> 16)) & 0x0000FFFF0000FFFFULL;
+            v = ((v * 10000) + (v >> 32)) & 0x00000000FFFFFFFFULL;
+            *value = (int)v;
+            return true;
+        }
+    }
+#endif
+
+    return parse_int_scalar(begin, end, value);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file scan.h
+ * @brief Vectorised delimiter scanning and SWAR integer parsing for CSV input
+ */
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Number of bytes the scanner classifies per step */
+#define SCAN_BLOCK 64
+
+/**
+ * Number of readable bytes required after the end of any buffer handed to
+ * the scanner, so that full-width loads never fault
+ */
+#define SCAN_PADDING 64
+
+/**
+ * @struct DelimCursor
+ * @brief Iterates over the delimiter positions of a buffer
+ *
+ * The buffer is classified one SCAN_BLOCK at a time into a bitmask of
+ * comma, newline and double-quote positions, which is then consumed bit by
+ * bit. Quotes are reported so that callers can leave their fast path for
+ * quoted fields.
+ */
+typedef struct {
+    const char* block;  /**< Start of the block described by mask */
+    const char* end;    /**< End of the buffer */
+    uint64_t mask;      /**< Delimiters of the current block not yet returned */
+} DelimCursor;
+
+/**
+ * @brief Starts scanning a buffer for delimiters
+ * @param cursor Cursor to initialize
+ * @param begin Start of the buffer
+ * @param end End of the buffer (SCAN_PADDING readable bytes must follow)
+ */
+void delim_cursor_init(DelimCursor* cursor, const char* begin, const char* end);
+
+/**
+ * @brief Classifies one block into a bitmask of comma, newline and quote positions
+ * @param block Start of the block (SCAN_BLOCK readable bytes)
+ * @param len Number of bytes to classify (at most SCAN_BLOCK)
+ * @return Bit i is set if block[i] is a delimiter
+ */
+uint64_t scan_classify(const char* block, size_t len);
+
+/**
+ * @brief Returns the name of the instruction set used by scan_classify
+ * @return "avx512bw", "avx2", "sse2" or "scalar"
+ */
+const char* scan_isa(void);
+
+/**
+ * @brief Parses a decimal integer field
+ *
+ * Surrounding spaces, tabs and carriage returns are ignored. Fields of up to
+ * eight digits are converted with SWAR arithmetic on a single 64-bit load;
+ * longer or signed fields use a scalar loop.
+ *
+ * @param begin Start of the field
+ * @param end End of the field (8 readable bytes must follow begin)
+ * @param value Where to store the parsed value
+ * @return true if the field is a valid integer, false otherwise
+ */
+bool scan_parse_int(const char* begin, const char* end, int* value);
+
+/**
+ * @brief Returns the next comma, newline or double quote
+ * @param cursor Cursor to advance
+ * @return Pointer to the delimiter, or the end of the buffer if none is left
+ */
+static inline const char* delim_next(DelimCursor* cursor) {
+    while (cursor->mask == 0) {
+        if (cursor->end - cursor->block <= SCAN_BLOCK) {
+            return cursor->end;
+        }
+        cursor->block += SCAN_BLOCK;
+        size_t left = (size_t)(cursor->end - cursor->block);
+        cursor->mask = scan_classify(cursor->block, left < SCAN_BLOCK ? left : SCAN_BLOCK);
+    }
+
+    const char* delim = cursor->block + __builtin_ctzll(cursor->mask);
+    cursor->mask &= cursor->mask - 1;
+    return delim;
+}
+
+#endif /* SCAN_H */
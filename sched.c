@@ -0,0 +1,98 @@
+/**
+ * @file sched.c
+ * @brief Implementation of scheduling algorithm selection and dispatch
+ */
+
+#include "sched.h"
+#include "fcfs.h"
+#include "sjf.h"
+#include "rr.h"
+
+/** Command-line names, indexed by Algorithm */
+static const char* const algorithm_keys[ALG_COUNT] = {
+    "fcfs", "sjf", "srtf", "rr", "arr-median", "arr-mean", "vrr"
+};
+
+/** Display names, indexed by Algorithm */
+static const char* const algorithm_titles[ALG_COUNT] = {
+    "FCFS", "SJF (non-preemptive)", "SRTF (preemptive SJF)", "Round Robin",
+    "Adaptive RR (median quantum)", "Adaptive RR (mean quantum)", "Virtual Round Robin"
+};
+
+/**
+ * @brief Looks up an algorithm by its command-line name
+ * @param name Name such as "fcfs" or "rr"
+ * @param algorithm Where to store the algorithm
+ * @return true if the name is known, false otherwise
+ */
+bool parse_algorithm(const char* name, Algorithm* algorithm) {
+    for (int i = 0; i < ALG_COUNT; i++) {
+        if (strcmp(name, algorithm_keys[i]) == 0) {
+            *algorithm = (Algorithm)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether an algorithm is selected by a command-line name
+ * @param selection Algorithm name from the command line, or "all"
+ * @param algorithm Algorithm to check
+ * @return true if the algorithm should run
+ */
+bool algorithm_selected(const char* selection, Algorithm algorithm) {
+    if (strcmp(selection, "all") == 0) {
+        return algorithm <= ALG_RR;
+    }
+    return strcmp(selection, algorithm_key(algorithm)) == 0;
+}
+
+/**
+ * @brief Returns the command-line name of an algorithm
+ * @param algorithm Algorithm to name
+ * @return Name such as "fcfs"
+ */
+const char* algorithm_key(Algorithm algorithm) {
+    return algorithm < ALG_COUNT ? algorithm_keys[algorithm] : "?";
+}
+
+/**
+ * @brief Returns the display name of an algorithm
+ * @param algorithm Algorithm to name
+ * @return Name such as "SJF (non-preemptive)", as used by print_metrics
+ */
+const char* algorithm_title(Algorithm algorithm) {
+    return algorithm < ALG_COUNT ? algorithm_titles[algorithm] : "?";
+}
+
+/**
+ * @brief Runs the selected algorithm on the given processes
+ * @param params Algorithm and parameters
+ * @param processes Array of processes (reordered and updated in place)
+ * @param io I/O of each process, indexed like processes, or NULL; only RR and VRR block for I/O
+ * @param n Number of processes
+ * @return Metrics structure containing the performance metrics
+ */
+Metrics run_schedule(const SchedParams* params, Process* processes, const ProcessIo* io, int n) {
+    switch (params->algorithm) {
+        case ALG_FCFS:
+            return fcfs_schedule(processes, n);
+        case ALG_SJF:
+            return sjf_non_preemptive_schedule(processes, n);
+        case ALG_SRTF:
+            return sjf_preemptive_schedule(processes, n);
+        case ALG_RR:
+            return rr_schedule(processes, io, n, params->time_quantum);
+        case ALG_ARR_MEDIAN:
+            return rr_adaptive_schedule(processes, n, RR_QUANTUM_MEDIAN);
+        case ALG_ARR_MEAN:
+            return rr_adaptive_schedule(processes, n, RR_QUANTUM_MEAN);
+        case ALG_VRR:
+            return vrr_schedule(processes, io, n, params->time_quantum);
+        default: {
+            Metrics empty = {0};
+            return empty;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file sched.h
+ * @brief Selection and dispatch of CPU scheduling algorithms by name
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "common.h"
+
+/**
+ * @enum Algorithm
+ * @brief Scheduling algorithms that can be run through run_schedule
+ */
+typedef enum {
+    ALG_FCFS,  /**< First-Come-First-Serve */
+    ALG_SJF,   /**< Shortest Job First (non-preemptive) */
+    ALG_SRTF,  /**< Shortest Remaining Time First */
+    ALG_RR,         /**< Round Robin */
+    ALG_ARR_MEDIAN, /**< Adaptive Round Robin, median remaining time as quantum */
+    ALG_ARR_MEAN,   /**< Adaptive Round Robin, mean remaining time as quantum */
+    ALG_VRR,        /**< Virtual Round Robin, with an auxiliary queue for processes back from I/O */
+    ALG_COUNT       /**< Number of algorithms */
+} Algorithm;
+
+/**
+ * @struct SchedParams
+ * @brief Algorithm and parameters for one simulation run
+ */
+typedef struct {
+    Algorithm algorithm; /**< Algorithm to run */
+    int time_quantum;    /**< Time slice for Round Robin and Virtual Round Robin */
+} SchedParams;
+
+/**
+ * @brief Looks up an algorithm by its command-line name
+ * @param name Name such as "fcfs" or "rr"
+ * @param algorithm Where to store the algorithm
+ * @return true if the name is known, false otherwise
+ */
+bool parse_algorithm(const char* name, Algorithm* algorithm);
+
+/**
+ * @brief Checks whether an algorithm is selected by a command-line name
+ *
+ * "all" selects the four classic algorithms (FCFS, SJF, SRTF and RR);
+ * variants such as adaptive Round Robin run only when named.
+ *
+ * @param selection Algorithm name from the command line, or "all"
+ * @param algorithm Algorithm to check
+ * @return true if the algorithm should run
+ */
+bool algorithm_selected(const char* selection, Algorithm algorithm);
+
+/**
+ * @brief Returns the command-line name of an algorithm
+ * @param algorithm Algorithm to name
+ * @return Name such as "fcfs"
+ */
+const char* algorithm_key(Algorithm algorithm);
+
+/**
+ * @brief Returns the display name of an algorithm
+ * @param algorithm Algorithm to name
+ * @return Name such as "SJF (non-preemptive)", as used by print_metrics
+ */
+const char* algorithm_title(Algorithm algorithm);
+
+/**
+ * @brief Runs the selected algorithm on the given processes
+ * @param params Algorithm and parameters
+ * @param processes Array of processes (reordered and updated in place)
+ * @param io I/O of each process, indexed like processes, or NULL; only RR and VRR block for I/O
+ * @param n Number of processes
+ * @return Metrics structure containing the performance metrics
+ */
+Metrics run_schedule(const SchedParams* params, Process* processes, const ProcessIo* io, int n);
+
+#endif /* SCHED_H */
@@ -0,0 +1,561 @@
+/**
+ * @file shard.c
+ * @brief Implementation of sharded simulation on forked processes or threads
+ */
+
+#include "shard.h"
+#include "net.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief Result of one shard as sent from a forked worker to the parent
+ */
+typedef struct {
+    int32_t shard;   /**< Index of the shard */
+    Metrics metrics; /**< Metrics of the shard */
+} ShardRecord;
+
+/**
+ * @brief Work assigned to one worker
+ */
+typedef struct {
+    const SchedParams* params; /**< Algorithm and parameters */
+    Process* grouped;          /**< Processes grouped by shard */
+    ProcessIo* grouped_io;     /**< I/O of each grouped process, or NULL */
+    const int* offsets;        /**< Start of each shard in grouped, plus the end */
+    const int* owner;          /**< Worker assigned to each shard */
+    int count;                 /**< Number of shards */
+    int worker;                /**< Index of this worker */
+    Metrics* metrics;          /**< Metrics of each shard, filled in for this worker's shards */
+    const char* remote;        /**< Address of the remote worker, or NULL to simulate locally */
+    bool* received;            /**< Set for each shard whose metrics arrived */
+} ShardWorker;
+
+/**
+ * @brief Shard work estimate and index, used to order shards for assignment
+ */
+typedef struct {
+    int64_t burst; /**< Total burst time of the shard */
+    int shard;     /**< Index of the shard */
+} ShardLoad;
+
+/**
+ * @brief Comparison function for sorting shards largest first
+ * @param a First shard
+ * @param b Second shard
+ * @return Negative if a has more work than b, ties broken by shard index
+ */
+static int compare_load(const void* a, const void* b) {
+    const ShardLoad* l1 = (const ShardLoad*)a;
+    const ShardLoad* l2 = (const ShardLoad*)b;
+    if (l1->burst != l2->burst) {
+        return l1->burst > l2->burst ? -1 : 1;
+    }
+    return l1->shard - l2->shard;
+}
+
+/**
+ * @brief Schedules every shard assigned to a worker
+ * @param worker Worker whose shards to run
+ */
+static void run_worker(ShardWorker* worker) {
+    for (int s = 0; s < worker->count; s++) {
+        if (worker->owner[s] != worker->worker) {
+            continue;
+        }
+        int begin = worker->offsets[s];
+        int size = worker->offsets[s + 1] - begin;
+        const ProcessIo* io = worker->grouped_io ? worker->grouped_io + begin : NULL;
+        worker->metrics[s] = run_schedule(worker->params, worker->grouped + begin, io, size);
+    }
+}
+
+/**
+ * @brief Thread entry point for run_worker
+ * @param arg ShardWorker to run
+ * @return NULL
+ */
+static void* shard_thread(void* arg) {
+    run_worker((ShardWorker*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Thread entry point that sends a worker's shards to its remote worker
+ * @param arg ShardWorker to run
+ * @return NULL
+ */
+static void* remote_thread(void* arg) {
+    ShardWorker* worker = (ShardWorker*)arg;
+    int fd = net_connect(worker->remote);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    int write_fd = dup(fd);
+    FILE* in = fdopen(fd, "rb");
+    FILE* out = write_fd >= 0 ? fdopen(write_fd, "wb") : NULL;
+    for (int s = 0; in && out && s < worker->count; s++) {
+        if (worker->owner[s] != worker->worker) {
+            continue;
+        }
+        int begin = worker->offsets[s];
+        int size = worker->offsets[s + 1] - begin;
+        const ProcessIo* io = worker->grouped_io ? worker->grouped_io + begin : NULL;
+        if (net_request(out, in, worker->params, worker->grouped + begin, io, size, &worker->metrics[s]) != 0) {
+            fprintf(stderr, "Error: Lost connection to worker %s\n", worker->remote);
+            break;
+        }
+        worker->received[s] = true;
+    }
+
+    if (in) fclose(in); else close(fd);
+    if (out) fclose(out); else if (write_fd >= 0) close(write_fd);
+    return NULL;
+}
+
+/**
+ * @brief Runs the workers on remote hosts, one connection per worker
+ * @param workers Workers to run, each with its remote address set
+ * @param worker_count Number of workers
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int run_remote(ShardWorker* workers, int worker_count) {
+    pthread_t* threads = (pthread_t*)malloc(worker_count * sizeof(pthread_t));
+    bool* spawned = (bool*)calloc(worker_count, sizeof(bool));
+    if (!threads || !spawned) {
+        perror("Memory allocation failed");
+        free(threads);
+        free(spawned);
+        return -1;
+    }
+
+    // A worker that disconnects must surface as an error, not a signal
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int w = 0; w < worker_count; w++) {
+        spawned[w] = pthread_create(&threads[w], NULL, remote_thread, &workers[w]) == 0;
+    }
+    for (int w = 0; w < worker_count; w++) {
+        if (spawned[w]) {
+            pthread_join(threads[w], NULL);
+        } else {
+            remote_thread(&workers[w]);
+        }
+    }
+
+    free(threads);
+    free(spawned);
+    return 0;
+}
+
+/**
+ * @brief Writes a whole buffer to a file descriptor
+ * @param fd Descriptor to write to
+ * @param data Bytes to write
+ * @param len Number of bytes
+ * @return true if every byte was written
+ */
+static bool write_all(int fd, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t written = write(fd, p, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * @brief Body of a forked worker: runs its shards and reports them on a pipe
+ * @param worker Worker whose shards to run
+ * @param fd Write end of the worker's pipe
+ */
+static void run_child(ShardWorker* worker, int fd) {
+    run_worker(worker);
+
+    for (int s = 0; s < worker->count; s++) {
+        if (worker->owner[s] != worker->worker) {
+            continue;
+        }
+        ShardRecord record;
+        memset(&record, 0, sizeof(record));
+        record.shard = s;
+        record.metrics = worker->metrics[s];
+        if (!write_all(fd, &record, sizeof(record))) {
+            _exit(EXIT_FAILURE);
+        }
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Runs the workers as forked processes and collects their records
+ *
+ * Pipes are drained with poll so that no worker blocks on a full pipe
+ * while the parent waits on another. A worker that cannot be forked runs
+ * in the parent instead.
+ *
+ * @param workers Workers to run
+ * @param worker_count Number of workers
+ * @param received Set to true for every shard whose metrics arrived
+ * @return 0 on success, -1 if a worker failed
+ */
+static int run_forked(ShardWorker* workers, int worker_count, bool* received) {
+    int* fds = (int*)malloc(worker_count * sizeof(int));
+    pid_t* pids = (pid_t*)malloc(worker_count * sizeof(pid_t));
+    struct pollfd* polls = (struct pollfd*)malloc(worker_count * sizeof(struct pollfd));
+    ShardRecord* pending = (ShardRecord*)malloc(worker_count * sizeof(ShardRecord));
+    size_t* have = (size_t*)calloc(worker_count, sizeof(size_t));
+    if (!fds || !pids || !polls || !pending || !have) {
+        perror("Memory allocation failed");
+        free(fds);
+        free(pids);
+        free(polls);
+        free(pending);
+        free(have);
+        return -1;
+    }
+
+    // Buffered output would otherwise be flushed once per child
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int w = 0; w < worker_count; w++) {
+        int pipe_fds[2];
+        fds[w] = -1;
+        pids[w] = -1;
+        if (pipe(pipe_fds) != 0) {
+            continue;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(pipe_fds[0]);
+            for (int o = 0; o < w; o++) {
+                if (fds[o] >= 0) close(fds[o]);
+            }
+            run_child(&workers[w], pipe_fds[1]);
+        }
+
+        close(pipe_fds[1]);
+        if (pid < 0) {
+            close(pipe_fds[0]);
+            continue;
+        }
+        fds[w] = pipe_fds[0];
+        pids[w] = pid;
+    }
+
+    // Workers that could not be started run here while the others proceed
+    for (int w = 0; w < worker_count; w++) {
+        if (pids[w] < 0) {
+            run_worker(&workers[w]);
+            for (int s = 0; s < workers[w].count; s++) {
+                if (workers[w].owner[s] == w) received[s] = true;
+            }
+        }
+    }
+
+    int open_count = 0;
+    for (int w = 0; w < worker_count; w++) {
+        if (fds[w] >= 0) open_count++;
+    }
+
+    while (open_count > 0) {
+        int polled = 0;
+        for (int w = 0; w < worker_count; w++) {
+            if (fds[w] >= 0) {
+                polls[polled].fd = fds[w];
+                polls[polled].events = POLLIN;
+                polls[polled].revents = 0;
+                polled++;
+            }
+        }
+        if (poll(polls, (nfds_t)polled, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (int i = 0; i < polled; i++) {
+            if (polls[i].revents == 0) {
+                continue;
+            }
+            int w = 0;
+            while (fds[w] != polls[i].fd) w++;
+
+            char* buffer = (char*)&pending[w];
+            ssize_t got = read(fds[w], buffer + have[w], sizeof(ShardRecord) - have[w]);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                close(fds[w]);
+                fds[w] = -1;
+                open_count--;
+                continue;
+            }
+
+            have[w] += (size_t)got;
+            if (have[w] == sizeof(ShardRecord)) {
+                int s = pending[w].shard;
+                if (s >= 0 && s < workers[w].count && workers[w].owner[s] == w) {
+                    workers[w].metrics[s] = pending[w].metrics;
+                    received[s] = true;
+                }
+                have[w] = 0;
+            }
+        }
+    }
+
+    int status = 0;
+    for (int w = 0; w < worker_count; w++) {
+        if (fds[w] >= 0) {
+            close(fds[w]);
+        }
+        if (pids[w] > 0) {
+            int child_status = 0;
+            pid_t waited;
+            do {
+                waited = waitpid(pids[w], &child_status, 0);
+            } while (waited < 0 && errno == EINTR);
+            if (waited < 0 || !WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+                fprintf(stderr, "Error: Shard worker %d failed\n", w);
+                status = -1;
+            }
+        }
+    }
+
+    free(fds);
+    free(pids);
+    free(polls);
+    free(pending);
+    free(have);
+    return status;
+}
+
+/**
+ * @brief Runs the workers as threads sharing the grouped array
+ *
+ * Worker 0 runs on the calling thread, as does any worker whose thread
+ * could not be created.
+ *
+ * @param workers Workers to run
+ * @param worker_count Number of workers
+ * @param received Set to true for every shard
+ * @return 0 on success, -1 on memory allocation failure
+ */
+static int run_threaded(ShardWorker* workers, int worker_count, bool* received) {
+    pthread_t* threads = (pthread_t*)malloc(worker_count * sizeof(pthread_t));
+    bool* spawned = (bool*)calloc(worker_count, sizeof(bool));
+    if (!threads || !spawned) {
+        perror("Memory allocation failed");
+        free(threads);
+        free(spawned);
+        return -1;
+    }
+
+    for (int w = 1; w < worker_count; w++) {
+        spawned[w] = pthread_create(&threads[w], NULL, shard_thread, &workers[w]) == 0;
+    }
+    run_worker(&workers[0]);
+    for (int w = 1; w < worker_count; w++) {
+        if (spawned[w]) {
+            pthread_join(threads[w], NULL);
+        } else {
+            run_worker(&workers[w]);
+        }
+    }
+
+    for (int s = 0; s < workers[0].count; s++) {
+        received[s] = true;
+    }
+    free(threads);
+    free(spawned);
+    return 0;
+}
+
+/**
+ * @brief Simulates every partition as an independent machine
+ * @param params Algorithm and parameters
+ * @param processes Array of processes
+ * @param partitions Partition of each process, or NULL to put all in partition 0
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param options Worker options, or NULL for the defaults
+ * @param report Where to store the results; release with free_shard_report
+ * @return 0 on success, -1 on failure
+ */
+int shard_run(const SchedParams* params, const Process* processes, const uint32_t* partitions,
+              const ProcessIo* io, int n, const ShardOptions* options, ShardReport* report) {
+    memset(report, 0, sizeof(*report));
+
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t partition = partitions ? partitions[i] : 0;
+        if ((int64_t)partition + 1 > count) {
+            count = (int)partition + 1;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    bool remote = options && options->remote_count > 0;
+    int worker_count = options && options->workers > 0 ? options->workers : online_cpu_count();
+    if (remote) {
+        worker_count = options->remote_count;
+    }
+    if (worker_count > count) {
+        worker_count = count;
+    }
+
+    int* offsets = (int*)calloc((size_t)count + 1, sizeof(int));
+    int* owner = (int*)malloc(count * sizeof(int));
+    ShardLoad* loads = (ShardLoad*)malloc(count * sizeof(ShardLoad));
+    int64_t* worker_load = (int64_t*)calloc(worker_count, sizeof(int64_t));
+    bool* received = (bool*)calloc(count, sizeof(bool));
+    ShardWorker* workers = (ShardWorker*)malloc(worker_count * sizeof(ShardWorker));
+    Process* grouped = (Process*)malloc((n > 0 ? n : 1) * sizeof(Process));
+    ProcessIo* grouped_io = io ? (ProcessIo*)malloc((n > 0 ? n : 1) * sizeof(ProcessIo)) : NULL;
+    report->partitions = (uint32_t*)malloc(count * sizeof(uint32_t));
+    report->metrics = (Metrics*)calloc(count, sizeof(Metrics));
+
+    int status = 0;
+    if (!offsets || !owner || !loads || !worker_load || !received || !workers || !grouped || (io && !grouped_io) ||
+        !report->partitions || !report->metrics) {
+        perror("Memory allocation failed");
+        status = -1;
+    }
+
+    if (status == 0) {
+        // Group processes by shard with a stable counting sort
+        for (int i = 0; i < n; i++) {
+            offsets[(partitions ? partitions[i] : 0) + 1]++;
+        }
+        for (int s = 0; s < count; s++) {
+            offsets[s + 1] += offsets[s];
+        }
+        // owner serves as the insertion cursor until shards are assigned
+        int* next = owner;
+        memcpy(next, offsets, count * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            int j = next[partitions ? partitions[i] : 0]++;
+            grouped[j] = processes[i];
+            if (io) {
+                grouped_io[j] = io[i];
+            }
+        }
+
+        // Longest-processing-time-first assignment, using total burst as the load
+        for (int s = 0; s < count; s++) {
+            loads[s].burst = 0;
+            for (int j = offsets[s]; j < offsets[s + 1]; j++) {
+                loads[s].burst += grouped[j].burst_time;
+            }
+            loads[s].shard = s;
+            report->partitions[s] = (uint32_t)s;
+        }
+        qsort(loads, count, sizeof(ShardLoad), compare_load);
+        for (int i = 0; i < count; i++) {
+            int best = 0;
+            for (int w = 1; w < worker_count; w++) {
+                if (worker_load[w] < worker_load[best]) best = w;
+            }
+            owner[loads[i].shard] = best;
+            worker_load[best] += loads[i].burst > 0 ? loads[i].burst : 1;
+        }
+
+        for (int w = 0; w < worker_count; w++) {
+            workers[w].params = params;
+            workers[w].grouped = grouped;
+            workers[w].grouped_io = grouped_io;
+            workers[w].offsets = offsets;
+            workers[w].owner = owner;
+            workers[w].count = count;
+            workers[w].worker = w;
+            workers[w].metrics = report->metrics;
+            workers[w].remote = remote ? options->remotes[w] : NULL;
+            workers[w].received = received;
+        }
+
+        if (remote) {
+            status = run_remote(workers, worker_count);
+        } else if (options && options->use_threads) {
+            status = run_threaded(workers, worker_count, received);
+        } else {
+            status = run_forked(workers, worker_count, received);
+        }
+    }
+
+    if (status == 0) {
+        for (int s = 0; s < count; s++) {
+            if (!received[s]) {
+                fprintf(stderr, "Error: No result for shard %s\n", partition_name(report->partitions[s]));
+                status = -1;
+                break;
+            }
+            report->fleet = merge_metrics(report->fleet, report->metrics[s]);
+        }
+    }
+
+    report->count = count;
+    report->workers = worker_count;
+
+    free(offsets);
+    free(owner);
+    free(loads);
+    free(worker_load);
+    free(received);
+    free(workers);
+    free(grouped);
+    free(grouped_io);
+    if (status != 0) {
+        free_shard_report(report);
+    }
+    return status;
+}
+
+/**
+ * @brief Prints the per-shard table and the fleet metrics
+ * @param report Results of shard_run
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_shard_report(const ShardReport* report, const char* algorithm_name) {
+    printf("\n%s per-shard metrics (%d shard%s on %d worker%s):\n", algorithm_name, report->count,
+           report->count == 1 ? "" : "s", report->workers, report->workers == 1 ? "" : "s");
+    printf("%-16s %-12s %-18s %-18s %-18s\n", "Partition", "Processes", "Avg Turnaround", "Avg Waiting",
+           "Avg Response");
+    printf("----------------------------------------------------------------------------------\n");
+
+    for (int s = 0; s < report->count; s++) {
+        const Metrics* m = &report->metrics[s];
+        printf("%-16s %-12lld %-18.2f %-18.2f %-18.2f\n", partition_name(report->partitions[s]),
+               (long long)m->count, m->avg_turnaround_time, m->avg_waiting_time, m->avg_response_time);
+    }
+    printf("----------------------------------------------------------------------------------\n");
+
+    print_metrics(report->fleet, algorithm_name);
+}
+
+/**
+ * @brief Releases the memory held by a report
+ * @param report Report to free
+ */
+void free_shard_report(ShardReport* report) {
+    free(report->partitions);
+    free(report->metrics);
+    memset(report, 0, sizeof(*report));
+}
@@ -0,0 +1,72 @@
+/**
+ * @file shard.h
+ * @brief Simulation of independent workload partitions on parallel workers
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @struct ShardOptions
+ * @brief Options controlling how shards are spread over workers
+ */
+typedef struct {
+    int workers;                 /**< Number of workers (0 = one per online CPU) */
+    bool use_threads;            /**< Run workers as threads instead of forked processes */
+    const char* const* remotes;  /**< Addresses of remote workers (see net.h), or NULL */
+    int remote_count;            /**< Number of remote workers; if nonzero, workers is ignored */
+} ShardOptions;
+
+/**
+ * @struct ShardReport
+ * @brief Per-shard and fleet-wide results of a sharded simulation
+ */
+typedef struct {
+    int count;            /**< Number of shards */
+    uint32_t* partitions; /**< Partition key of each shard, in order of first appearance */
+    Metrics* metrics;     /**< Metrics of each shard */
+    Metrics fleet;        /**< Metrics of all shards combined */
+    int workers;          /**< Number of workers actually used */
+} ShardReport;
+
+/**
+ * @brief Simulates every partition as an independent machine
+ *
+ * Processes are grouped by partition and each group is scheduled
+ * on its own, as if it ran on a separate CPU. Groups are assigned to
+ * workers largest first, each to the least loaded worker. A forked worker
+ * receives a copy-on-write image of the grouped array and sends its
+ * shards' metrics back over a pipe; a thread worker schedules its groups
+ * in place. With remote workers, each shard is sent over TCP in the
+ * binary workload format and only its metrics come back. The input array
+ * is not modified.
+ *
+ * @param params Algorithm and parameters
+ * @param processes Array of processes
+ * @param partitions Partition of each process, or NULL to put all in partition 0
+ * @param io I/O of each process, or NULL if none blocks
+ * @param n Number of processes
+ * @param options Worker options, or NULL for the defaults
+ * @param report Where to store the results; release with free_shard_report
+ * @return 0 on success, -1 on failure
+ */
+int shard_run(const SchedParams* params, const Process* processes, const uint32_t* partitions,
+              const ProcessIo* io, int n, const ShardOptions* options, ShardReport* report);
+
+/**
+ * @brief Prints the per-shard table and the fleet metrics
+ * @param report Results of shard_run
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_shard_report(const ShardReport* report, const char* algorithm_name);
+
+/**
+ * @brief Releases the memory held by a report
+ * @param report Report to free
+ */
+void free_shard_report(ShardReport* report);
+
+#endif /* SHARD_H */
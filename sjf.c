@@ -4,20 +4,9 @@
  */
 
 #include "sjf.h"
+#include "footprint.h"
 #include <limits.h> /* For INT_MAX */
 
-/**
- * @brief Comparison function for sorting processes by arrival time
- * @param a First process
- * @param b Second process
- * @return Negative if a arrives before b, positive if a arrives after b
- */
-static int compare_arrival_time(const void* a, const void* b) {
-    Process* p1 = (Process*)a;
-    Process* p2 = (Process*)b;
-    return p1->arrival_time - p2->arrival_time;
-}
-
 /**
  * @brief Executes the non-preemptive Shortest Job First (SJF) scheduling algorithm
  * 
@@ -42,6 +31,10 @@ Metrics sjf_non_preemptive_schedule(Process* processes, int n) {
         Metrics empty = {0};
         return empty;
     }
+    footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
+    
+    QueueIntegral integral;
+    queue_integral_init(&integral, processes, n);
     
     // Continue until all processes are completed
     while (completed < n) {
@@ -75,6 +68,7 @@ Metrics sjf_non_preemptive_schedule(Process* processes, int n) {
         // Set response time when process first gets CPU
         p->response_time = current_time - p->arrival_time;
         p->started = true;
+        queue_integral_dispatch(&integral, current_time);
         
         // Execute the process (advance time by burst time)
         current_time += p->burst_time;
@@ -82,16 +76,20 @@ Metrics sjf_non_preemptive_schedule(Process* processes, int n) {
         // Set completion time
         p->completion_time = current_time;
         p->remaining_time = 0;
+        queue_integral_release(&integral, current_time, false);
         
         // Mark as completed
         is_completed[shortest_job_idx] = true;
         completed++;
     }
     
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
     free(is_completed);
     
     // Calculate and return metrics
-    return calculate_metrics(processes, n);
+    Metrics metrics = calculate_metrics(processes, n);
+    queue_integral_store(&integral, &metrics);
+    return metrics;
 }
 
 /**
@@ -119,6 +117,12 @@ Metrics sjf_preemptive_schedule(Process* processes, int n) {
         Metrics empty = {0};
         return empty;
     }
+    footprint_charge(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
+    
+    // The integrals only change when the CPU changes hands, not on every tick
+    QueueIntegral integral;
+    queue_integral_init(&integral, processes, n);
+    int running_idx = -1;
     
     // Continue until all processes are completed
     while (completed < n) {
@@ -148,6 +152,13 @@ Metrics sjf_preemptive_schedule(Process* processes, int n) {
         
         // Execute the selected process for 1 time unit
         Process* p = &processes[shortest_job_idx];
+        if (shortest_job_idx != running_idx) {
+            if (running_idx >= 0) {
+                queue_integral_release(&integral, current_time, true);
+            }
+            queue_integral_dispatch(&integral, current_time);
+            running_idx = shortest_job_idx;
+        }
         
         // Set response time when process first gets CPU
         if (!p->started) {
@@ -164,14 +175,19 @@ Metrics sjf_preemptive_schedule(Process* processes, int n) {
             p->completion_time = current_time;
             is_completed[shortest_job_idx] = true;
             completed++;
+            queue_integral_release(&integral, current_time, false);
+            running_idx = -1;
         }
         
         // Check if a new process has arrived that should preempt the current one
         // This is handled automatically in the next iteration of the loop
     }
     
+    footprint_release(SUBSYSTEM_ALGORITHM, (size_t)n * sizeof(bool));
     free(is_completed);
     
     // Calculate and return metrics
-    return calculate_metrics(processes, n);
+    Metrics metrics = calculate_metrics(processes, n);
+    queue_integral_store(&integral, &metrics);
+    return metrics;
 }
\ No newline at end of file
@@ -0,0 +1,381 @@
+/**
+ * @file tune.c
+ * @brief Implementation of the Round Robin quantum search
+ */
+
+#include "tune.h"
+#include "rr.h"
+
+#include <limits.h>
+#include <math.h>
+
+/** Number of points in the initial geometric grid */
+#define TUNE_GRID_POINTS 9
+
+/** Command-line names, indexed by Objective */
+static const char* const objective_keys[OBJ_COUNT] = {
+    "waiting", "turnaround", "response", "p99-response"
+};
+
+/** Descriptions used in the report, indexed by Objective */
+static const char* const objective_titles[OBJ_COUNT] = {
+    "average waiting time", "average turnaround time", "average response time", "p99 response time"
+};
+
+/**
+ * @brief State shared by the evaluations of one search
+ */
+typedef struct {
+    const Process* processes;   /**< Input processes */
+    Process* scratch;           /**< Copy that each run schedules */
+    int* responses;             /**< Response times, for percentiles */
+    int n;                      /**< Number of processes */
+    int64_t total_burst;        /**< Sum of burst times */
+    const TuneOptions* options; /**< Objective and search range */
+    TuneResult* result;         /**< Points evaluated so far */
+    bool have_best;             /**< Whether any run has completed */
+    int64_t best_total;         /**< Objective total of the best run (or p99 value) */
+} TuneSearch;
+
+/**
+ * @brief Looks up an objective by its command-line name
+ * @param name "waiting", "turnaround", "response" or "p99-response"
+ * @param objective Where to store the objective
+ * @return true if the name is known, false otherwise
+ */
+bool parse_objective(const char* name, Objective* objective) {
+    for (int i = 0; i < OBJ_COUNT; i++) {
+        if (strcmp(name, objective_keys[i]) == 0) {
+            *objective = (Objective)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the k-th smallest value, reordering the array
+ * @param values Array to select from
+ * @param n Number of values
+ * @param k Rank to select (0-based)
+ * @return The value that would be at index k after sorting
+ */
+static int select_kth(int* values, int n, int k) {
+    int lo = 0;
+    int hi = n - 1;
+    while (lo < hi) {
+        int pivot = values[lo + (hi - lo) / 2];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (values[i] < pivot) i++;
+            while (values[j] > pivot) j--;
+            if (i <= j) {
+                int tmp = values[i];
+                values[i] = values[j];
+                values[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) {
+            hi = j;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+    return values[k];
+}
+
+/**
+ * @brief Returns the index of the 99th percentile in a sorted array
+ * @param n Number of values
+ * @return Rank of the nearest-rank 99th percentile (0-based)
+ */
+static int p99_rank(int n) {
+    return (int)((99 * (int64_t)n + 99) / 100) - 1;
+}
+
+/**
+ * @brief Finds the point evaluated for a quantum
+ * @param result Points so far
+ * @param quantum Quantum to look up
+ * @return Index of the point, or -1 if the quantum was not evaluated
+ */
+static int find_point(const TuneResult* result, int quantum) {
+    for (int i = 0; i < result->count; i++) {
+        if (result->points[i].quantum == quantum) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Runs Round Robin with one quantum, unless it was already evaluated
+ * @param search Search state
+ * @param quantum Quantum to evaluate
+ * @return Objective value, HUGE_VAL if the run stopped early, or NAN on failure
+ */
+static double evaluate(TuneSearch* search, int quantum) {
+    TuneResult* result = search->result;
+    int existing = find_point(result, quantum);
+    if (existing >= 0) {
+        return result->points[existing].aborted ? HUGE_VAL : result->points[existing].value;
+    }
+
+    if (result->count == result->capacity) {
+        int capacity = result->capacity ? result->capacity * 2 : 32;
+        TunePoint* points = (TunePoint*)realloc(result->points, capacity * sizeof(TunePoint));
+        if (!points) {
+            perror("Memory allocation failed");
+            return NAN;
+        }
+        result->points = points;
+        result->capacity = capacity;
+    }
+
+    // Runs that cannot beat the best one so far are abandoned early
+    int n = search->n;
+    RrOptions limits = {search->options->switch_cost, INT64_MAX, INT64_MAX, INT_MAX, INT64_MAX};
+    if (search->have_best) {
+        switch (search->options->objective) {
+            case OBJ_WAITING:
+                limits.max_total_waiting = search->best_total;
+                break;
+            case OBJ_TURNAROUND:
+                limits.max_total_waiting = search->best_total - search->total_burst;
+                break;
+            case OBJ_RESPONSE:
+                limits.max_total_response = search->best_total;
+                break;
+            default:
+                limits.response_limit = (int)search->best_total;
+                limits.max_late = n - 1 - p99_rank(n);
+                break;
+        }
+    }
+
+    memcpy(search->scratch, search->processes, n * sizeof(Process));
+    RrStats stats;
+    Metrics metrics = rr_schedule_with_options(search->scratch, n, quantum, &limits, &stats);
+
+    TunePoint* point = &result->points[result->count++];
+    point->quantum = quantum;
+    point->context_switches = stats.context_switches;
+    point->aborted = stats.aborted;
+    point->abort_time = stats.abort_time;
+    point->value = HUGE_VAL;
+    if (stats.aborted) {
+        return HUGE_VAL;
+    }
+
+    int64_t total;
+    switch (search->options->objective) {
+        case OBJ_WAITING:
+            total = metrics.total_waiting;
+            point->value = (double)total / n;
+            break;
+        case OBJ_TURNAROUND:
+            total = metrics.total_turnaround;
+            point->value = (double)total / n;
+            break;
+        case OBJ_RESPONSE:
+            total = metrics.total_response;
+            point->value = (double)total / n;
+            break;
+        default:
+            for (int i = 0; i < n; i++) {
+                search->responses[i] = search->scratch[i].response_time;
+            }
+            total = select_kth(search->responses, n, p99_rank(n));
+            point->value = (double)total;
+            break;
+    }
+
+    if (!search->have_best || total < search->best_total) {
+        search->have_best = true;
+        search->best_total = total;
+    }
+    return point->value;
+}
+
+/**
+ * @brief Returns the quantum of the best completed run so far
+ * @param result Points so far
+ * @return Quantum with the lowest objective value (smallest quantum on ties)
+ */
+static int best_quantum(const TuneResult* result) {
+    int best = -1;
+    for (int i = 0; i < result->count; i++) {
+        const TunePoint* p = &result->points[i];
+        if (p->aborted) {
+            continue;
+        }
+        if (best < 0 || p->value < result->points[best].value ||
+            (p->value == result->points[best].value && p->quantum < result->points[best].quantum)) {
+            best = i;
+        }
+    }
+    return best >= 0 ? result->points[best].quantum : -1;
+}
+
+/**
+ * @brief Comparison function for sorting points by quantum
+ * @param a First point
+ * @param b Second point
+ * @return Negative if a has the smaller quantum
+ */
+static int compare_quantum(const void* a, const void* b) {
+    return ((const TunePoint*)a)->quantum - ((const TunePoint*)b)->quantum;
+}
+
+/**
+ * @brief Searches for the quantum that minimises the objective
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes
+ * @param options Objective and search range
+ * @param result Where to store the evaluated points; release with free_tune_result
+ * @return 0 on success, -1 on memory allocation failure
+ */
+int tune_quantum(const Process* processes, int n, const TuneOptions* options, TuneResult* result) {
+    memset(result, 0, sizeof(*result));
+    if (n <= 0) {
+        return -1;
+    }
+
+    TuneSearch search;
+    memset(&search, 0, sizeof(search));
+    search.processes = processes;
+    search.n = n;
+    search.options = options;
+    search.result = result;
+    search.scratch = copy_processes((Process*)processes, n);
+    search.responses = (int*)malloc(n * sizeof(int));
+    if (!search.scratch || !search.responses) {
+        if (!search.responses) perror("Memory allocation failed");
+        free_process_copy(search.scratch, n);
+        free(search.responses);
+        return -1;
+    }
+
+    int max_burst = 1;
+    for (int i = 0; i < n; i++) {
+        search.total_burst += processes[i].burst_time;
+        if (processes[i].burst_time > max_burst) max_burst = processes[i].burst_time;
+    }
+
+    // Quanta beyond the longest burst all behave like FCFS
+    int lo = options->min_quantum > 0 ? options->min_quantum : 1;
+    int hi = options->max_quantum > 0 ? options->max_quantum : max_burst;
+    if (hi < lo) hi = lo;
+
+    int status = 0;
+
+    // Geometric grid to find the region of the optimum
+    double ratio = pow((double)hi / lo, 1.0 / (TUNE_GRID_POINTS - 1));
+    for (int i = 0; i < TUNE_GRID_POINTS && status == 0; i++) {
+        int q = i == TUNE_GRID_POINTS - 1 ? hi : (int)floor(lo * pow(ratio, i) + 0.5);
+        if (isnan(evaluate(&search, q))) status = -1;
+    }
+
+    // Bracket the best grid point by its evaluated neighbours
+    int best = best_quantum(result);
+    int a = lo;
+    int b = hi;
+    for (int i = 0; i < result->count; i++) {
+        int q = result->points[i].quantum;
+        if (q < best && q > a) a = q;
+        if (q > best && q < b) b = q;
+    }
+
+    // Golden-section search on integers; stopped runs count as worse than any finished one
+    const double inv_phi = 0.6180339887498949;
+    while (status == 0 && b - a > 3) {
+        int c = b - (int)floor((b - a) * inv_phi + 0.5);
+        int d = a + (int)floor((b - a) * inv_phi + 0.5);
+        if (c <= a) c = a + 1;
+        if (d >= b) d = b - 1;
+        if (d <= c) d = c + 1;
+
+        double fc = evaluate(&search, c);
+        double fd = evaluate(&search, d);
+        if (isnan(fc) || isnan(fd)) {
+            status = -1;
+            break;
+        }
+
+        if (fc < fd) {
+            b = d;
+        } else if (fd < fc) {
+            a = c;
+        } else {
+            // Equal (or both stopped early): move towards the best run so far
+            best = best_quantum(result);
+            if (best <= c) {
+                b = d;
+            } else if (best >= d) {
+                a = c;
+            } else {
+                a = c;
+                b = d;
+            }
+        }
+    }
+    for (int q = a; status == 0 && q <= b; q++) {
+        if (isnan(evaluate(&search, q))) status = -1;
+    }
+
+    free_process_copy(search.scratch, n);
+    free(search.responses);
+    if (status != 0) {
+        free_tune_result(result);
+        return -1;
+    }
+
+    qsort(result->points, result->count, sizeof(TunePoint), compare_quantum);
+    result->best = find_point(result, best_quantum(result));
+    return 0;
+}
+
+/**
+ * @brief Prints the evaluated curve and the optimum
+ * @param result Result of tune_quantum
+ * @param options Options passed to tune_quantum
+ */
+void print_tune_result(const TuneResult* result, const TuneOptions* options) {
+    printf("\nRound Robin quantum search (objective: %s, switch cost: %d):\n",
+           objective_titles[options->objective], options->switch_cost);
+    printf("%-10s %-20s %-18s\n", "Quantum", "Objective", "Context Switches");
+    printf("----------------------------------------------------------------------------------\n");
+
+    int stopped = 0;
+    for (int i = 0; i < result->count; i++) {
+        const TunePoint* p = &result->points[i];
+        if (p->aborted) {
+            char note[32];
+            snprintf(note, sizeof(note), "stopped at t=%d", p->abort_time);
+            printf("%-10d %-20s %-18s\n", p->quantum, note, "-");
+            stopped++;
+        } else {
+            printf("%-10d %-20.2f %-18lld%s\n", p->quantum, p->value, (long long)p->context_switches,
+                   i == result->best ? " <- optimum" : "");
+        }
+    }
+    printf("----------------------------------------------------------------------------------\n");
+
+    const TunePoint* best = &result->points[result->best];
+    printf("Optimal quantum: %d (%s %.2f; %d runs, %d stopped early)\n", best->quantum,
+           objective_titles[options->objective], best->value, result->count, stopped);
+}
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_tune_result(TuneResult* result) {
+    free(result->points);
+    memset(result, 0, sizeof(*result));
+}
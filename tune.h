@@ -0,0 +1,95 @@
+/**
+ * @file tune.h
+ * @brief Search for the Round Robin time quantum that optimises a metric
+ */
+
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "common.h"
+
+/**
+ * @enum Objective
+ * @brief Metrics the quantum search can minimise
+ */
+typedef enum {
+    OBJ_WAITING,      /**< Average waiting time */
+    OBJ_TURNAROUND,   /**< Average turnaround time */
+    OBJ_RESPONSE,     /**< Average response time */
+    OBJ_P99_RESPONSE, /**< 99th percentile response time */
+    OBJ_COUNT         /**< Number of objectives */
+} Objective;
+
+/**
+ * @struct TuneOptions
+ * @brief Objective and search range for tune_quantum
+ */
+typedef struct {
+    Objective objective; /**< Metric to minimise */
+    int switch_cost;     /**< Time charged for each context switch */
+    int min_quantum;     /**< Smallest quantum to consider (at least 1) */
+    int max_quantum;     /**< Largest quantum to consider (0 = longest burst) */
+} TuneOptions;
+
+/**
+ * @struct TunePoint
+ * @brief One evaluated quantum
+ */
+typedef struct {
+    int quantum;              /**< Time quantum */
+    double value;             /**< Objective value, valid unless aborted */
+    int64_t context_switches; /**< Context switches of the run */
+    bool aborted;             /**< Whether the run stopped early as worse than the best */
+    int abort_time;           /**< Simulated time at which the run stopped */
+} TunePoint;
+
+/**
+ * @struct TuneResult
+ * @brief Evaluated points of a quantum search
+ */
+typedef struct {
+    TunePoint* points; /**< Evaluated quanta, sorted by quantum */
+    int count;         /**< Number of points */
+    int capacity;      /**< Allocated number of points */
+    int best;          /**< Index of the optimum in points */
+} TuneResult;
+
+/**
+ * @brief Looks up an objective by its command-line name
+ * @param name "waiting", "turnaround", "response" or "p99-response"
+ * @param objective Where to store the objective
+ * @return true if the name is known, false otherwise
+ */
+bool parse_objective(const char* name, Objective* objective);
+
+/**
+ * @brief Searches for the quantum that minimises the objective
+ *
+ * A geometric grid over the range locates the best region, which is then
+ * narrowed by golden-section search on integer quanta. Each run is given
+ * limits derived from the best value so far and is abandoned as soon as a
+ * lower bound on its objective exceeds it, so most of the cost goes into
+ * runs near the optimum.
+ *
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes
+ * @param options Objective and search range
+ * @param result Where to store the evaluated points; release with free_tune_result
+ * @return 0 on success, -1 on memory allocation failure
+ */
+int tune_quantum(const Process* processes, int n, const TuneOptions* options, TuneResult* result);
+
+/**
+ * @brief Prints the evaluated curve and the optimum
+ * @param result Result of tune_quantum
+ * @param options Options passed to tune_quantum
+ */
+void print_tune_result(const TuneResult* result, const TuneOptions* options);
+
+/**
+ * @brief Releases the memory held by a result
+ * @param result Result to free
+ */
+void free_tune_result(TuneResult* result);
+
+#endif /* TUNE_H */
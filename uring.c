@@ -0,0 +1,317 @@
+/**
+ * @file uring.c
+ * @brief Implementation of bulk file reads through io_uring
+ */
+
+/* syscall() is a GNU extension */
+#define _GNU_SOURCE
+
+#include "uring.h"
+
+#ifdef HAVE_IO_URING
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/** Bytes requested by each read */
+#define URING_CHUNK_SIZE (4 << 20)
+
+/** Reads kept in flight */
+#define URING_DEPTH 8
+
+/** Largest buffer the kernel accepts in one registration entry; a multiple of URING_CHUNK_SIZE */
+#define URING_PIECE_SIZE (1 << 30)
+
+/** Registration entries used at most; larger files are read without registering */
+#define URING_MAX_PIECES 1024
+
+/**
+ * @brief Submission and completion rings mapped from the kernel
+ */
+typedef struct {
+    int fd;                    /**< Ring file descriptor */
+    unsigned* sq_tail;         /**< Submission tail, written by us */
+    unsigned sq_mask;          /**< Submission ring size minus one */
+    unsigned* sq_array;        /**< Submission ring of indices into sqes */
+    struct io_uring_sqe* sqes; /**< Submission entries */
+    unsigned* cq_head;         /**< Completion head, written by us */
+    unsigned* cq_tail;         /**< Completion tail, written by the kernel */
+    unsigned cq_mask;          /**< Completion ring size minus one */
+    struct io_uring_cqe* cqes; /**< Completion entries */
+    void* sq_ring;             /**< Mapping of the submission ring */
+    size_t sq_ring_size;       /**< Size of that mapping */
+    void* cq_ring;             /**< Mapping of the completion ring, or sq_ring if shared */
+    size_t cq_ring_size;       /**< Size of that mapping */
+    size_t sqes_size;          /**< Size of the sqes mapping */
+} Ring;
+
+/**
+ * @brief A chunk being read
+ */
+typedef struct {
+    size_t offset; /**< File offset of the chunk */
+    size_t len;    /**< Bytes in the chunk */
+    size_t done;   /**< Bytes read so far */
+} Chunk;
+
+/**
+ * @brief Creates a ring and maps its queues
+ * @param ring Ring to set up
+ * @return true on success, false if io_uring is missing, blocked or out of resources
+ */
+static bool ring_open(Ring* ring) {
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, URING_DEPTH, &params);
+    if (ring->fd < 0) {
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd,
+                         IORING_OFF_SQ_RING);
+    ring->cq_ring = single ? ring->sq_ring
+                           : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd,
+                                  IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd,
+                                            IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        if (ring->cq_ring != MAP_FAILED && !single) munmap(ring->cq_ring, ring->cq_ring_size);
+        if (ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+        close(ring->fd);
+        return false;
+    }
+
+    char* sq = (char*)ring->sq_ring;
+    char* cq = (char*)ring->cq_ring;
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+/**
+ * @brief Unmaps the queues and closes the ring, which also unregisters its buffers
+ * @param ring Ring to close
+ */
+static void ring_close(Ring* ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/**
+ * @brief Registers a buffer with the ring in pieces the kernel accepts
+ * @param ring Ring to register with
+ * @param data Buffer
+ * @param size Size of the buffer
+ * @return true if the buffer is registered and fixed reads can be used
+ */
+static bool ring_register(Ring* ring, char* data, size_t size) {
+    size_t pieces = (size + URING_PIECE_SIZE - 1) / URING_PIECE_SIZE;
+    if (pieces > URING_MAX_PIECES) {
+        return false;
+    }
+    struct iovec* iov = (struct iovec*)malloc(pieces * sizeof(struct iovec));
+    if (!iov) {
+        return false;
+    }
+    for (size_t i = 0; i < pieces; i++) {
+        size_t offset = i * (size_t)URING_PIECE_SIZE;
+        iov[i].iov_base = data + offset;
+        iov[i].iov_len = size - offset < URING_PIECE_SIZE ? size - offset : URING_PIECE_SIZE;
+    }
+    bool registered = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iov, (unsigned)pieces) == 0;
+    free(iov);
+    return registered;
+}
+
+/**
+ * @brief Queues a read of the unread part of a chunk
+ * @param ring Ring to queue on
+ * @param fd File to read
+ * @param data Destination buffer
+ * @param chunks Chunk table, indexed by user_data
+ * @param slot Chunk to read
+ * @param fixed Whether the buffer is registered
+ */
+static void queue_read(Ring* ring, int fd, char* data, const Chunk* chunks, int slot, bool fixed) {
+    const Chunk* chunk = &chunks[slot];
+    size_t offset = chunk->offset + chunk->done;
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = (uint64_t)(uintptr_t)(data + offset);
+    sqe->len = (uint32_t)(chunk->len - chunk->done);
+    sqe->user_data = (uint64_t)slot;
+    if (fixed) {
+        // Chunks never straddle registered pieces, since the chunk size divides the piece size
+        sqe->buf_index = (uint16_t)(chunk->offset / URING_PIECE_SIZE);
+    }
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Reads the start of a file into memory with io_uring
+ * @param fd File descriptor open for reading; its offset is not used or changed
+ * @param data Buffer of at least size bytes
+ * @param size Number of bytes to read from offset 0
+ * @param len Where to store the number of bytes read (less than size if the file is shorter)
+ * @return 0 on success, URING_UNAVAILABLE if io_uring cannot be used, -1 on a read error
+ */
+int uring_read(int fd, char* data, size_t size, size_t* len) {
+    *len = 0;
+    if (size == 0) {
+        return 0;
+    }
+    Ring ring;
+    if (!ring_open(&ring)) {
+        return URING_UNAVAILABLE;
+    }
+    bool fixed = ring_register(&ring, data, size);
+
+    Chunk chunks[URING_DEPTH];
+    int free_slots[URING_DEPTH];
+    int free_count = URING_DEPTH;
+    for (int i = 0; i < URING_DEPTH; i++) {
+        free_slots[i] = i;
+    }
+
+    size_t next = 0;
+    size_t end = size;
+    unsigned pending = 0;
+    int in_flight = 0;
+    int status = 0;
+    int error = 0;
+    for (;;) {
+        // Keep the queue full until the file is covered or something went wrong
+        while (status == 0 && free_count > 0 && next < end) {
+            int slot = free_slots[--free_count];
+            chunks[slot].offset = next;
+            chunks[slot].len = end - next < URING_CHUNK_SIZE ? end - next : URING_CHUNK_SIZE;
+            chunks[slot].done = 0;
+            queue_read(&ring, fd, data, chunks, slot, fixed);
+            next += chunks[slot].len;
+            pending++;
+            in_flight++;
+        }
+        if (in_flight == 0) {
+            break;
+        }
+
+        int submitted = (int)syscall(__NR_io_uring_enter, ring.fd, pending, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            bool waiting = status != 0;
+            if (status == 0) {
+                status = errno == ENOSYS || errno == EPERM ? URING_UNAVAILABLE : -1;
+                error = errno;
+            }
+            // Entries never submitted are dropped; reads the kernel holds must finish before data is freed
+            in_flight -= (int)pending;
+            pending = 0;
+            if (in_flight == 0 || waiting) {
+                break;
+            }
+            continue;
+        }
+        pending -= (unsigned)submitted;
+
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe* cqe = &ring.cqes[head & ring.cq_mask];
+            int slot = (int)cqe->user_data;
+            Chunk* chunk = &chunks[slot];
+            int res = cqe->res;
+            if (res == -EINTR || res == -EAGAIN) {
+                res = 0;
+            } else if (res < 0) {
+                if (status == 0) {
+                    // Kernels without the opcode fail the read rather than the ring setup
+                    status = res == -EINVAL || res == -EOPNOTSUPP ? URING_UNAVAILABLE : -1;
+                    error = -res;
+                }
+            } else if (res == 0) {
+                // The file ended early, so nothing past this chunk is requested any more
+                if (chunk->offset + chunk->done < end) {
+                    end = chunk->offset + chunk->done;
+                }
+            }
+            chunk->done += res > 0 ? (size_t)res : 0;
+
+            bool retry = status == 0 && chunk->done < chunk->len && chunk->offset + chunk->done < end;
+            if (retry) {
+                queue_read(&ring, fd, data, chunks, slot, fixed);
+                pending++;
+            } else {
+                free_slots[free_count++] = slot;
+                in_flight--;
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    ring_close(&ring);
+    if (status < 0) {
+        errno = error;
+        perror("Error reading file");
+        return -1;
+    }
+    if (status == URING_UNAVAILABLE) {
+        return URING_UNAVAILABLE;
+    }
+    *len = end;
+    return 0;
+}
+
+#else
+
+/**
+ * @brief Reads the start of a file into memory with io_uring
+ * @param fd File descriptor open for reading
+ * @param data Buffer of at least size bytes
+ * @param size Number of bytes to read from offset 0
+ * @param len Where to store the number of bytes read
+ * @return URING_UNAVAILABLE, since this build has no io_uring support
+ */
+int uring_read(int fd, char* data, size_t size, size_t* len) {
+    (void)fd;
+    (void)data;
+    (void)size;
+    *len = 0;
+    return URING_UNAVAILABLE;
+}
+
+#endif
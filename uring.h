@@ -0,0 +1,34 @@
+/**
+ * @file uring.h
+ * @brief Bulk file reads through io_uring, with several large reads in flight
+ */
+
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+
+/** Returned by uring_read when io_uring cannot be used and the caller should read the file itself */
+#define URING_UNAVAILABLE 1
+
+/**
+ * @brief Reads the start of a file into memory with io_uring
+ *
+ * The buffer is split into fixed-size chunks and up to a fixed number of
+ * reads are kept in flight, so a fast device sees a deep queue. The buffer
+ * is registered with the ring so the kernel maps it once rather than on
+ * every read; if registration is refused, for example by the locked-memory
+ * limit, plain reads into it are used instead. Short reads are resubmitted
+ * for the remainder. Built without HAVE_IO_URING, or on a kernel where
+ * io_uring is missing or blocked, nothing is read and URING_UNAVAILABLE is
+ * returned.
+ *
+ * @param fd File descriptor open for reading; its offset is not used or changed
+ * @param data Buffer of at least size bytes
+ * @param size Number of bytes to read from offset 0
+ * @param len Where to store the number of bytes read (less than size if the file is shorter)
+ * @return 0 on success, URING_UNAVAILABLE if io_uring cannot be used, -1 on a read error
+ */
+int uring_read(int fd, char* data, size_t size, size_t* len);
+
+#endif /* URING_H */
@@ -0,0 +1,215 @@
+/**
+ * @file window.c
+ * @brief Implementation of time-windowed metric series
+ */
+
+#include "window.h"
+#include "online.h"
+
+/**
+ * @brief Counters of the window being filled
+ */
+typedef struct {
+    int64_t start;        /**< Start of the window */
+    int64_t last;         /**< Time up to which the integrals are taken */
+    int arrivals;         /**< Processes submitted in the window */
+    int completions;      /**< Processes completed in the window */
+    int64_t queue_area;   /**< Integral of the ready-queue length over the window */
+    int max_queue;        /**< Longest ready queue seen in the window */
+    int64_t busy;         /**< Time the CPU was running a process */
+    Histogram turnaround; /**< Turnaround times of the completions */
+} Window;
+
+/**
+ * @brief Writes the CSV header of a series
+ * @param file Stream receiving the series
+ */
+void write_window_header(FILE* file) {
+    fprintf(file, "algorithm,start,end,arrivals,completions,throughput,mean_queue,max_queue,utilisation,"
+                  "p50_turnaround,p90_turnaround,p99_turnaround,max_turnaround\n");
+}
+
+/**
+ * @brief Integrates the engine's state up to a time at which it next changes
+ * @param window Window to update
+ * @param engine Engine whose state held since window->last
+ * @param time End of the interval
+ */
+static void window_integrate(Window* window, const OnlineEngine* engine, int64_t time) {
+    int64_t span = time - window->last;
+    window->queue_area += online_queue_length(engine) * span;
+    if (engine->running >= 0) {
+        window->busy += span;
+    }
+    window->last = time;
+}
+
+/**
+ * @brief Writes a finished window, folds it into the summary and starts the next
+ * @param window Window that ends now
+ * @param width Window width
+ * @param queue Ready-queue length at the start of the next window
+ * @param algorithm Algorithm key written in the first column
+ * @param file Stream receiving the series, or NULL
+ * @param summary Summary to update
+ */
+static void window_emit(Window* window, int width, int queue, const char* algorithm, FILE* file,
+                        WindowSummary* summary) {
+    double mean_queue = (double)window->queue_area / width;
+    double utilisation = (double)window->busy / width;
+    if (file) {
+        fprintf(file, "%s,%lld,%lld,%d,%d,%.6f,%.3f,%d,%.4f,%d,%d,%d,%d\n", algorithm, (long long)window->start,
+                (long long)(window->start + width), window->arrivals, window->completions,
+                (double)window->completions / width, mean_queue, window->max_queue, utilisation,
+                histogram_percentile(&window->turnaround, 50.0), histogram_percentile(&window->turnaround, 90.0),
+                histogram_percentile(&window->turnaround, 99.0), window->turnaround.max);
+    }
+
+    if (summary->windows == 0 || window->completions > summary->busiest_completions) {
+        summary->busiest_start = window->start;
+        summary->busiest_completions = window->completions;
+    }
+    if (summary->windows == 0 || mean_queue > summary->fullest_queue) {
+        summary->fullest_start = window->start;
+        summary->fullest_queue = mean_queue;
+    }
+    if (summary->windows == 0 || utilisation < summary->lowest_utilisation) {
+        summary->lowest_utilisation = utilisation;
+    }
+    summary->mean_utilisation += (double)window->busy;
+    summary->windows++;
+
+    int64_t next = window->start + width;
+    memset(window, 0, sizeof(*window));
+    window->start = next;
+    window->last = next;
+    window->max_queue = queue;
+}
+
+/**
+ * @brief Runs a schedule on the online engine and streams one row per window
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes
+ * @param options Window width and destination
+ * @param summary Where to store the summary and whole-run metrics
+ * @return 0 on success, -1 on failure
+ */
+int window_series(const SchedParams* params, const Process* processes, int n, const WindowOptions* options,
+                  WindowSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    if (n <= 0 || options->width <= 0) {
+        return -1;
+    }
+
+    OnlineEngine engine;
+    if (!online_init(&engine, params)) {
+        return -1;
+    }
+
+    // Submission order must match handles, so the processes are replayed from a sorted copy
+    Process* sorted = copy_processes((Process*)processes, n);
+    Window* window = (Window*)calloc(1, sizeof(Window));
+    if (!sorted || !window) {
+        perror("Memory allocation failed");
+        free_process_copy(sorted, n);
+        free(window);
+        online_free(&engine);
+        return -1;
+    }
+    qsort(sorted, n, sizeof(Process), compare_arrival_time);
+
+    const char* algorithm = algorithm_key(params->algorithm);
+    int width = options->width;
+    int first = sorted[0].arrival_time;
+    window->start = (first >= 0 ? first / width : (first - width + 1) / width) * (int64_t)width;
+    window->last = window->start;
+    summary->first_start = window->start;
+
+    // Arrivals at the end of a slice are submitted before it is retired, as in the batch simulators
+    int next = 0;
+    int completed = 0;
+    bool ok = true;
+    while (completed < n) {
+        int arrival = next < n ? sorted[next].arrival_time : INT32_MAX;
+        int end = engine.running >= 0 ? engine.slice_end : INT32_MAX;
+        int time = arrival < end ? arrival : end;
+        if (time == INT32_MAX) {
+            ok = false;
+            break;
+        }
+
+        if (window->start + width <= time) {
+            window_integrate(window, &engine, window->start + width);
+            window_emit(window, width, online_queue_length(&engine), algorithm, options->file, summary);
+            continue;
+        }
+
+        window_integrate(window, &engine, time);
+        online_advance(&engine, time);
+        if (arrival == time) {
+            if (online_submit(&engine, sorted[next].burst_time) != next) {
+                ok = false;
+                break;
+            }
+            window->arrivals++;
+            next++;
+        } else {
+            int handle = online_complete_due(&engine);
+            if (handle >= 0) {
+                const OnlineJob* job = &engine.jobs[handle];
+                histogram_record(&window->turnaround, job->completion_time - job->arrival_time);
+                window->completions++;
+                completed++;
+            }
+        }
+        int queue = online_queue_length(&engine);
+        if (queue > window->max_queue) {
+            window->max_queue = queue;
+        }
+    }
+
+    if (ok) {
+        // The last window is written in full so that its rates compare with the others
+        window_integrate(window, &engine, window->start + width);
+        window_emit(window, width, 0, algorithm, options->file, summary);
+        if (options->file) {
+            fflush(options->file);
+        }
+        summary->mean_utilisation /= (double)summary->windows * width;
+
+        for (int i = 0; i < n; i++) {
+            const OnlineJob* job = &engine.jobs[i];
+            sorted[i].completion_time = job->completion_time;
+            sorted[i].response_time = job->start_time - job->arrival_time;
+            sorted[i].remaining_time = 0;
+            sorted[i].started = true;
+        }
+        summary->metrics = calculate_metrics(sorted, n);
+    }
+
+    free(window);
+    free_process_copy(sorted, n);
+    online_free(&engine);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Prints the extremes of a series next to the whole-run metrics
+ * @param summary Summary filled in by window_series
+ * @param options Options passed to window_series
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_window_summary(const WindowSummary* summary, const WindowOptions* options, const char* algorithm_name) {
+    int width = options->width;
+    printf("\n%s: %lld windows of %d time units from %lld\n", algorithm_name, (long long)summary->windows, width,
+           (long long)summary->first_start);
+    printf("Busiest window: %lld-%lld, %d completions (%.4f per time unit)\n", (long long)summary->busiest_start,
+           (long long)(summary->busiest_start + width), summary->busiest_completions,
+           (double)summary->busiest_completions / width);
+    printf("Longest mean queue: %.2f in window %lld-%lld\n", summary->fullest_queue,
+           (long long)summary->fullest_start, (long long)(summary->fullest_start + width));
+    printf("CPU utilisation: %.1f%% overall, %.1f%% in the quietest window\n", 100.0 * summary->mean_utilisation,
+           100.0 * summary->lowest_utilisation);
+    print_metrics(summary->metrics, algorithm_name);
+}
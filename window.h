@@ -0,0 +1,72 @@
+/**
+ * @file window.h
+ * @brief Time-windowed metric series streamed while a schedule runs
+ */
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include "common.h"
+#include "sched.h"
+
+/**
+ * @struct WindowOptions
+ * @brief Window width and destination of the series
+ */
+typedef struct {
+    int width;  /**< Length of each window in time units */
+    FILE* file; /**< Stream receiving one CSV row per window, or NULL to keep only the summary */
+} WindowOptions;
+
+/**
+ * @struct WindowSummary
+ * @brief Outcome of a windowed run
+ */
+typedef struct {
+    int64_t windows;           /**< Windows in the series */
+    int64_t first_start;       /**< Start of the first window */
+    int64_t busiest_start;     /**< Start of the window with the most completions */
+    int busiest_completions;   /**< Completions in that window */
+    int64_t fullest_start;     /**< Start of the window with the longest mean queue */
+    double fullest_queue;      /**< Mean queue length in that window */
+    double lowest_utilisation; /**< Lowest CPU utilisation over the windows */
+    double mean_utilisation;   /**< CPU utilisation over the whole series */
+    Metrics metrics;           /**< Metrics of the whole run */
+} WindowSummary;
+
+/**
+ * @brief Writes the CSV header of a series
+ * @param file Stream receiving the series
+ */
+void write_window_header(FILE* file);
+
+/**
+ * @brief Runs a schedule on the online engine and streams one row per window
+ *
+ * Windows are [k * width, (k + 1) * width) in simulated time, from the
+ * window holding the first arrival to the one holding the last completion,
+ * empty ones included. Each row gives the window's arrivals, completions,
+ * throughput, time-averaged and peak ready-queue length, CPU utilisation,
+ * and the turnaround percentiles of the processes that completed in it.
+ * A row is written as soon as the clock passes the end of its window, and
+ * only the current window is held in memory.
+ *
+ * @param params Algorithm and parameters; FCFS, SJF, SRTF and RR are supported
+ * @param processes Array of processes (not modified)
+ * @param n Number of processes
+ * @param options Window width and destination
+ * @param summary Where to store the summary and whole-run metrics
+ * @return 0 on success, -1 on failure
+ */
+int window_series(const SchedParams* params, const Process* processes, int n, const WindowOptions* options,
+                  WindowSummary* summary);
+
+/**
+ * @brief Prints the extremes of a series next to the whole-run metrics
+ * @param summary Summary filled in by window_series
+ * @param options Options passed to window_series
+ * @param algorithm_name Name of the scheduling algorithm
+ */
+void print_window_summary(const WindowSummary* summary, const WindowOptions* options, const char* algorithm_name);
+
+#endif /* WINDOW_H */
@@ -0,0 +1,354 @@
+/**
+ * @file workload.c
+ * @brief Implementation of the binary workload format
+ */
+
+#include "workload.h"
+
+#include <sys/stat.h>
+
+/** Number of records encoded or decoded per buffered read or write */
+#define WORKLOAD_BATCH 4096
+
+/** Bytes of a string section read before its buffer first grows */
+#define SECTION_PIECE ((size_t)1 << 20)
+
+/**
+ * @brief Checks whether a buffer starts with the workload magic
+ * @param data Start of the buffer
+ * @param len Length of the buffer in bytes
+ * @return true if the buffer holds a binary workload
+ */
+bool workload_is_binary(const char* data, size_t len) {
+    return len >= WORKLOAD_MAGIC_SIZE && memcmp(data, WORKLOAD_MAGIC, WORKLOAD_MAGIC_SIZE) == 0;
+}
+
+/**
+ * @brief Returns the size of a string section
+ * @param table Table whose first count strings form the section
+ * @param count Number of strings
+ * @return Total length of the strings including their terminators
+ */
+static uint64_t section_size(const IdTable* table, uint32_t count) {
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        size += strlen(id_table_name(table, i)) + 1;
+    }
+    return size;
+}
+
+/**
+ * @brief Writes processes as a binary workload
+ * @param file Stream to write to
+ * @param workload Processes with their partitions and I/O; records are 16 bytes if io is NULL
+ * @param ids Table naming Process.id, or NULL to omit the name section
+ * @param partitions Table naming workload->partitions, or NULL to omit the partition section
+ * @return 0 on success, -1 on a write error
+ */
+int workload_write(FILE* file, const ProcessArray* workload, const IdTable* ids, const IdTable* partitions) {
+    const Process* processes = workload->processes;
+    int n = workload->count;
+    uint32_t record_size = workload->io ? WORKLOAD_RECORD_SIZE : WORKLOAD_RECORD_SIZE_NO_IO;
+    uint64_t names_size = 0;
+    if (ids) {
+        for (int i = 0; i < n; i++) {
+            names_size += strlen(id_table_name(ids, processes[i].id)) + 1;
+        }
+    }
+    uint32_t partition_keys = partitions && workload->partitions ? partitions->count : 0;
+    uint64_t partitions_size = section_size(partitions, partition_keys);
+
+    unsigned char header[WORKLOAD_HEADER_SIZE];
+    memcpy(header, WORKLOAD_MAGIC, WORKLOAD_MAGIC_SIZE);
+    put_le32(header + 8, record_size);
+    put_le32(header + 12, 0);
+    put_le64(header + 16, (uint64_t)(n > 0 ? n : 0));
+    put_le64(header + 24, names_size);
+    put_le64(header + 32, partitions_size);
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+        return -1;
+    }
+
+    unsigned char batch[WORKLOAD_BATCH * WORKLOAD_RECORD_SIZE];
+    for (int start = 0; start < n; start += WORKLOAD_BATCH) {
+        int count = n - start < WORKLOAD_BATCH ? n - start : WORKLOAD_BATCH;
+        for (int j = 0; j < count; j++) {
+            const Process* p = &processes[start + j];
+            unsigned char* r = batch + (size_t)j * record_size;
+            put_le32(r, (uint32_t)p->arrival_time);
+            put_le32(r + 4, (uint32_t)p->burst_time);
+            put_le32(r + 8, (uint32_t)p->priority);
+            put_le32(r + 12, partition_keys > 0 ? workload->partitions[start + j] : 0);
+            if (workload->io) {
+                put_le32(r + 16, (uint32_t)workload->io[start + j].interval);
+                put_le32(r + 20, (uint32_t)workload->io[start + j].time);
+            }
+        }
+        size_t bytes = (size_t)count * record_size;
+        if (fwrite(batch, 1, bytes, file) != bytes) {
+            return -1;
+        }
+    }
+
+    if (ids) {
+        for (int i = 0; i < n; i++) {
+            const char* name = id_table_name(ids, processes[i].id);
+            if (fwrite(name, 1, strlen(name) + 1, file) != strlen(name) + 1) {
+                return -1;
+            }
+        }
+    }
+    for (uint32_t k = 0; k < partition_keys; k++) {
+        const char* key = id_table_name(partitions, k);
+        if (fwrite(key, 1, strlen(key) + 1, file) != strlen(key) + 1) {
+            return -1;
+        }
+    }
+
+    return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Reads a string section and interns every string in it
+ * @param name Input name used in messages
+ * @param file Stream to read from
+ * @param size Size of the section in bytes
+ * @param table Table that receives the strings, or NULL to check the section without keeping them
+ * @param map Where to store the index of each string, or NULL
+ * @param expected Number of strings the section must contain, or UINT32_MAX for any number
+ * @return true if successful, false on a malformed section or allocation failure
+ */
+static bool read_section(const char* name, FILE* file, uint64_t size, IdTable* table, uint32_t* map,
+                         uint32_t expected) {
+    if (size > SIZE_MAX - 1) {
+        fprintf(stderr, "%s: workload string section is too large\n", name);
+        return false;
+    }
+
+    // The buffer grows as bytes arrive, so a forged size costs no more than the input delivers
+    size_t filled = 0;
+    size_t capacity = (size < SECTION_PIECE ? (size_t)size : SECTION_PIECE) + 1;
+    char* data = (char*)malloc(capacity);
+    while (data && filled < size) {
+        if (filled == capacity - 1) {
+            size_t grown = capacity - 1 < size / 2 ? 2 * (capacity - 1) : (size_t)size;
+            char* larger = (char*)realloc(data, grown + 1);
+            if (!larger) {
+                free(data);
+                data = NULL;
+                break;
+            }
+            data = larger;
+            capacity = grown + 1;
+        }
+        size_t piece = capacity - 1 - filled;
+        if (fread(data + filled, 1, piece, file) != piece) {
+            fprintf(stderr, "%s: truncated workload\n", name);
+            free(data);
+            return false;
+        }
+        filled += piece;
+    }
+    if (!data) {
+        perror("Memory allocation failed");
+        return false;
+    }
+    data[size] = '\0';
+
+    uint32_t count = 0;
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        size_t len = strlen(p);
+        if (p + len == end || count == expected) {
+            break;
+        }
+        uint32_t index = table ? id_table_intern(table, p, len) : 0;
+        if (index == ID_INVALID) {
+            free(data);
+            return false;
+        }
+        if (map) {
+            map[count] = index;
+        }
+        count++;
+        p += len + 1;
+    }
+    free(data);
+
+    if ((expected != UINT32_MAX && count != expected) || p != end) {
+        fprintf(stderr, "%s: workload string section does not match its records\n", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a binary workload
+ * @param name Input name used in messages
+ * @param file Stream to read from
+ * @param consumed Bytes of the magic already read from file (0 or WORKLOAD_MAGIC_SIZE)
+ * @param ids Table that receives the process names, or NULL to read them without keeping them
+ * @param partitions Table that receives the partition keys
+ * @param profile Profile that receives every process as it is decoded, or NULL
+ * @param out Empty array that receives the processes
+ * @return Number of processes read, or -1 on a malformed or truncated workload
+ */
+int workload_read(const char* name, FILE* file, size_t consumed, IdTable* ids, IdTable* partitions,
+                  WorkloadProfile* profile, ProcessArray* out) {
+    unsigned char header[WORKLOAD_HEADER_SIZE];
+    memcpy(header, WORKLOAD_MAGIC, consumed);
+    size_t wanted = sizeof(header) - consumed;
+    if (fread(header + consumed, 1, wanted, file) != wanted) {
+        fprintf(stderr, "%s: truncated workload header\n", name);
+        return -1;
+    }
+    uint32_t record_size = get_le32(header + 8);
+    if (!workload_is_binary((const char*)header, sizeof(header)) ||
+        (record_size != WORKLOAD_RECORD_SIZE && record_size != WORKLOAD_RECORD_SIZE_NO_IO)) {
+        fprintf(stderr, "%s: not a version 1 binary workload\n", name);
+        return -1;
+    }
+
+    uint64_t count = get_le64(header + 16);
+    uint64_t names_size = get_le64(header + 24);
+    uint64_t partitions_size = get_le64(header + 32);
+    if (count > INT32_MAX) {
+        fprintf(stderr, "Error: Too many processes\n");
+        return -1;
+    }
+
+    // A regular file must hold what the header claims; streams such as a --serve socket are
+    // only trusted as far as they deliver, since the array below grows with the records read
+    struct stat st;
+    off_t offset = ftello(file);
+    if (offset >= 0 && fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode)) {
+        uint64_t remaining = st.st_size > offset ? (uint64_t)(st.st_size - offset) : 0;
+        uint64_t records = count * record_size;
+        if (records > remaining || names_size > remaining - records ||
+            partitions_size > remaining - records - names_size) {
+            fprintf(stderr, "%s: truncated workload\n", name);
+            return -1;
+        }
+    }
+
+    int n = (int)count;
+    bool partitioned = partitions_size > 0;
+    bool has_io = record_size == WORKLOAD_RECORD_SIZE;
+    unsigned char batch[WORKLOAD_BATCH * WORKLOAD_RECORD_SIZE];
+    uint32_t max_partition = 0;
+    for (int start = 0; start < n; start += WORKLOAD_BATCH) {
+        int batch_count = n - start < WORKLOAD_BATCH ? n - start : WORKLOAD_BATCH;
+        size_t bytes = (size_t)batch_count * record_size;
+        if (fread(batch, 1, bytes, file) != bytes) {
+            fprintf(stderr, "%s: truncated workload\n", name);
+            process_array_free(out);
+            return -1;
+        }
+        if (start + batch_count > out->capacity) {
+            int grown = out->capacity < n / 2 ? 2 * out->capacity : n;
+            if (grown < start + batch_count) {
+                grown = start + batch_count;
+            }
+            if (!process_array_resize(out, grown, partitioned, has_io)) {
+                process_array_free(out);
+                return -1;
+            }
+        }
+
+        for (int j = 0; j < batch_count; j++) {
+            const unsigned char* r = batch + (size_t)j * record_size;
+            Process* p = &out->processes[start + j];
+            p->id = ID_INVALID;
+            p->arrival_time = (int32_t)get_le32(r);
+            p->burst_time = (int32_t)get_le32(r + 4);
+            p->priority = (int32_t)get_le32(r + 8);
+            uint32_t partition = get_le32(r + 12);
+            int io_interval = has_io ? (int32_t)get_le32(r + 16) : 0;
+            int io_time = has_io ? (int32_t)get_le32(r + 20) : 0;
+            if (p->arrival_time < 0 || p->burst_time <= 0) {
+                fprintf(stderr, "%s: record %d has a negative arrival_time or non-positive burst_time\n",
+                        name, start + j + 1);
+                process_array_free(out);
+                return -1;
+            }
+            if (io_interval < 0 || io_time < 0) {
+                fprintf(stderr, "%s: record %d has a negative io_interval or io_time\n", name, start + j + 1);
+                process_array_free(out);
+                return -1;
+            }
+            if (partitioned) {
+                out->partitions[start + j] = partition;
+                if (partition > max_partition) {
+                    max_partition = partition;
+                }
+            }
+            if (has_io) {
+                out->io[start + j].interval = io_interval;
+                out->io[start + j].time = io_time;
+            }
+
+            // Initialize other fields
+            p->remaining_time = p->burst_time;
+            p->completion_time = 0;
+            p->turnaround_time = 0;
+            p->waiting_time = 0;
+            p->response_time = -1;  // -1 indicates not started yet
+            p->started = false;
+            if (profile) {
+                profile_add(profile, p, io_interval);
+            }
+        }
+        out->count = start + batch_count;
+    }
+
+    if (out->capacity == 0 && !process_array_resize(out, 1, partitioned, has_io)) {
+        return -1;
+    }
+
+    // Names are stored in record order, so interning them in order yields each Process.id
+    if (names_size > 0) {
+        uint32_t* map = (uint32_t*)malloc((n > 0 ? (size_t)n : 1) * sizeof(uint32_t));
+        if (!map || !read_section(name, file, names_size, ids, map, (uint32_t)n)) {
+            if (!map) perror("Memory allocation failed");
+            free(map);
+            process_array_free(out);
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            out->processes[i].id = map[i];
+        }
+        free(map);
+    }
+
+    if (partitioned) {
+        // The section may name partitions no record uses; only the used prefix is mapped
+        IdTable local;
+        id_table_init(&local);
+        bool ok = read_section(name, file, partitions_size, &local, NULL, UINT32_MAX) &&
+                  (n == 0 || max_partition < local.count);
+        uint32_t keys = ok && n > 0 ? max_partition + 1 : 0;
+        uint32_t* map = (uint32_t*)malloc((keys > 0 ? (size_t)keys : 1) * sizeof(uint32_t));
+        if (!map) {
+            perror("Memory allocation failed");
+            ok = false;
+        }
+        for (uint32_t k = 0; ok && k < keys; k++) {
+            const char* key = id_table_name(&local, k);
+            map[k] = id_table_intern(partitions, key, strlen(key));
+            ok = map[k] != ID_INVALID;
+        }
+        for (int i = 0; ok && i < n; i++) {
+            out->partitions[i] = map[out->partitions[i]];
+        }
+        id_table_free(&local);
+        free(map);
+        if (!ok) {
+            fprintf(stderr, "%s: workload partition section does not match its records\n", name);
+            process_array_free(out);
+            return -1;
+        }
+    }
+
+    return n;
+}
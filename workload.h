@@ -0,0 +1,128 @@
+/**
+ * @file workload.h
+ * @brief Binary workload format shared by files and the network protocol
+ *
+ * A workload is a fixed header, followed by one fixed-size record per
+ * process and two optional string sections. All integers are
+ * little-endian.
+ *
+ *   offset  size  field
+ *   0       8     magic "CPUWKLD1"
+ *   8       4     record_size (24, or 16 in files without I/O fields)
+ *   12      4     reserved (0)
+ *   16      8     count: number of records
+ *   24      8     names_size: bytes of the process name section
+ *   32      8     partitions_size: bytes of the partition key section
+ *   40      record_size*count records {arrival_time, burst_time, priority,
+ *                 partition, io_interval, io_time}
+ *   ...     names_size: one NUL-terminated name per record, or empty
+ *   ...     partitions_size: NUL-terminated keys indexed by partition, or empty
+ *
+ * Without a name section every process is named "?"; without a partition
+ * section every process is in partition 0. Records of 16 bytes stop after
+ * partition and describe processes that never block for I/O; they are
+ * written for workloads read without I/O columns.
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "common.h"
+#include "csv.h"
+#include "intern.h"
+#include "profile.h"
+
+/** First bytes of every binary workload */
+#define WORKLOAD_MAGIC "CPUWKLD1"
+
+/** Length of WORKLOAD_MAGIC in bytes */
+#define WORKLOAD_MAGIC_SIZE 8
+
+/** Size of the workload header in bytes */
+#define WORKLOAD_HEADER_SIZE 40
+
+/** Size of one process record in bytes */
+#define WORKLOAD_RECORD_SIZE 24
+
+/** Size of a record without the I/O fields */
+#define WORKLOAD_RECORD_SIZE_NO_IO 16
+
+/**
+ * @brief Checks whether a buffer starts with the workload magic
+ * @param data Start of the buffer
+ * @param len Length of the buffer in bytes
+ * @return true if the buffer holds a binary workload
+ */
+bool workload_is_binary(const char* data, size_t len);
+
+/**
+ * @brief Writes processes as a binary workload
+ * @param file Stream to write to
+ * @param workload Processes with their partitions and I/O; records are 16 bytes if io is NULL
+ * @param ids Table naming Process.id, or NULL to omit the name section
+ * @param partitions Table naming workload->partitions, or NULL to omit the partition section
+ * @return 0 on success, -1 on a write error
+ */
+int workload_write(FILE* file, const ProcessArray* workload, const IdTable* ids, const IdTable* partitions);
+
+/**
+ * @brief Reads a binary workload
+ *
+ * Names and partition keys are interned into the given tables, so the
+ * indices stored in the processes and out->partitions refer to those
+ * tables. Partitions are kept only if the workload has a partition
+ * section, and I/O only if its records carry the I/O fields.
+ *
+ * @param name Input name used in messages
+ * @param file Stream to read from
+ * @param consumed Bytes of the magic already read from file (0 or WORKLOAD_MAGIC_SIZE)
+ * @param ids Table that receives the process names, or NULL to read them without keeping them
+ * @param partitions Table that receives the partition keys
+ * @param profile Profile that receives every process as it is decoded, or NULL
+ * @param out Empty array that receives the processes; release it with process_array_free
+ * @return Number of processes read, or -1 on a malformed or truncated workload
+ */
+int workload_read(const char* name, FILE* file, size_t consumed, IdTable* ids, IdTable* partitions,
+                  WorkloadProfile* profile, ProcessArray* out);
+
+/**
+ * @brief Stores a 32-bit value in little-endian byte order
+ * @param p Destination (4 bytes)
+ * @param value Value to store
+ */
+static inline void put_le32(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+/**
+ * @brief Stores a 64-bit value in little-endian byte order
+ * @param p Destination (8 bytes)
+ * @param value Value to store
+ */
+static inline void put_le64(unsigned char* p, uint64_t value) {
+    put_le32(p, (uint32_t)value);
+    put_le32(p + 4, (uint32_t)(value >> 32));
+}
+
+/**
+ * @brief Loads a little-endian 32-bit value
+ * @param p Source (4 bytes)
+ * @return Loaded value
+ */
+static inline uint32_t get_le32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Loads a little-endian 64-bit value
+ * @param p Source (8 bytes)
+ * @return Loaded value
+ */
+static inline uint64_t get_le64(const unsigned char* p) {
+    return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+#endif /* WORKLOAD_H */